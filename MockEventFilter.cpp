@@ -0,0 +1,150 @@
+#include <array>
+#include <atomic>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+#include "bayeux/dpp/base_module.h"
+#include "bayeux/mctools/simulated_data.h"
+#include "falaise/property_reader.h"
+#include "falaise/snemo/datamodels/data_model.h"
+
+#include "step_hit_view.h"
+
+namespace {
+  using namespace falaise::properties;
+  struct FilterConfig {
+    FilterConfig() = default;
+    explicit FilterConfig(const datatools::properties& p)
+      : SD_label(getValueOrDefault(
+          p,
+          "SD_label",
+          snemo::datamodel::data_info::default_simulated_data_label()))
+      , hit_category(getValueOrDefault(p, "hit_category", std::string("gg")))
+      , reject_no_tracker_hits(
+          getValueOrDefault(p, "reject.no_tracker_hits", true))
+      , min_tracker_hits(getValueOrDefault(p, "min_tracker_hits", 0))
+    {}
+
+    std::string SD_label;        // inbox
+    std::string hit_category;    // tracker step hits
+    bool reject_no_tracker_hits; // reject events with no tracker hits
+    int min_tracker_hits;        // ... or fewer than this, if set
+  };
+
+  //! Predicates an event can fail, in order of evaluation
+  enum Predicate : std::size_t {
+    noTrackerHits,  // no simulated data, or no step hits of hit_category
+    fewTrackerHits, // fewer step hits than min_tracker_hits
+    predicateCount
+  };
+
+  const char*
+  predicateName(Predicate p)
+  {
+    static const char* const names[] = {"no_tracker_hits",
+                                        "few_tracker_hits"};
+    return names[p];
+  }
+} // namespace
+
+//! Early rejection of events failing cheap predicates
+/*
+ * Placed at the head of a dpp::chain_module, rejects events for which
+ * processing by the rest of the chain would be wasted, by returning
+ * PROCESS_STOP so that the chain stops there (and a
+ * falaise::parallel_pipeline drops them). Predicates look only at the
+ * sizes of banks, so cost a few lookups per event.
+ *
+ * Events are rejected, if "reject.no_tracker_hits" is true, when they have
+ * no "SD_label" bank or no step hits of "hit_category" in it, and, if
+ * "min_tracker_hits" is set, when they have fewer step hits than that.
+ * Each rejected event is counted against the first predicate it fails, and
+ * the counts are written to std::clog at reset().
+ *
+ * Counts are those of this instance only. falaise::parallel_pipeline (so
+ * flparallel) and flshard give each worker its own instance of every
+ * module, so each worker's filter reports the events it processed, and the
+ * counts of a run are the sums of all workers' reports. The counts are
+ * atomic only so that a single instance may also be called from several
+ * threads at once.
+ */
+class MockEventFilter : public dpp::base_module {
+public:
+  MockEventFilter() = default;
+  ~MockEventFilter() { this->reset(); }
+
+  void
+  initialize(const datatools::properties& config,
+             datatools::service_manager&,
+             dpp::module_handle_dict_type&) override
+  {
+    config_ = FilterConfig(config);
+    if (config_.min_tracker_hits < 0) {
+      throw std::logic_error("min_tracker_hits cannot be negative");
+    }
+    seen_ = 0;
+    for (auto& r : rejected_) {
+      r = 0;
+    }
+    this->_set_initialized(true);
+  }
+
+  dpp::base_module::process_status
+  process(datatools::things& event) override
+  {
+    seen_.fetch_add(1, std::memory_order_relaxed);
+    std::size_t nHits{0};
+    if (event.has(config_.SD_label) &&
+        event.is_a<mctools::simulated_data>(config_.SD_label)) {
+      nHits = falaise::view_step_hits(
+                event.get<mctools::simulated_data>(config_.SD_label),
+                config_.hit_category)
+                .size();
+    }
+
+    if (config_.reject_no_tracker_hits && nHits == 0) {
+      return this->reject(noTrackerHits);
+    }
+    if (nHits < static_cast<std::size_t>(config_.min_tracker_hits)) {
+      return this->reject(fewTrackerHits);
+    }
+    return PROCESS_OK;
+  }
+
+  void
+  reset() override
+  {
+    if (this->is_initialized()) {
+      std::uint64_t total{0};
+      for (const auto& r : rejected_) {
+        total += r;
+      }
+      std::clog << "MockEventFilter '" << this->get_name() << "' rejected "
+                << total << " of " << seen_ << " events:\n";
+      for (std::size_t p = 0; p < predicateCount; ++p) {
+        std::clog << "  " << predicateName(Predicate(p)) << ": "
+                  << rejected_[p] << '\n';
+      }
+    }
+    this->_set_initialized(false);
+  }
+
+private:
+  //! Count a rejection by predicate p, and return the status to reject
+  dpp::base_module::process_status
+  reject(Predicate p)
+  {
+    rejected_[p].fetch_add(1, std::memory_order_relaxed);
+    return PROCESS_STOP;
+  }
+
+  FilterConfig config_;
+  std::atomic<std::uint64_t> seen_{0}; //< events processed
+  //! Events rejected, by the first predicate they failed
+  std::array<std::atomic<std::uint64_t>, predicateCount> rejected_{};
+
+  DPP_MODULE_REGISTRATION_INTERFACE(MockEventFilter);
+};
+
+DPP_MODULE_REGISTRATION_IMPLEMENT(MockEventFilter, "MockEventFilter");
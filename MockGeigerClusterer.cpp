@@ -0,0 +1,140 @@
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "bayeux/datatools/service_manager.h"
+#include "bayeux/dpp/base_module.h"
+#include "bayeux/geomtools/geometry_service.h"
+#include "bayeux/geomtools/manager.h"
+#include "falaise/property_reader.h"
+#include "falaise/snemo/datamodels/calibrated_data.h"
+#include "falaise/snemo/datamodels/calibrated_tracker_hit.h"
+#include "falaise/snemo/datamodels/data_model.h"
+#include "falaise/snemo/processing/services.h"
+
+#include "cell_adjacency.h"
+#include "cell_clusterer.h"
+#include "object_pool.h"
+#include "packed_geom_id.h"
+#include "tracker_cell_table.h"
+
+namespace {
+  using namespace falaise::properties;
+  struct ClustererConfig {
+    ClustererConfig() = default;
+    explicit ClustererConfig(const datatools::properties& p)
+      : CD_label(getValueOrDefault(
+          p,
+          "CD_label",
+          snemo::datamodel::data_info::default_calibrated_data_label()))
+      , Geo_label(getValueOrDefault(
+          p,
+          "Geo_label",
+          snemo::processing::service_info::default_geometry_service_label()))
+      , cell_category(
+          getValueOrDefault(p, "cell_category", std::string("drift_cell_core")))
+      , cluster_key(
+          getValueOrDefault(p, "cluster_key", std::string("cluster_id")))
+    {}
+
+    std::string CD_label;      // calibrated hits, clustered in place
+    std::string Geo_label;     // name of geo service
+    std::string cell_category; // geometry category of Geiger cells
+    std::string cluster_key;   // hit auxiliary property holding its cluster
+  };
+
+  //! Working state of the clusterer for one event
+  struct ClustererScratch {
+    falaise::cell_clusterer clusterer;
+    std::vector<std::uint64_t> gids;     // packed GID of each hit
+    std::vector<std::uint32_t> clusters; // ... and its cluster
+  };
+} // namespace
+
+//! Clustering of calibrated Geiger hits in adjacent cells
+/*
+ * Hits in cells adjacent by layer and row, diagonally included, are
+ * grouped into clusters by a falaise::cell_clusterer, sized at initialize()
+ * from the cells of "cell_category" in the geometry, which are shared with
+ * other modules by falaise::shared_tracker_cells.
+ *
+ * Each calibrated tracker hit of the "CD_label" bank gets its cluster
+ * number as the integer auxiliary property "cluster_key". Clusters are
+ * numbered from 0 in order of their first cell by (side, layer, row), and
+ * their number is stored in the calibrated data's properties as
+ * "<cluster_key>.count".
+ *
+ * Like MockTrackerCalibrator, the module is reentrant, each call to
+ * process() working on its own scratch storage taken from a pool.
+ */
+class MockGeigerClusterer : public dpp::base_module {
+public:
+  using CalibratedData = snemo::datamodel::calibrated_data;
+
+public:
+  MockGeigerClusterer() = default;
+  ~MockGeigerClusterer() { this->reset(); }
+
+  void
+  initialize(const datatools::properties& config,
+             datatools::service_manager& services,
+             dpp::module_handle_dict_type&) override
+  {
+    config_ = ClustererConfig(config);
+    const auto& geoManager =
+      services.get<geomtools::geometry_service>(config_.Geo_label)
+        .get_geom_manager();
+    cells_ = falaise::shared_tracker_cells(geoManager, config_.cell_category);
+    const std::uint32_t sides = cells_->table.address_end(1);
+    const std::uint32_t layers = cells_->table.address_end(2);
+    const std::uint32_t rows = cells_->table.address_end(3);
+
+    scratch_.reset(new falaise::object_pool<ClustererScratch>([=] {
+      std::unique_ptr<ClustererScratch> s{new ClustererScratch};
+      s->clusterer = falaise::cell_clusterer{sides, layers, rows};
+      return s;
+    }));
+    this->_set_initialized(true);
+  }
+
+  dpp::base_module::process_status
+  process(datatools::things& event) override
+  {
+    auto scratch = scratch_->acquire();
+    auto& calibrated = event.grab<CalibratedData>(config_.CD_label);
+    auto& hits = calibrated.calibrated_tracker_hits();
+
+    scratch->gids.resize(hits.size());
+    scratch->clusters.resize(hits.size());
+    for (std::size_t i = 0; i < hits.size(); ++i) {
+      scratch->gids[i] = falaise::pack_geom_id(hits[i].get().get_geom_id());
+    }
+    const std::size_t nClusters = scratch->clusterer.cluster(
+      scratch->gids.data(), hits.size(), scratch->clusters.data());
+
+    for (std::size_t i = 0; i < hits.size(); ++i) {
+      hits[i].grab().grab_auxiliaries().update(
+        config_.cluster_key, static_cast<int>(scratch->clusters[i]));
+    }
+    calibrated.grab_properties().update(config_.cluster_key + ".count",
+                                        static_cast<int>(nClusters));
+    return PROCESS_OK;
+  }
+
+  void
+  reset() override
+  {
+    scratch_.reset();
+    cells_.reset();
+    this->_set_initialized(false);
+  }
+
+private:
+  ClustererConfig config_;
+  std::shared_ptr<const falaise::tracker_cells> cells_; //< with other modules
+  std::unique_ptr<falaise::object_pool<ClustererScratch>> scratch_;
+
+  DPP_MODULE_REGISTRATION_INTERFACE(MockGeigerClusterer);
+};
+
+DPP_MODULE_REGISTRATION_IMPLEMENT(MockGeigerClusterer, "MockGeigerClusterer");
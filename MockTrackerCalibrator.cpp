@@ -1,22 +1,55 @@
+#include <sys/stat.h>
+
+#include <algorithm>
+#include <fstream>
 #include <iostream>
+#include <memory>
+#include <mutex>
+#include <numeric>
+#include <stdexcept>
+#include <vector>
 
+#include "bayeux/datatools/clhep_units.h"
 #include "bayeux/datatools/service_manager.h"
+#include "bayeux/datatools/utils.h"
 #include "bayeux/dpp/base_module.h"
 #include "bayeux/geomtools/geometry_service.h"
 #include "bayeux/geomtools/manager.h"
 #include "bayeux/mctools/simulated_data.h"
 #include "falaise/property_reader.h"
 #include "falaise/snemo/datamodels/calibrated_data.h"
+#include "falaise/snemo/datamodels/calibrated_tracker_hit.h"
 #include "falaise/snemo/datamodels/data_model.h"
-#include "falaise/snemo/datamodels/mock_raw_tracker_hit.h"
+#include "falaise/snemo/datamodels/event_header.h"
 #include "falaise/snemo/processing/services.h"
 
+#include "batch_module.h"
+#include "cell_adjacency.h"
+#include "cell_constants.h"
+#include "cell_constants_cache.h"
+#include "cell_mask.h"
+#include "drift_model.h"
+#include "event_bank.h"
+#include "geiger_digitizer.h"
+#include "noise_model.h"
+#include "object_pool.h"
+#include "packed_geom_id.h"
+#include "raw_tracker_hit_buffer.h"
+#include "stage_timer.h"
+#include "step_hit_view.h"
+#include "tracker_cell_table.h"
+#include "tracker_layer_index.h"
+
 namespace {
   using namespace falaise::properties;
   struct CalibratorConfig {
     CalibratorConfig() = default;
     explicit CalibratorConfig(const datatools::properties& p)
-      : SD_label(getValueOrDefault(
+      : EH_label(getValueOrDefault(
+          p,
+          "EH_label",
+          snemo::datamodel::data_info::default_event_header_label()))
+      , SD_label(getValueOrDefault(
           p,
           "SD_label",
           snemo::datamodel::data_info::default_simulated_data_label()))
@@ -29,25 +62,194 @@ namespace {
           "Geo_label",
           snemo::processing::service_info::default_geometry_service_label()))
       , hit_category(getValueOrDefault(p, "hit_category", std::string("gg")))
-      , random_id(getValueOrDefault(p, "random.id", std::string("mt19937")))
+      , cell_category(
+          getValueOrDefault(p, "cell_category", std::string("drift_cell_core")))
+      , random_id(
+          getValueOrDefault(p, "random.id", std::string("philox4x32")))
       , random_seed(getValueOrDefault(p, "random.seed", 12345))
+      , anode_efficiency(getValueOrDefault(p, "anode_efficiency", 0.98))
+      , cathode_efficiency(getValueOrDefault(p, "cathode_efficiency", 0.95))
+      , drift_velocity(getValueOrDefault(
+          p, "drift_velocity", 1.0 * CLHEP::cm / CLHEP::microsecond))
+      , drift_radius_scale(
+          getValueOrDefault(p, "drift.radius_scale", 1.0 * CLHEP::cm))
+      , drift_max_radius(
+          getValueOrDefault(p, "drift.max_radius", 3.5 * CLHEP::cm))
+      , drift_table_size(getValueOrDefault(p, "drift.table_size", 512))
+      , constants_file(
+          getValueOrDefault(p, "calibration.constants_file", std::string{}))
+      , constants_dir(
+          getValueOrDefault(p, "calibration.constants_dir", std::string{}))
+      , constants_cache_size(
+          getValueOrDefault(p, "calibration.cache_size", 4))
+      , constants_prefetch(
+          getValueOrDefault(p, "calibration.prefetch", true))
+      , mask_file(getValueOrDefault(p, "mask.file", std::string{}))
+      , noise_rate(getValueOrDefault(p, "noise.rate", 0.0 * CLHEP::hertz))
+      , noise_file(getValueOrDefault(p, "noise.rates_file", std::string{}))
+      , noise_window(
+          getValueOrDefault(p, "noise.window", 5.0 * CLHEP::microsecond))
+      , timing(getValueOrDefault(p, "timing", false))
+      , timing_stride(getValueOrDefault(p, "timing.stride", 16))
+      , plasma_speed(getValueOrDefault(
+          p, "plasma_speed", 5.0 * CLHEP::cm / CLHEP::microsecond))
     {}
 
-    std::string SD_label;     // inbox
-    std::string CD_label;     // outbox
-    std::string Geo_label;    // name of geo service
-    std::string hit_category; // ;
-    std::string random_id;
-    int random_seed;
+    std::string EH_label;       // event header, for run/event numbers
+    std::string SD_label;       // inbox
+    std::string CD_label;       // outbox
+    std::string Geo_label;      // name of geo service
+    std::string hit_category;   // ;
+    std::string cell_category;  // geometry category of Geiger cells
+    std::string random_id;      // engine in falaise::random_stream_registry
+    int random_seed;            // with run/event numbers, seeds each event
+    double anode_efficiency;    // probability a step hit fires the anode
+    double cathode_efficiency;  // probability each cathode signal is seen
+    double drift_velocity;      // drift velocity of ionization at anode
+    double drift_radius_scale;  // radius at which drift velocity halves
+    double drift_max_radius;    // largest radius in drift tables
+    int drift_table_size;       // points in drift tables
+    std::string constants_file; // binary per-cell constants, or uniform
+    std::string constants_dir;  // ... or per-run constants files, see below
+    int constants_cache_size;   // constants sets kept in memory
+    bool constants_prefetch;    // load the next run's constants in advance
+    std::string mask_file;      // list of dead/noisy cells, or none
+    double noise_rate;          // noise hit rate of each cell...
+    std::string noise_file;     // ... unless listed here, in Hz
+    double noise_window;        // readout window for noise hits
+    bool timing;                // time stages, reporting at reset
+    int timing_stride;          // ... of one batch in this many
+    double plasma_speed;        // longitudinal plasma propagation speed
+  };
+
+  //! Modification time and size of a file, to tell when it changes
+  struct FileStamp {
+    std::int64_t mtime; // in ns
+    std::int64_t size;
+
+    bool
+    operator==(const FileStamp& other) const
+    {
+      return mtime == other.mtime && size == other.size;
+    }
+  };
+
+  //! Return the stamp of file at path, all -1 if it cannot be read
+  FileStamp
+  fileStamp(const std::string& path)
+  {
+    struct stat info;
+    if (::stat(path.c_str(), &info) != 0) {
+      return {-1, -1};
+    }
+    return {std::int64_t(info.st_mtim.tv_sec) * 1000000000 +
+              info.st_mtim.tv_nsec,
+            std::int64_t(info.st_size)};
+  }
+
+  //! Cell mask, the run it was last checked for, and its file's stamp
+  struct RunMask {
+    std::int32_t run;
+    FileStamp stamp;
+    std::shared_ptr<const falaise::cell_mask> mask;
+  };
+
+  //! Timed stages of processing
+  enum Stage : std::size_t {
+    fetchStage,     // get step hits of a batch from the events
+    digitizeStage,  // digitize the batch
+    mergeStage,     // merge each event's hits into raw hits
+    calibrateStage  // calibrate each event's raw hits into it
   };
 
+  std::vector<std::string>
+  stageNames()
+  {
+    return {"fetch", "digitize", "merge", "calibrate"};
+  }
+
+  //! Working state of the calibrator for one batch of events
+  struct CalibratorScratch {
+    std::unique_ptr<falaise::geiger_digitizer::scratch> digitizer;
+    std::vector<std::shared_ptr<const falaise::cell_mask>> masks; // by event
+    std::vector<std::uint32_t> order; // raw hits of an event, sorted by GID
+    std::vector<std::uint64_t> gids;  // ... and their GIDs
+    std::vector<double> driftTime; // drift time of each sorted hit
+    std::vector<double> radius;    // ... and its drift radius
+    falaise::stage_timings timings; // of this scratch's users, if timing
+    std::uint64_t batches{0};       // ... and the batches they processed
+  };
 } // namespace
 
-class MockTrackerCalibrator : public dpp::base_module {
+//! Mock digitization and calibration of simulated Geiger hits
+/*
+ * Events can be processed singly with process(), or in batches with
+ * process_batch(), which digitizes the step hits of all events of the
+ * batch in a single pass. Results do not depend on how events are batched.
+ *
+ * Each event must hold an event header in bank "EH_label", as well as its
+ * simulated data in "SD_label": the header's run and event numbers seed
+ * the event's digitization and select its cell mask and constants. An
+ * event without a header gets PROCESS_ERROR, as does a batch holding one,
+ * of which no event is then processed.
+ *
+ * The module is reentrant: configuration and geometry tables are only
+ * modified by initialize() and reset(), and each call to process() or
+ * process_batch() works on its own CalibratorScratch taken from a pool, so
+ * they may be called concurrently for different events. Scratch storage is
+ * kept between calls, so once it has grown to the largest batch seen,
+ * digitization makes no heap allocations.
+ *
+ * Drift time and radius are related by falaise::mock_drift_radius, which is
+ * tabulated at initialize() in a falaise::drift_model of "drift.table_size"
+ * points up to radius "drift.max_radius", and used both to digitize step
+ * hits and to calibrate the resulting raw hits.
+ *
+ * Raw hits are calibrated with per-cell falaise::cell_constants, mapped from
+ * the binary file named by "calibration.constants_file" (see
+ * flcellconstants), or if it is not set, no time offsets or radius
+ * corrections and the digitization's "plasma_speed" for every cell.
+ *
+ * Alternatively "calibration.constants_dir" names a directory of binary
+ * files "<first>-<last>.bin", each valid for runs first to last, and each
+ * event is calibrated with the constants for its run. These are held in a
+ * falaise::cell_constants_cache of "calibration.cache_size" sets that, if
+ * "calibration.prefetch" is true, loads the following interval's constants
+ * in the background.
+ *
+ * Step hits in the dead or noisy cells listed in the text file
+ * "mask.file" (see falaise::read_cell_mask) are dropped before
+ * digitization. When the run number changes, the file is read again if it
+ * has changed since it was read, so the mask can be updated between runs
+ * without reinitializing.
+ *
+ * Calibrated tracker hits are sorted by cell, so by (side, layer, row),
+ * and the calibrated data's properties hold a falaise::tracker_layer_index
+ * of them (see falaise::load_tracker_layer_index), so consumers can go
+ * straight to a layer's hits or binary search for a cell's.
+ *
+ * Uncorrelated noise hits are added to each event over a readout window of
+ * "noise.window", at "noise.rate" per cell or the rates in Hz of the cells
+ * listed in the text file "noise.rates_file" (see
+ * falaise::read_noise_rates), sampled by falaise::noise_model.
+ *
+ * If "timing" is true, the duration of each stage of processing (see
+ * Stage) is recorded in the scratch in use, so per thread, and their
+ * count, mean, median, 99th percentile and maximum are written to
+ * std::clog at reset(). The fetch and digitize stages are timed per batch,
+ * the others per event. Each stage costs one falaise::tick_clock read, a
+ * few ns, so only one batch in every "timing.stride" (default 16)
+ * processed by a scratch is timed, and the counts reported are of these
+ * sampled batches and their events. Setting it to 1 times every batch.
+ * The overhead is measured by calibrator_bench, with timing off and on.
+ * Nothing is timed if timing is off.
+ */
+class MockTrackerCalibrator : public dpp::base_module,
+                              public falaise::batch_module {
 public:
   using CalibratedData = snemo::datamodel::calibrated_data;
-  using RawTrackerHit = snemo::datamodel::mock_raw_tracker_hit;
-  using RawTrackerHitCollection = std::list<RawTrackerHit>;
+  using CalibratedTrackerHit = snemo::datamodel::calibrated_tracker_hit;
+  using RawTrackerHitCollection = falaise::raw_tracker_hit_buffer;
 
 public:
   MockTrackerCalibrator() = default;
@@ -61,71 +263,344 @@ public:
     config_ = CalibratorConfig(config);
     geoManager_ = &(services.get<geomtools::geometry_service>(config_.Geo_label)
                       .get_geom_manager());
+    const double v0 = config_.drift_velocity;
+    const double r0 = config_.drift_radius_scale;
+    if (config_.drift_table_size < 2) {
+      throw std::logic_error("drift.table_size must be at least 2");
+    }
+    falaise::drift_model drift{
+      [v0, r0](double t) { return falaise::mock_drift_radius(t, v0, r0); },
+      falaise::mock_drift_time(config_.drift_max_radius, v0, r0),
+      static_cast<std::size_t>(config_.drift_table_size)};
+
+    falaise::geiger_digitizer::parameters p;
+    p.anode_efficiency = config_.anode_efficiency;
+    p.cathode_efficiency = config_.cathode_efficiency;
+    p.plasma_speed = config_.plasma_speed;
+    p.random_id = config_.random_id;
+    p.random_seed = config_.random_seed;
+    // Shared with other modules of the geometry, see reset()
+    cells_ = falaise::shared_tracker_cells(*geoManager_, config_.cell_category);
+    const auto& cells = cells_->table;
+
+    std::vector<double> noiseRates(cells.size(), config_.noise_rate);
+    if (!config_.noise_file.empty()) {
+      std::string path{config_.noise_file};
+      datatools::fetch_path_with_env(path);
+      std::ifstream in{path};
+      if (!in) {
+        throw falaise::bad_noise_model_error("cannot open noise rates file " +
+                                             path);
+      }
+      noiseRates = falaise::read_noise_rates(
+        in, cells, config_.noise_rate / CLHEP::hertz);
+      for (double& rate : noiseRates) {
+        rate *= CLHEP::hertz;
+      }
+    }
+    falaise::noise_model noise{std::move(noiseRates), config_.noise_window};
+
+    // The digitizer shares the table, keeping cells_ alive with it
+    digitizer_ = falaise::geiger_digitizer{
+      std::shared_ptr<const falaise::tracker_cell_table>{cells_, &cells},
+      std::move(drift),
+      p,
+      std::move(noise)};
+
+    // Calibrated hits are indexed by layer over all sides and layers
+    trackerSides_ = digitizer_.cells().address_end(1);
+    trackerLayers_ = digitizer_.cells().address_end(2);
+
+    if (!config_.constants_file.empty() && !config_.constants_dir.empty()) {
+      throw std::logic_error(
+        "only one of calibration.constants_file and calibration.constants_dir"
+        " may be set");
+    }
+    if (config_.constants_cache_size < 1) {
+      throw std::logic_error("calibration.cache_size must be at least 1");
+    }
+    if (config_.timing_stride < 1) {
+      throw std::logic_error("timing.stride must be at least 1");
+    }
+    auto loadConstants = [this](std::string const& path) {
+      auto constants = falaise::cell_constants_table::map_file(path);
+      if (!constants.matches(digitizer_.cells())) {
+        throw falaise::bad_cell_constants_error(
+          "constants in " + path + " are not for the tracker cells of " +
+          config_.cell_category);
+      }
+      return constants;
+    };
+    if (!config_.constants_dir.empty()) {
+      std::string dir{config_.constants_dir};
+      datatools::fetch_path_with_env(dir);
+      constantsCache_.reset(new falaise::cell_constants_cache{
+        dir,
+        loadConstants,
+        static_cast<std::size_t>(config_.constants_cache_size),
+        config_.constants_prefetch});
+    }
+    else if (!config_.constants_file.empty()) {
+      std::string path{config_.constants_file};
+      datatools::fetch_path_with_env(path);
+      constants_ = std::make_shared<falaise::cell_constants_table const>(
+        loadConstants(path));
+    }
+    else {
+      constants_ = std::make_shared<falaise::cell_constants_table const>(
+        digitizer_.cells(),
+        falaise::cell_constants{0.0, 0.0, 1.0, config_.plasma_speed});
+    }
+    mask_.reset();
+    if (!config_.mask_file.empty()) {
+      datatools::fetch_path_with_env(config_.mask_file);
+      // Read now so that a bad file is reported at initialization, with no
+      // run yet (-1 is datatools::event_id's invalid run number)
+      const auto stamp = fileStamp(config_.mask_file);
+      mask_ = std::make_shared<const RunMask>(
+        RunMask{-1,
+                stamp,
+                std::make_shared<const falaise::cell_mask>(
+                  falaise::load_cell_mask(config_.mask_file,
+                                          digitizer_.cells()))});
+    }
+    scratch_.reset(new falaise::object_pool<CalibratorScratch>([this] {
+      std::unique_ptr<CalibratorScratch> s{new CalibratorScratch};
+      s->digitizer = digitizer_.make_scratch();
+      if (config_.timing) {
+        s->timings = falaise::stage_timings{stageNames()};
+      }
+      return s;
+    }));
     this->_set_initialized(true);
   }
 
   dpp::base_module::process_status
   process(datatools::things& event) override
   {
-    const auto& simData = event.get<mctools::simulated_data>(config_.SD_label);
-    RawTrackerHitCollection rawHits = this->mockupRawTrackerHits(simData);
-    // oddity of datatools::things operation (putting rather than creating data)
-    //  NB: could also use module name (this->get_name() as output label).
-    event.add<CalibratedData>(config_.CD_label) =
-      std::move(this->makeCalibration(rawHits));
+    datatools::things* batch[] = {&event};
+    return this->process_batch({batch, 1});
+  }
+
+  dpp::base_module::process_status
+  process_batch(falaise::event_batch events) override
+  {
+    // The run and event numbers seed digitization, and choose the mask and
+    // constants, so events without them cannot be processed
+    for (auto* event : events) {
+      if (!event->has(config_.EH_label)) {
+        return PROCESS_ERROR;
+      }
+    }
+
+    auto scratch = scratch_->acquire();
+    falaise::geiger_digitizer::scratch& digitizerScratch = *scratch->digitizer;
+    const bool timed = config_.timing &&
+                       scratch->batches++ % config_.timing_stride == 0;
+    falaise::stage_timer timer{timed ? &scratch->timings : nullptr};
+    // Borrow the step hits, the events own them for the duration of the
+    // batch, and hold the masks until then
+    digitizerScratch.clear();
+    scratch->masks.clear();
+    for (auto* event : events) {
+      const auto& simData =
+        event->get<mctools::simulated_data>(config_.SD_label);
+      const auto& eventID =
+        event->get<snemo::datamodel::event_header>(config_.EH_label).get_id();
+      scratch->masks.push_back(this->maskFor(eventID.get_run_number()));
+      digitizerScratch.add_event(
+        falaise::view_step_hits(simData, config_.hit_category),
+        eventID.get_run_number(),
+        eventID.get_event_number(),
+        scratch->masks.back().get());
+    }
+    timer.lap(fetchStage);
+    digitizer_.digitize(digitizerScratch);
+    timer.lap(digitizeStage);
+
+    for (std::size_t e = 0; e < events.size(); ++e) {
+      const auto& rawHits = digitizer_.raw_hits(digitizerScratch, e);
+      timer.lap(mergeStage);
+      const auto constants = this->constantsFor(*events[e]);
+      // Calibrate straight into the bank held by the event, as
+      // datatools::things default-constructs the data it holds
+      //  NB: could also use module name (this->get_name() as output label).
+      falaise::add_bank<CalibratedData>(
+        *events[e], config_.CD_label, [&](CalibratedData& calibrated) {
+          this->makeCalibration(rawHits, *constants, *scratch, calibrated);
+        });
+      timer.lap(calibrateStage);
+    }
     return PROCESS_OK;
   }
 
   void
   reset() override
   {
+    if (scratch_ && config_.timing) {
+      falaise::stage_timings total{stageNames()};
+      scratch_->for_each_idle(
+        [&total](CalibratorScratch& s) { total.merge(s.timings); });
+      std::clog << "MockTrackerCalibrator '" << this->get_name()
+                << "' stage timings, of 1 batch in " << config_.timing_stride
+                << " (counts are of sampled batches for fetch and digitize,"
+                   " of their events for merge and calibrate):\n";
+      total.report(std::clog);
+    }
+    scratch_.reset();
+    digitizer_ = falaise::geiger_digitizer{};
+    cells_.reset();
+    constantsCache_.reset();
+    constants_.reset();
+    mask_.reset();
     this->_set_initialized(false);
   }
 
 private:
-  //! Create mocked raw tracker hits from MC output
-  RawTrackerHitCollection
-  mockupRawTrackerHits(mctools::simulated_data const& simHits)
+  //! Return the cell mask for run, or null if there is none
+  /*
+   * The first call with a new run number checks whether the file has
+   * changed, reading it again only if so, later calls for the same run
+   * return the mask with one atomic load
+   */
+  std::shared_ptr<const falaise::cell_mask>
+  maskFor(std::int32_t run)
+  {
+    if (config_.mask_file.empty()) {
+      return nullptr;
+    }
+    auto current = std::atomic_load(&mask_);
+    if (current->run == run) {
+      return current->mask;
+    }
+    std::lock_guard<std::mutex> lock{maskMutex_};
+    current = std::atomic_load(&mask_);
+    if (current->run != run) {
+      const auto stamp = fileStamp(config_.mask_file);
+      auto mask = current->mask;
+      if (!(stamp == current->stamp)) {
+        mask = std::make_shared<const falaise::cell_mask>(
+          falaise::load_cell_mask(config_.mask_file, digitizer_.cells()));
+      }
+      current = std::make_shared<const RunMask>(RunMask{run, stamp, mask});
+      std::atomic_store(&mask_, current);
+    }
+    return current->mask;
+  }
+
+  //! Return the calibration constants for the run of event
+  falaise::cell_constants_cache::table_ptr
+  constantsFor(const datatools::things& event) const
   {
-    using MCGeigerHitCollection =
-      mctools::simulated_data::hit_handle_collection_type;
-    // No tracker info, nothing to do...
-    if (!simHits.has_step_hits(config_.hit_category)) {
-      return RawTrackerHitCollection{};
-    }
-
-    MCGeigerHitCollection simGeigerHits =
-      simHits.get_step_hits_dict().at(config_.hit_category);
-    RawTrackerHitCollection output;
-
-    // For each step hit...
-    for (const auto& hit : simGeigerHits) {
-      // 1. Find drift distance...
-      //    - continue if < "anode_efficiency"
-      // 2. Do Anode TDC
-      // 3. Do Cathode TDCs
-      //
-      // Insert into output collection...
-      // 1. ... directly if GID not used before
-      // 2. ... else, update existing hit if new drift time less than existing
-      // one
-      //
-    }
-
-    return output;
+    if (!constantsCache_) {
+      return constants_;
+    }
+    const auto& eventID =
+      event.get<snemo::datamodel::event_header>(config_.EH_label).get_id();
+    return constantsCache_->get(eventID.get_run_number());
   }
 
-  CalibratedData
-  makeCalibration(RawTrackerHitCollection const& input)
+  //! Calibrate raw hits into output in one linear pass over the buffer
+  /*
+   * Hits are calibrated in order of GID, indexed by a
+   * falaise::tracker_layer_index in output's properties. Drift radii of all
+   * hits are computed first, in one drift_model call using scratch's
+   * buffers
+   */
+  void
+  makeCalibration(RawTrackerHitCollection const& input,
+                  const falaise::cell_constants_table& constants,
+                  CalibratorScratch& scratch,
+                  CalibratedData& output) const
   {
-    CalibratedData x;
-    x.grab_properties().store("foo", "bar");
-    return x;
+    auto& calibratedHits = output.calibrated_tracker_hits();
+    calibratedHits.reserve(input.size());
+
+    // Few hits, so sorting row numbers by GID beats sorting the columns
+    std::vector<std::uint32_t>& order = scratch.order;
+    std::vector<std::uint64_t>& gids = scratch.gids;
+    order.resize(input.size());
+    gids.resize(input.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(),
+              order.end(),
+              [&input](std::uint32_t a, std::uint32_t b) {
+                return input.gids()[a] < input.gids()[b];
+              });
+    for (std::size_t i = 0; i < input.size(); ++i) {
+      gids[i] = input.gids()[order[i]];
+    }
+    falaise::store_tracker_layer_index(
+      output.grab_properties(),
+      falaise::tracker_layer_index{
+        gids.data(), gids.size(), trackerSides_, trackerLayers_});
+
+    // Prompt hits only, so drift time is the anode time less the cell's t0
+    const auto& cells = digitizer_.cells();
+    std::vector<double>& driftTime = scratch.driftTime;
+    std::vector<double>& radius = scratch.radius;
+    driftTime.resize(input.size());
+    radius.resize(input.size());
+    for (std::size_t i = 0; i < input.size(); ++i) {
+      driftTime[i] = input.anode_times()[order[i]] -
+                     constants[cells.index(gids[i])].anode_t0;
+    }
+    digitizer_.drift().radius(driftTime.data(), radius.data(), input.size());
+
+    for (std::size_t i = 0; i < input.size(); ++i) {
+      const auto raw = input[order[i]];
+      const std::uint32_t cellIndex = cells.index(raw.gid);
+      const auto& cell = cells[cellIndex];
+      const auto& cellConstants = constants[cellIndex];
+      const double anodeTime = raw.anode_time - cellConstants.anode_t0;
+      const double bottomTime =
+        raw.bottom_cathode_time - cellConstants.cathode_t0;
+      const double topTime = raw.top_cathode_time - cellConstants.cathode_t0;
+      const double plasmaSpeed = cellConstants.plasma_speed;
+
+      CalibratedData::tracker_hit_handle_type hdl{new CalibratedTrackerHit};
+      CalibratedTrackerHit& hit = hdl.grab();
+      hit.set_hit_id(i);
+      hit.set_geom_id(falaise::unpack_geom_id(raw.gid));
+      hit.set_anode_time(anodeTime);
+      hit.set_x(cell.anode_x);
+      hit.set_y(cell.anode_y);
+      hit.set_r(cellConstants.radius_factor * radius[i]);
+
+      // Longitudinal position from plasma propagation times to the cathodes
+      hit.set_bottom_cathode_missing(!raw.has_bottom_cathode_time());
+      hit.set_top_cathode_missing(!raw.has_top_cathode_time());
+      const double zMid = 0.5 * (cell.z_min + cell.z_max);
+      if (raw.has_bottom_cathode_time() && raw.has_top_cathode_time()) {
+        hit.set_z(zMid + 0.5 * plasmaSpeed * (bottomTime - topTime));
+      }
+      else if (raw.has_bottom_cathode_time()) {
+        hit.set_z(cell.z_min + plasmaSpeed * (bottomTime - anodeTime));
+      }
+      else if (raw.has_top_cathode_time()) {
+        hit.set_z(cell.z_max - plasmaSpeed * (topTime - anodeTime));
+      }
+      else {
+        hit.set_z(zMid);
+      }
+
+      calibratedHits.push_back(hdl);
+    }
   }
 
 private:
   const geomtools::manager* geoManager_ = nullptr;
   CalibratorConfig config_;
+  std::shared_ptr<const falaise::tracker_cells> cells_; //< of geoManager_
+  falaise::geiger_digitizer digitizer_;     //< built at initialize
+  std::uint32_t trackerSides_ = 0;          //< sides of digitizer_ cells
+  std::uint32_t trackerLayers_ = 0;         //< ... and layers per side
+  //! Constants by digitizer_ cell index, fixed or by run
+  falaise::cell_constants_cache::table_ptr constants_;
+  std::unique_ptr<falaise::cell_constants_cache> constantsCache_;
+  std::shared_ptr<const RunMask> mask_; //< of the latest run, atomic access
+  std::mutex maskMutex_;                //< serializes reading mask_file
+  std::unique_ptr<falaise::object_pool<CalibratorScratch>> scratch_;
 
   DPP_MODULE_REGISTRATION_INTERFACE(MockTrackerCalibrator);
 };
@@ -0,0 +1,195 @@
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "bayeux/datatools/service_manager.h"
+#include "bayeux/dpp/base_module.h"
+#include "bayeux/geomtools/geometry_service.h"
+#include "bayeux/geomtools/manager.h"
+#include "falaise/property_reader.h"
+#include "falaise/snemo/datamodels/calibrated_data.h"
+#include "falaise/snemo/datamodels/calibrated_tracker_hit.h"
+#include "falaise/snemo/datamodels/data_model.h"
+#include "falaise/snemo/processing/services.h"
+
+#include "cell_adjacency.h"
+#include "object_pool.h"
+#include "packed_geom_id.h"
+#include "tracker_cell_table.h"
+#include "tracker_trigger.h"
+
+namespace {
+  using namespace falaise::properties;
+  struct TriggerConfig {
+    TriggerConfig() = default;
+    explicit TriggerConfig(const datatools::properties& p)
+      : CD_label(getValueOrDefault(
+          p,
+          "CD_label",
+          snemo::datamodel::data_info::default_calibrated_data_label()))
+      , Geo_label(getValueOrDefault(
+          p,
+          "Geo_label",
+          snemo::processing::service_info::default_geometry_service_label()))
+      , cell_category(
+          getValueOrDefault(p, "cell_category", std::string("drift_cell_core")))
+      , trigger_key(
+          getValueOrDefault(p, "trigger_key", std::string("tracker_trigger")))
+      , zone_rows(getValueOrDefault(p, "zone.rows", 16))
+      , zone_stride(getValueOrDefault(p, "zone.stride", 8))
+      , conditions(
+          getValueOrDefault(p, "conditions", std::vector<std::string>{}))
+      , reject(getValueOrDefault(p, "reject", false))
+    {
+      for (const auto& name : conditions) {
+        std::uint32_t layers{0};
+        for (int l : getValueOrDefault(
+               p, name + ".layers", std::vector<int>{})) {
+          if (l < 0 || l >= 32) {
+            throw std::logic_error(name + ".layers must be in [0, 32)");
+          }
+          layers |= 1u << l;
+        }
+        const int minLayers = getValueOrDefault(p, name + ".min_layers", 0);
+        const int sides = getValueOrDefault(p, name + ".sides", 1);
+        if (minLayers < 0 || sides < 1) {
+          throw std::logic_error(
+            name + ".min_layers cannot be negative, nor .sides below 1");
+        }
+        // Else the condition is met by any event, even without hits
+        if (minLayers == 0 && layers == 0) {
+          throw std::logic_error(name + " needs .min_layers or .layers");
+        }
+        trigger_conditions.push_back(
+          {static_cast<std::uint32_t>(minLayers),
+           layers,
+           static_cast<std::uint32_t>(sides)});
+      }
+    }
+
+    std::string CD_label;                // calibrated hits of the trigger
+    std::string Geo_label;               // name of geo service
+    std::string cell_category;           // geometry category of Geiger cells
+    std::string trigger_key;             // property holding the decision
+    int zone_rows;                       // rows of each trigger zone
+    int zone_stride;                     // rows between starts of zones
+    std::vector<std::string> conditions; // names of conditions, see below
+    bool reject;                         // stop untriggered events
+    std::vector<falaise::tracker_trigger::condition> trigger_conditions;
+  };
+
+  //! Working state of the trigger for one event
+  struct TriggerScratch {
+    falaise::tracker_trigger trigger;
+    std::vector<std::uint64_t> gids; // packed GID of each hit
+  };
+} // namespace
+
+//! Emulation of the tracker trigger on calibrated Geiger hits
+/*
+ * The fired cells of the "CD_label" bank are tested by a
+ * falaise::tracker_trigger, sized at initialize() from the cells of
+ * "cell_category" in the geometry, shared with other modules by
+ * falaise::shared_tracker_cells, with zones of "zone.rows" rows every
+ * "zone.stride" rows.
+ *
+ * The trigger's conditions are listed by name in "conditions", each set by
+ * "<name>.min_layers", the layers that must fire in one zone, by
+ * "<name>.layers", a list of layers that must all fire in it, and by
+ * "<name>.sides", the sides that must have such a zone, e.g.
+ *
+ *   conditions : string[2] = "majority" "through"
+ *   majority.min_layers : integer = 6
+ *   through.layers : integer[2] = 0 8
+ *   through.sides : integer = 2
+ *
+ * At least one condition must be given, each with at least one of
+ * "<name>.min_layers" and "<name>.layers", and the event is triggered if
+ * any is met. The decision is stored in the calibrated data's properties as
+ * the boolean "trigger_key", and the conditions met as the integer
+ * "<trigger_key>.conditions", bit i for condition i. If "reject" is true,
+ * processing of untriggered events stops here, so that later modules of a
+ * chain skip them.
+ *
+ * Like MockTrackerCalibrator, the module is reentrant, each call to
+ * process() working on its own scratch storage taken from a pool.
+ */
+class MockTrackerTrigger : public dpp::base_module {
+public:
+  using CalibratedData = snemo::datamodel::calibrated_data;
+
+public:
+  MockTrackerTrigger() = default;
+  ~MockTrackerTrigger() { this->reset(); }
+
+  void
+  initialize(const datatools::properties& config,
+             datatools::service_manager& services,
+             dpp::module_handle_dict_type&) override
+  {
+    config_ = TriggerConfig(config);
+    if (config_.conditions.empty()) {
+      throw std::logic_error("conditions must name at least one condition");
+    }
+    if (config_.zone_rows < 1 || config_.zone_stride < 1) {
+      throw std::logic_error("zone.rows and zone.stride must be at least 1");
+    }
+    const auto& geoManager =
+      services.get<geomtools::geometry_service>(config_.Geo_label)
+        .get_geom_manager();
+    cells_ = falaise::shared_tracker_cells(geoManager, config_.cell_category);
+
+    // Build one now, so that configuration errors are reported here
+    const falaise::tracker_trigger trigger{cells_->table.address_end(1),
+                                           cells_->table.address_end(2),
+                                           cells_->table.address_end(3),
+                                           std::uint32_t(config_.zone_rows),
+                                           std::uint32_t(config_.zone_stride),
+                                           config_.trigger_conditions};
+    scratch_.reset(new falaise::object_pool<TriggerScratch>([=] {
+      std::unique_ptr<TriggerScratch> s{new TriggerScratch};
+      s->trigger = trigger;
+      return s;
+    }));
+    this->_set_initialized(true);
+  }
+
+  dpp::base_module::process_status
+  process(datatools::things& event) override
+  {
+    auto scratch = scratch_->acquire();
+    auto& calibrated = event.grab<CalibratedData>(config_.CD_label);
+    const auto& hits = calibrated.calibrated_tracker_hits();
+
+    scratch->gids.resize(hits.size());
+    for (std::size_t i = 0; i < hits.size(); ++i) {
+      scratch->gids[i] = falaise::pack_geom_id(hits[i].get().get_geom_id());
+    }
+    const std::uint32_t met =
+      scratch->trigger.evaluate(scratch->gids.data(), hits.size());
+
+    auto& properties = calibrated.grab_properties();
+    properties.update(config_.trigger_key, met != 0);
+    properties.update(config_.trigger_key + ".conditions",
+                      static_cast<int>(met));
+    return met == 0 && config_.reject ? PROCESS_STOP : PROCESS_OK;
+  }
+
+  void
+  reset() override
+  {
+    scratch_.reset();
+    cells_.reset();
+    this->_set_initialized(false);
+  }
+
+private:
+  TriggerConfig config_;
+  std::shared_ptr<const falaise::tracker_cells> cells_; //< with other modules
+  std::unique_ptr<falaise::object_pool<TriggerScratch>> scratch_;
+
+  DPP_MODULE_REGISTRATION_INTERFACE(MockTrackerTrigger);
+};
+
+DPP_MODULE_REGISTRATION_IMPLEMENT(MockTrackerTrigger, "MockTrackerTrigger");
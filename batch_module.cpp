@@ -0,0 +1,6 @@
+#include "batch_module.h"
+
+namespace falaise {
+  // Out of line, so the interface has a single type_info across libraries
+  batch_module::~batch_module() = default;
+} /* falaise */
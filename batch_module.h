@@ -0,0 +1,40 @@
+#ifndef FALAISE_BATCH_MODULE_H
+#define FALAISE_BATCH_MODULE_H
+
+#include "bayeux/datatools/things.h"
+#include "bayeux/dpp/base_module.h"
+
+#include "input_view.h"
+
+namespace falaise {
+  //! View of a batch of events to process
+  using event_batch = input_view<datatools::things*>;
+
+  //! Interface for dpp modules able to process several events per call
+  /*
+   * Modules implementing it alongside dpp::base_module can amortise
+   * per-event costs (virtual dispatch, setup of working storage, ...) over
+   * a batch. Callers holding a dpp::base_module can test for the interface
+   * with dynamic_cast.
+   *
+   * Nothing in the pipeline drivers uses batching yet: parallel_pipeline,
+   * flparallel and flshard call process() once per event, as they run a
+   * dpp::chain_module of modules and need each event's status, which
+   * process_batch() does not return. Only the tests and
+   * calibrator_batch_bench call process_batch().
+   */
+  class batch_module {
+  public:
+    virtual ~batch_module();
+
+    //! Process each event of events, as process() would
+    /*
+     * \returns PROCESS_OK if all events were processed successfully, else
+     * the status of the first event that was not
+     */
+    virtual dpp::base_module::process_status process_batch(
+      event_batch events) = 0;
+  };
+} /* falaise */
+
+#endif /* FALAISE_BATCH_MODULE_H */
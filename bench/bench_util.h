@@ -0,0 +1,123 @@
+#ifndef FALAISE_BENCH_UTIL_H
+#define FALAISE_BENCH_UTIL_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace falaise {
+  namespace bench {
+    //! Prevent the compiler from optimizing away computation of value
+    template <typename T>
+    inline void
+    do_not_optimize(T const& value)
+    {
+      asm volatile("" : : "r,m"(value) : "memory");
+    }
+
+    //! Return mean wall clock time in nanoseconds of a call to f
+    /*
+     * f is called repeatedly, doubling the number of calls per batch, until a
+     * batch takes at least min_seconds.
+     */
+    template <typename F>
+    double
+    time_per_call(F&& f, double min_seconds = 0.2)
+    {
+      using clock = std::chrono::steady_clock;
+      f(); // warm caches and allocations
+
+      for (std::size_t n = 1;; n *= 2) {
+        auto start = clock::now();
+        for (std::size_t i = 0; i < n; ++i) {
+          f();
+        }
+        std::chrono::duration<double> elapsed = clock::now() - start;
+        if (elapsed.count() >= min_seconds) {
+          return 1e9 * elapsed.count() / n;
+        }
+      }
+    }
+
+    //! Named measurements of a benchmark, for writing as JSON
+    /*
+     * Written as
+     *
+     *   {"bench": "<bench>", "results": [
+     *     {"name": "<name>", "value": <value>, "unit": "<unit>",
+     *      "better": "lower" | "higher"}, ...]}
+     *
+     * which compare_bench.py checks against a baseline. Names must not need
+     * escaping, and should stay stable so results can be compared over
+     * time.
+     */
+    class results {
+    public:
+      //! Construct empty results of the benchmark named bench
+      explicit results(std::string bench) : bench_(std::move(bench)) {}
+
+      //! Record value, in unit, of measurement name
+      void
+      add(std::string name,
+          double value,
+          std::string unit,
+          bool higher_is_better = false)
+      {
+        results_.push_back(
+          {std::move(name), value, std::move(unit), higher_is_better});
+      }
+
+      //! Write the results as JSON to out
+      void
+      write_json(std::ostream& out) const
+      {
+        out << "{\"bench\": \"" << bench_ << "\", \"results\": [";
+        char value[32];
+        for (std::size_t i = 0; i < results_.size(); ++i) {
+          auto const& r = results_[i];
+          std::snprintf(value, sizeof(value), "%.6g", r.value);
+          out << (i > 0 ? ",\n  " : "\n  ") << "{\"name\": \"" << r.name
+              << "\", \"value\": " << value << ", \"unit\": \"" << r.unit
+              << "\", \"better\": \""
+              << (r.higher_is_better ? "higher" : "lower") << "\"}";
+        }
+        out << "]}\n";
+      }
+
+      //! Write the results to $FALAISE_BENCH_JSON_DIR/<bench>.json, if set
+      /*
+       * \returns false if the file could not be written
+       */
+      bool
+      write_if_requested() const
+      {
+        char const* dir = std::getenv("FALAISE_BENCH_JSON_DIR");
+        if (dir == nullptr) {
+          return true;
+        }
+        std::ofstream out{std::string{dir} + "/" + bench_ + ".json"};
+        write_json(out);
+        return static_cast<bool>(out);
+      }
+
+    private:
+      struct result {
+        std::string name;
+        double value;
+        std::string unit;
+        bool higher_is_better;
+      };
+
+      std::string bench_;
+      std::vector<result> results_;
+    };
+  } // namespace bench
+} // namespace falaise
+
+#endif /* FALAISE_BENCH_UTIL_H */
@@ -0,0 +1,90 @@
+// Cost per event of MockTrackerCalibrator on small events, calling
+// process() per event versus process_batch() on batches of events.
+//
+// Usage: calibrator_batch_bench [events]
+#include "bench_util.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "bayeux/datatools/library_loader.h"
+#include "bayeux/dpp/module_manager.h"
+#include "falaise/falaise.h"
+
+#include "batch_module.h"
+#include "synthetic_events.h"
+
+int
+main(int argc, char* argv[])
+{
+  std::size_t nEvents{argc > 1 ? std::stoul(argv[1]) : 1024};
+
+  FALAISE_INIT();
+  datatools::library_loader loader;
+  if (loader.load("MockTrackerCalibrator", MOCKTRACKERCALIBRATOR_DIR) != 0) {
+    std::fprintf(stderr, "cannot load MockTrackerCalibrator plugin\n");
+    return EXIT_FAILURE;
+  }
+
+  falaise::demonstrator_geometry geometry;
+
+  dpp::module_manager modules;
+  modules.set_service_manager(geometry.services);
+  modules.load_module(
+    "calibrator", "MockTrackerCalibrator", datatools::properties{});
+  modules.initialize_simple();
+  auto& calibrator = modules.grab("calibrator");
+  auto& batcher = dynamic_cast<falaise::batch_module&>(calibrator);
+
+  std::printf("%zu events\n", nEvents);
+  std::printf("%8s %12s %12s %12s %12s\n",
+              "hits",
+              "process",
+              "batch=16",
+              "batch=64",
+              "batch=256");
+  for (std::size_t nHits : {1, 4, 16, 64}) {
+    falaise::step_hit_generator::parameters p;
+    p.hits = nHits;
+    falaise::step_hit_generator generator{geometry.cells, p};
+    auto events = falaise::make_synthetic_events(generator, nEvents);
+    std::vector<datatools::things*> pointers;
+    for (auto& e : events) {
+      pointers.push_back(e.get());
+    }
+    // Output bank is removed each pass, so events can be reprocessed
+    auto removeOutput = [&events] {
+      for (auto& e : events) {
+        e->remove("CD");
+      }
+    };
+
+    double single = falaise::bench::time_per_call([&] {
+      for (auto& e : events) {
+        calibrator.process(*e);
+      }
+      removeOutput();
+    });
+    std::printf("%8zu %12.1f", nHits, single / nEvents);
+
+    for (std::size_t batchSize : {16, 64, 256}) {
+      double batched = falaise::bench::time_per_call([&] {
+        for (std::size_t first = 0; first < nEvents; first += batchSize) {
+          std::size_t n = std::min(batchSize, nEvents - first);
+          batcher.process_batch({pointers.data() + first, n});
+        }
+        removeOutput();
+      });
+      std::printf(" %12.1f", batched / nEvents);
+    }
+    std::printf("  ns/event\n");
+  }
+
+  modules.reset();
+  FALAISE_FINI();
+  return 0;
+}
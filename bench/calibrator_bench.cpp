@@ -0,0 +1,145 @@
+// Throughput of MockTrackerCalibrator on synthetic events from
+// step_hit_generator, by occupancy pattern, hits per event and fraction
+// of hits sharing a cell, then the overhead of stage timing (the
+// "timing" property), timing every batch and one in the default stride.
+//
+// Usage: calibrator_bench [events] [seed]
+#include "bench_util.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "bayeux/datatools/library_loader.h"
+#include "bayeux/dpp/module_manager.h"
+#include "falaise/falaise.h"
+
+#include "synthetic_events.h"
+
+int
+main(int argc, char* argv[])
+{
+  std::size_t nEvents{argc > 1 ? std::stoul(argv[1]) : 1024};
+  std::uint64_t seed{argc > 2 ? std::stoull(argv[2]) : 12345};
+
+  FALAISE_INIT();
+  datatools::library_loader loader;
+  if (loader.load("MockTrackerCalibrator", MOCKTRACKERCALIBRATOR_DIR) != 0) {
+    std::fprintf(stderr, "cannot load MockTrackerCalibrator plugin\n");
+    return EXIT_FAILURE;
+  }
+
+  falaise::demonstrator_geometry geometry;
+
+  dpp::module_manager modules;
+  modules.set_service_manager(geometry.services);
+  modules.load_module(
+    "calibrator", "MockTrackerCalibrator", datatools::properties{});
+  datatools::properties timedConfig;
+  timedConfig.store("timing", true);
+  modules.load_module("timed", "MockTrackerCalibrator", timedConfig);
+  datatools::properties timedAllConfig{timedConfig};
+  timedAllConfig.store("timing.stride", 1);
+  modules.load_module("timed_all", "MockTrackerCalibrator", timedAllConfig);
+  modules.initialize_simple();
+  auto& calibrator = modules.grab("calibrator");
+
+  falaise::bench::results results{"calibrator"};
+  std::printf("%zu events, seed %llu\n",
+              nEvents,
+              static_cast<unsigned long long>(seed));
+  std::printf("%-8s %6s %6s %12s %10s\n",
+              "pattern",
+              "hits",
+              "multi",
+              "events/s",
+              "ns/hit");
+  using occupancy = falaise::step_hit_generator::occupancy;
+  for (auto pattern : {occupancy::uniform, occupancy::tracks}) {
+    for (std::size_t nHits : {8, 32, 128}) {
+      for (double multi : {0.0, 0.3}) {
+        falaise::step_hit_generator::parameters p;
+        p.hits = nHits;
+        p.pattern = pattern;
+        p.multi_hit_fraction = multi;
+        p.seed = seed;
+        falaise::step_hit_generator generator{geometry.cells, p};
+        auto events = falaise::make_synthetic_events(generator, nEvents);
+
+        // Output bank is removed each pass, so events can be reprocessed
+        double ns = falaise::bench::time_per_call([&] {
+          for (auto& e : events) {
+            calibrator.process(*e);
+          }
+          for (auto& e : events) {
+            e->remove("CD");
+          }
+        });
+        char const* patternName =
+          pattern == occupancy::tracks ? "tracks" : "uniform";
+        std::printf("%-8s %6zu %6.1f %12.0f %10.1f\n",
+                    patternName,
+                    nHits,
+                    multi,
+                    nEvents * 1e9 / ns,
+                    ns / (nEvents * nHits));
+        char name[64];
+        std::snprintf(name,
+                      sizeof(name),
+                      "%s/hits=%zu/multi=%g",
+                      patternName,
+                      nHits,
+                      multi);
+        results.add(std::string{name} + "/rate",
+                    nEvents * 1e9 / ns,
+                    "events/s",
+                    true);
+        results.add(
+          std::string{name} + "/per_hit", ns / (nEvents * nHits), "ns/hit");
+      }
+    }
+  }
+
+  // Timing costs most, relative to processing, with the fewest hits
+  std::printf("\n%-6s %12s %12s %12s\n",
+              "hits",
+              "off (ns/ev)",
+              "stride 16",
+              "stride 1");
+  for (std::size_t nHits : {1, 8}) {
+    falaise::step_hit_generator::parameters p;
+    p.hits = nHits;
+    p.seed = seed;
+    falaise::step_hit_generator generator{geometry.cells, p};
+    auto events = falaise::make_synthetic_events(generator, nEvents);
+    auto timeWith = [&](dpp::base_module& module) {
+      return falaise::bench::time_per_call([&] {
+        for (auto& e : events) {
+          module.process(*e);
+        }
+        for (auto& e : events) {
+          e->remove("CD");
+        }
+      });
+    };
+    const double off = timeWith(calibrator);
+    const double timed = timeWith(modules.grab("timed"));
+    const double timedAll = timeWith(modules.grab("timed_all"));
+    std::printf("%-6zu %12.1f %11.2f%% %11.2f%%\n",
+                nHits,
+                off / nEvents,
+                100 * (timed / off - 1),
+                100 * (timedAll / off - 1));
+    const std::string name{"timing/hits=" + std::to_string(nHits)};
+    // As times, since compare_bench.py compares ratios of measurements
+    results.add(name + "/off", off / nEvents, "ns/event");
+    results.add(name + "/on", timed / nEvents, "ns/event");
+    results.add(name + "/on/stride=1", timedAll / nEvents, "ns/event");
+  }
+
+  modules.reset();
+  FALAISE_FINI();
+  return results.write_if_requested() ? 0 : EXIT_FAILURE;
+}
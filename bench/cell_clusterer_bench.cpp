@@ -0,0 +1,86 @@
+// Cost per event of clustering fired cells of a full tracker (2 x 9 x 113
+// cells) with cell_clusterer, versus union-find over all pairs of cells
+// within one layer and row of each other, at increasing occupancy.
+//
+// Usage: cell_clusterer_bench
+#include "bench_util.h"
+#include "cell_clusterer.h"
+#include "packed_geom_id.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+  //! Cluster gids into clusters by comparing all pairs, as roots
+  void
+  naiveClusters(std::vector<std::uint64_t> const& gids,
+                std::vector<std::uint32_t>& clusters)
+  {
+    clusters.resize(gids.size());
+    std::iota(clusters.begin(), clusters.end(), 0);
+    auto find = [&clusters](std::uint32_t i) {
+      while (clusters[i] != i) {
+        clusters[i] = clusters[clusters[i]];
+        i = clusters[i];
+      }
+      return i;
+    };
+    auto near = [](std::uint64_t a, std::uint64_t b, std::uint32_t i) {
+      std::uint32_t const x = falaise::packed_address(a, i);
+      std::uint32_t const y = falaise::packed_address(b, i);
+      return x <= y + 1 && y <= x + 1;
+    };
+    for (std::uint32_t i = 0; i < gids.size(); ++i) {
+      for (std::uint32_t j = 0; j < i; ++j) {
+        if (falaise::packed_address(gids[i], 1) ==
+              falaise::packed_address(gids[j], 1) &&
+            near(gids[i], gids[j], 2) && near(gids[i], gids[j], 3)) {
+          clusters[find(i)] = find(j);
+        }
+      }
+    }
+    for (std::uint32_t i = 0; i < gids.size(); ++i) {
+      clusters[i] = find(i);
+    }
+  }
+} // namespace
+
+int
+main()
+{
+  std::mt19937 rng{12345};
+  std::uniform_int_distribution<std::uint32_t> side{0, 1};
+  std::uniform_int_distribution<std::uint32_t> layer{0, 8};
+  std::uniform_int_distribution<std::uint32_t> row{0, 112};
+  falaise::cell_clusterer clusterer{2, 9, 113};
+  std::vector<std::uint32_t> clusters;
+
+  falaise::bench::results results{"cell_clusterer"};
+  std::printf(
+    "%10s %14s %14s %10s\n", "cells", "pairwise (ns)", "bitmap (ns)", "ratio");
+  for (std::size_t n : {20, 100, 200, 500, 1000}) {
+    std::vector<std::uint64_t> gids(n);
+    for (auto& g : gids) {
+      g = falaise::pack_geom_id({1204, 0, side(rng), layer(rng), row(rng)});
+    }
+
+    double pairwise = falaise::bench::time_per_call([&] {
+      naiveClusters(gids, clusters);
+      falaise::bench::do_not_optimize(clusters.data());
+    });
+    clusters.resize(n);
+    double bitmap = falaise::bench::time_per_call([&] {
+      falaise::bench::do_not_optimize(
+        clusterer.cluster(gids.data(), n, clusters.data()));
+    });
+    std::printf(
+      "%10zu %14.0f %14.0f %10.1f\n", n, pairwise, bitmap, pairwise / bitmap);
+    results.add("pairwise/cells=" + std::to_string(n), pairwise, "ns/event");
+    results.add("bitmap/cells=" + std::to_string(n), bitmap, "ns/event");
+  }
+  return results.write_if_requested() ? 0 : EXIT_FAILURE;
+}
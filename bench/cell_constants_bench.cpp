@@ -0,0 +1,84 @@
+// Startup cost of per-cell calibration constants for a full tracker
+// (2 x 9 x 113 cells), reading and parsing the text source versus mapping
+// the binary file converted from it, each followed by checking the table
+// against the cells.
+//
+// Usage: cell_constants_bench [directory for temporary files]
+#include "bench_util.h"
+#include "cell_constants.h"
+
+#include <cstdio>
+#include <fstream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+  //! Cells [1204:0.side.layer.row] of the tracker
+  std::vector<falaise::tracker_cell_table::entry>
+  makeCells()
+  {
+    std::vector<falaise::tracker_cell_table::entry> cells;
+    for (std::uint32_t side = 0; side < 2; ++side) {
+      for (std::uint32_t layer = 0; layer < 9; ++layer) {
+        for (std::uint32_t row = 0; row < 113; ++row) {
+          double x = (side == 0 ? -1.0 : 1.0) * (30.0 + 44.0 * layer);
+          double y = 44.0 * row;
+          auto key = falaise::pack_geom_id({1204, 0, side, layer, row});
+          cells.push_back({key, {x, y, -1450.0, 1450.0, 2900.0}});
+        }
+      }
+    }
+    return cells;
+  }
+} // namespace
+
+int
+main(int argc, char* argv[])
+{
+  std::string const dir{argc > 1 ? argv[1] : "."};
+  std::string const textFile{dir + "/cell_constants_bench.txt"};
+  std::string const binaryFile{dir + "/cell_constants_bench.bin"};
+
+  auto cells = makeCells();
+  falaise::tracker_cell_table table{cells};
+  {
+    std::mt19937 rng{12345};
+    std::normal_distribution<double> t0{10.0, 2.0};
+    std::normal_distribution<double> factor{1.0, 0.01};
+    std::ofstream out{textFile};
+    out.precision(17);
+    out << "# geom_id anode_t0 cathode_t0 radius_factor plasma_speed\n";
+    for (auto const& c : cells) {
+      out << "[" << falaise::packed_type(c.gid) << ":";
+      for (std::uint32_t i = 0; i < falaise::packed_depth(c.gid); ++i) {
+        out << (i > 0 ? "." : "") << falaise::packed_address(c.gid, i);
+      }
+      out << "] " << t0(rng) << " " << t0(rng) << " " << factor(rng) << " "
+          << 0.05 << "\n";
+    }
+  }
+  {
+    std::ifstream in{textFile};
+    falaise::write_cell_constants(binaryFile,
+                                  falaise::read_cell_constants_text(in));
+  }
+
+  double parse = falaise::bench::time_per_call([&] {
+    std::ifstream in{textFile};
+    falaise::cell_constants_table t{falaise::read_cell_constants_text(in)};
+    falaise::bench::do_not_optimize(t.matches(table));
+  });
+  double map = falaise::bench::time_per_call([&] {
+    auto t = falaise::cell_constants_table::map_file(binaryFile);
+    falaise::bench::do_not_optimize(t.matches(table));
+  });
+
+  std::printf("%zu cells\n", table.size());
+  std::printf("%12s %12.1f us\n", "parse text", parse / 1000);
+  std::printf("%12s %12.1f us\n", "map binary", map / 1000);
+
+  std::remove(textFile.c_str());
+  std::remove(binaryFile.c_str());
+  return 0;
+}
@@ -0,0 +1,98 @@
+#!/usr/bin/env python3
+"""Compare benchmark JSON results against a baseline, flagging regressions.
+
+Usage: compare_bench.py [--tolerance T] [--strict] BASELINE CURRENT
+
+BASELINE and CURRENT are each a JSON file written by a benchmark (see
+falaise::bench::results) or a directory of them. A measurement regresses if
+it is worse than its baseline by more than the fraction T (default 0.2),
+in the direction given by its "better" field. Measurements missing from
+either side, e.g. of a bench with no baseline recorded yet, are listed
+with a warning, and fail the comparison only if --strict is given.
+
+Exits with status 1 if any measurement regressed or, with --strict, is
+missing from either side.
+"""
+
+import argparse
+import json
+import os
+import sys
+
+
+def load(path):
+    """Return {(bench, name): result} of the JSON file(s) at path"""
+    if os.path.isdir(path):
+        files = [os.path.join(path, f) for f in sorted(os.listdir(path))
+                 if f.endswith(".json")]
+    else:
+        files = [path]
+
+    results = {}
+    for f in files:
+        with open(f) as stream:
+            data = json.load(stream)
+        for r in data["results"]:
+            results[(data["bench"], r["name"])] = r
+    return results
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--tolerance", type=float, default=0.2,
+                        help="fractional change allowed (default 0.2)")
+    parser.add_argument("--strict", action="store_true",
+                        help="fail on measurements missing from either "
+                        "side")
+    parser.add_argument("baseline", help="baseline JSON file or directory")
+    parser.add_argument("current", help="current JSON file or directory")
+    args = parser.parse_args()
+
+    baseline = load(args.baseline)
+    current = load(args.current)
+
+    regressions = 0
+    print("%-14s %-32s %12s %12s %8s" %
+          ("bench", "measurement", "baseline", "current", "change"))
+    for key in sorted(baseline.keys() & current.keys()):
+        base = baseline[key]
+        now = current[key]
+        if base["unit"] != now["unit"]:
+            print("%-14s %-32s unit changed from %s to %s" %
+                  (key + (base["unit"], now["unit"])))
+            continue
+
+        change = now["value"] / base["value"] - 1 if base["value"] else 0.0
+        worse = change if now["better"] == "lower" else -change
+        status = ""
+        if worse > args.tolerance:
+            status = "REGRESSION"
+            regressions += 1
+        elif worse < -args.tolerance:
+            status = "improved"
+        line = "%-14s %-32s %12.4g %12.4g %+7.1f%% %s" % (
+            key + (base["value"], now["value"], 100 * change, status))
+        print(line.rstrip())
+
+    missing = 0
+    for key in sorted(baseline.keys() - current.keys()):
+        print("%-14s %-32s WARNING: missing from current results" % key)
+        missing += 1
+    for key in sorted(current.keys() - baseline.keys()):
+        print("%-14s %-32s WARNING: has no baseline" % key)
+        missing += 1
+
+    failed = False
+    if regressions:
+        print("%d measurement(s) regressed by more than %g%%" %
+              (regressions, 100 * args.tolerance))
+        failed = True
+    if missing:
+        print("%d measurement(s) missing from one side, record baselines "
+              "with bench_baseline" % missing)
+        failed = failed or args.strict
+    return 1 if failed else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
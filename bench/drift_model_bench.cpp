@@ -0,0 +1,83 @@
+// Accuracy and cost per hit of drift_model tables of increasing size,
+// against evaluating the drift relation they tabulate directly.
+//
+// Usage: drift_model_bench [hits]
+//
+// The tabulated relation is MockTrackerCalibrator's default, which is cheap
+// to evaluate directly (one sqrt), so the table only wins against costlier
+// relations, e.g. fits with pow() or exp() terms; its cost does not depend
+// on the relation.
+#include "bench_util.h"
+#include "drift_model.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+  double const anodeVelocity{0.01}; // 1 cm/us in mm/ns
+  double const radiusScale{10.0};   // mm
+  double const maxRadius{35.0};     // mm
+
+  double
+  radius(double t)
+  {
+    return falaise::mock_drift_radius(t, anodeVelocity, radiusScale);
+  }
+
+  //! Largest error in radius over a fine grid of times in [0, max_time]
+  double
+  maxError(falaise::drift_model const& m)
+  {
+    double error{0.0};
+    for (int i = 0; i <= 100000; ++i) {
+      double t = m.max_time() * i / 100000;
+      error = std::max(error, std::abs(m.radius(t) - radius(t)));
+    }
+    return error;
+  }
+} // namespace
+
+int
+main(int argc, char* argv[])
+{
+  std::size_t nHits{argc > 1 ? std::stoul(argv[1]) : 4096};
+  double const maxTime =
+    falaise::mock_drift_time(maxRadius, anodeVelocity, radiusScale);
+
+  std::mt19937 rng{12345};
+  std::uniform_real_distribution<double> time{0.0, maxTime};
+  std::vector<double> times(nHits);
+  std::generate(times.begin(), times.end(), [&] { return time(rng); });
+  std::vector<double> radii(nHits);
+
+  falaise::bench::results results{"drift_model"};
+  std::printf("%zu hits, drift times in [0, %.0f] ns\n", nHits, maxTime);
+  std::printf("%10s %12s %14s\n", "points", "ns/hit", "max error/um");
+
+  double direct = falaise::bench::time_per_call([&] {
+    for (std::size_t i = 0; i < nHits; ++i) {
+      radii[i] = radius(times[i]);
+    }
+    falaise::bench::do_not_optimize(radii.data());
+  });
+  std::printf("%10s %12.2f %14s\n", "direct", direct / nHits, "-");
+  results.add("direct", direct / nHits, "ns/hit");
+
+  for (std::size_t n : {16, 64, 256, 1024, 4096, 16384, 65536}) {
+    falaise::drift_model m{radius, maxTime, n};
+    double tabulated = falaise::bench::time_per_call([&] {
+      m.radius(times.data(), radii.data(), nHits);
+      falaise::bench::do_not_optimize(radii.data());
+    });
+    std::printf(
+      "%10zu %12.2f %14.4f\n", n, tabulated / nHits, 1000.0 * maxError(m));
+    results.add(
+      "tabulated/points=" + std::to_string(n), tabulated / nHits, "ns/hit");
+  }
+  return results.write_if_requested() ? 0 : EXIT_FAILURE;
+}
@@ -0,0 +1,119 @@
+// Throughput of Geiger hit deduplication against step hit multiplicity,
+// comparing gid_index_map with a linear search of a std::list as a naive
+// implementation of the "update existing hit" rule would do.
+#include "bench_util.h"
+#include "gid_index_map.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <list>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+  struct StepHit {
+    std::uint64_t key;
+    double time;
+  };
+
+  struct RawHit {
+    std::uint64_t key;
+    double time;
+  };
+
+  //! Step hits along tracks, so several hits fall in each fired cell
+  std::vector<StepHit>
+  makeStepHits(std::size_t n, std::mt19937& rng)
+  {
+    std::uniform_int_distribution<std::uint64_t> side{0, 1};
+    std::uniform_int_distribution<std::uint64_t> layer{0, 8};
+    std::uniform_int_distribution<std::uint64_t> row{0, 112};
+    std::uniform_int_distribution<int> hitsPerCell{1, 4};
+    std::uniform_real_distribution<double> time{0.0, 4000.0};
+
+    std::vector<StepHit> hits;
+    while (hits.size() < n) {
+      // Pack as [1204:0.side.layer.row] would be by pack_geom_id
+      std::uint64_t key = (1204ULL << 48) | (side(rng) << 32) |
+                          (layer(rng) << 24) | (row(rng) << 8) | 4;
+      for (int i = hitsPerCell(rng); i > 0 && hits.size() < n; --i) {
+        hits.push_back({key, time(rng)});
+      }
+    }
+    std::shuffle(hits.begin(), hits.end(), rng);
+    return hits;
+  }
+
+  std::size_t
+  dedupeWithList(std::vector<StepHit> const& steps)
+  {
+    std::list<RawHit> output;
+    for (auto const& s : steps) {
+      auto iter = std::find_if(output.begin(), output.end(), [&](RawHit& r) {
+        return r.key == s.key;
+      });
+      if (iter == output.end()) {
+        output.push_back({s.key, s.time});
+      }
+      else if (s.time < iter->time) {
+        iter->time = s.time;
+      }
+    }
+    return output.size();
+  }
+
+  std::size_t
+  dedupeWithMap(std::vector<StepHit> const& steps,
+                falaise::gid_index_map& index,
+                std::vector<RawHit>& output)
+  {
+    index.clear();
+    output.clear();
+    for (auto const& s : steps) {
+      auto slot = index.try_emplace(s.key, output.size());
+      if (slot.second) {
+        output.push_back({s.key, s.time});
+      }
+      else if (s.time < output[*slot.first].time) {
+        output[*slot.first].time = s.time;
+      }
+    }
+    return output.size();
+  }
+} // namespace
+
+int
+main()
+{
+  std::mt19937 rng{12345};
+  falaise::gid_index_map index;
+  std::vector<RawHit> output;
+
+  falaise::bench::results results{"gid_index_map"};
+  std::printf("%10s %12s %12s %12s %12s\n",
+              "step_hits",
+              "list_ns/hit",
+              "map_ns/hit",
+              "list_Mhit/s",
+              "map_Mhit/s");
+  for (std::size_t n : {16, 64, 128, 256, 512, 1024, 2048}) {
+    auto steps = makeStepHits(n, rng);
+    double listTime = falaise::bench::time_per_call(
+      [&] { falaise::bench::do_not_optimize(dedupeWithList(steps)); });
+    double mapTime = falaise::bench::time_per_call([&] {
+      falaise::bench::do_not_optimize(dedupeWithMap(steps, index, output));
+    });
+    std::printf("%10zu %12.2f %12.2f %12.2f %12.2f\n",
+                n,
+                listTime / n,
+                mapTime / n,
+                1e3 * n / listTime,
+                1e3 * n / mapTime);
+    results.add("list/hits=" + std::to_string(n), listTime / n, "ns/hit");
+    results.add("map/hits=" + std::to_string(n), mapTime / n, "ns/hit");
+  }
+  return results.write_if_requested() ? 0 : EXIT_FAILURE;
+}
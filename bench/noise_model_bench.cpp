@@ -0,0 +1,58 @@
+// Cost per event of drawing noise hits in a full tracker (2 x 9 x 113
+// cells), testing every cell against its probability of firing versus
+// sampling the number of hits then their cells from a noise_model.
+//
+// Usage: noise_model_bench
+#include "bench_util.h"
+#include "noise_model.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+int
+main()
+{
+  std::size_t const nCells{2 * 9 * 113};
+  double const window{5000.0}; // ns
+  auto rng = falaise::make_random_stream("philox4x32");
+  std::vector<double> draws(nCells);
+  std::vector<std::uint32_t> hits;
+  hits.reserve(nCells);
+
+  falaise::bench::results results{"noise_model"};
+  std::printf(
+    "%12s %16s %16s\n", "hits/event", "per cell (ns)", "sampled (ns)");
+  for (double meanHits : {0.1, 1.0, 10.0, 100.0}) {
+    double const rate = meanHits / (window * nCells);
+    falaise::noise_model noise{std::vector<double>(nCells, rate), window};
+    double const p = rate * window;
+
+    double perCell = falaise::bench::time_per_call([&] {
+      hits.clear();
+      rng->fill_uniform(draws.data(), nCells);
+      for (std::uint32_t i = 0; i < nCells; ++i) {
+        if (draws[i] < p) {
+          hits.push_back(i);
+        }
+      }
+      falaise::bench::do_not_optimize(hits.data());
+    });
+    double sampled = falaise::bench::time_per_call([&] {
+      hits.clear();
+      std::size_t const n = noise.count(*rng);
+      for (std::size_t i = 0; i < n; ++i) {
+        hits.push_back(noise.cell(rng->uniform()));
+      }
+      falaise::bench::do_not_optimize(hits.data());
+    });
+    std::printf("%12.1f %16.1f %16.1f\n", meanHits, perCell, sampled);
+    char name[32];
+    std::snprintf(name, sizeof(name), "per_cell/hits=%g", meanHits);
+    results.add(name, perCell, "ns/event");
+    std::snprintf(name, sizeof(name), "sampled/hits=%g", meanHits);
+    results.add(name, sampled, "ns/event");
+  }
+  return results.write_if_requested() ? 0 : EXIT_FAILURE;
+}
@@ -0,0 +1,93 @@
+// Throughput of a MockTrackerCalibrator pipeline run by parallel_pipeline,
+// in events/s, for 1 to N worker threads.
+//
+// Usage: parallel_pipeline_bench [max workers] [events] [hits per event]
+//
+// Events are generated before each run, so the timing covers reading,
+// processing and ordered writing (to a null sink) only.
+#include "parallel_pipeline.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "bayeux/datatools/library_loader.h"
+#include "bayeux/datatools/multi_properties.h"
+#include "falaise/falaise.h"
+
+#include "synthetic_events.h"
+
+namespace {
+  using event_ptr = falaise::parallel_pipeline::event_ptr;
+} // namespace
+
+int
+main(int argc, char* argv[])
+{
+  unsigned int maxWorkers{std::max(
+    1u,
+    argc > 1 ? static_cast<unsigned int>(std::atoi(argv[1])) :
+               std::thread::hardware_concurrency())};
+  std::size_t nEvents{argc > 2 ? std::stoul(argv[2]) : 5000};
+  std::size_t nHits{argc > 3 ? std::stoul(argv[3]) : 200};
+
+  FALAISE_INIT();
+  datatools::library_loader loader;
+  if (loader.load("MockTrackerCalibrator", MOCKTRACKERCALIBRATOR_DIR) != 0) {
+    std::fprintf(stderr, "cannot load MockTrackerCalibrator plugin\n");
+    return EXIT_FAILURE;
+  }
+
+  falaise::demonstrator_geometry geometry;
+
+  // As MockTrackerCalibrator.conf, without the dump module
+  datatools::multi_properties config{"name", "type"};
+  datatools::properties chain;
+  chain.store("modules", std::vector<std::string>{"calibrator"});
+  config.add("pipeline", "dpp::chain_module", chain);
+  config.add("calibrator", "MockTrackerCalibrator", datatools::properties{});
+
+  falaise::step_hit_generator::parameters p;
+  p.hits = nHits;
+  falaise::step_hit_generator generator{geometry.cells, p};
+
+  std::printf("%zu events, %zu hits/event\n", nEvents, nHits);
+  std::printf("%8s %12s %10s\n", "workers", "events/s", "speedup");
+  // 1, 2, 3, 4, 8, 16, ... and maxWorkers
+  std::vector<unsigned int> workerCounts;
+  for (unsigned int w = 1; w < maxWorkers; w = (w < 4 ? w + 1 : 2 * w)) {
+    workerCounts.push_back(w);
+  }
+  workerCounts.push_back(maxWorkers);
+
+  double serialRate{0.0};
+  for (unsigned int w : workerCounts) {
+    falaise::parallel_pipeline::options opts;
+    opts.workers = w;
+    falaise::parallel_pipeline pipeline{config, geometry.services, opts};
+
+    auto events = falaise::make_synthetic_events(generator, nEvents);
+    std::size_t next{0};
+    auto source = [&events, &next]() -> event_ptr {
+      return next < events.size() ? std::move(events[next++]) : nullptr;
+    };
+
+    auto start = std::chrono::steady_clock::now();
+    auto stats = pipeline.run(source, [](datatools::things&) {});
+    std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - start;
+
+    double rate = stats.written / elapsed.count();
+    if (serialRate == 0.0) {
+      serialRate = rate;
+    }
+    std::printf("%8u %12.0f %10.2f\n", w, rate, rate / serialRate);
+  }
+
+  FALAISE_FINI();
+  return 0;
+}
@@ -0,0 +1,70 @@
+// Cost of looking up values in a property_set of typical module
+// configuration size, versus fetching them from the datatools::properties
+// it wraps.
+//
+// Usage: property_set_bench
+#include "bench_util.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+#include "bayeux/datatools/properties.h"
+#include "property_set.h"
+
+namespace {
+  //! Print and record the time per call of f as measurement name
+  template <typename F>
+  void
+  measure(falaise::bench::results& results, char const* name, F&& f)
+  {
+    double const ns = falaise::bench::time_per_call(f);
+    std::printf("%24s %10.1f\n", name, ns);
+    results.add(name, ns, "ns/call");
+  }
+} // namespace
+
+int
+main()
+{
+  // Enough keys that lookup is not trivially a first match
+  datatools::properties config;
+  for (int i = 0; i < 24; ++i) {
+    config.store("filler." + std::to_string(i), i);
+  }
+  config.store("count", 42);
+  config.store("fraction", 0.25);
+  config.store("name", std::string{"calibrator"});
+  config.store("enabled", true);
+  falaise::property_set ps{config};
+  ps.put("length", falaise::units::length_t{3.0, "mm"});
+
+  falaise::bench::results results{"property_set"};
+  std::printf("%24s %10s\n", "lookup", "ns/call");
+  measure(results, "properties_fetch_integer", [&] {
+    falaise::bench::do_not_optimize(config.fetch_integer("count"));
+  });
+  measure(results, "has_key", [&] {
+    falaise::bench::do_not_optimize(ps.has_key("count"));
+  });
+  measure(results, "get_int", [&] {
+    falaise::bench::do_not_optimize(ps.get<int>("count"));
+  });
+  measure(results, "get_double", [&] {
+    falaise::bench::do_not_optimize(ps.get<double>("fraction"));
+  });
+  measure(results, "get_bool", [&] {
+    falaise::bench::do_not_optimize(ps.get<bool>("enabled"));
+  });
+  measure(results, "get_string", [&] {
+    falaise::bench::do_not_optimize(ps.get<std::string>("name").size());
+  });
+  measure(results, "get_quantity", [&] {
+    falaise::bench::do_not_optimize(
+      double(ps.get<falaise::units::length_t>("length")));
+  });
+  measure(results, "get_default_missing", [&] {
+    falaise::bench::do_not_optimize(ps.get<int>("missing", 1));
+  });
+  return results.write_if_requested() ? 0 : EXIT_FAILURE;
+}
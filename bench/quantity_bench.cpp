@@ -0,0 +1,54 @@
+// Cost of constructing and converting falaise::units quantities, each
+// construction looking up its unit by name, versus plain CLHEP arithmetic.
+//
+// Usage: quantity_bench
+#include "bench_util.h"
+
+#include <cstdio>
+#include <cstdlib>
+
+#include "bayeux/datatools/clhep_units.h"
+#include "bayeux/datatools/units.h"
+#include "quantity.h"
+
+namespace {
+  //! Print and record the time per call of f as measurement name
+  template <typename F>
+  void
+  measure(falaise::bench::results& results, char const* name, F&& f)
+  {
+    double const ns = falaise::bench::time_per_call(f);
+    std::printf("%24s %10.1f\n", name, ns);
+    results.add(name, ns, "ns/call");
+  }
+} // namespace
+
+int
+main()
+{
+  falaise::units::length_t const length{3.0, "mm"};
+  auto const& cm =
+    datatools::units::registry::const_system_registry().get_unit("cm");
+  double value{3.0};
+
+  falaise::bench::results results{"quantity"};
+  std::printf("%24s %10s\n", "operation", "ns/call");
+  measure(results, "clhep_multiply", [&] {
+    falaise::bench::do_not_optimize(value * CLHEP::mm);
+  });
+  measure(results, "construct_quantity", [&] {
+    falaise::units::quantity q{value, "mm"};
+    falaise::bench::do_not_optimize(q.value());
+  });
+  measure(results, "construct_length", [&] {
+    falaise::units::length_t q{value, "mm"};
+    falaise::bench::do_not_optimize(q.value());
+  });
+  measure(results, "to_clhep", [&] {
+    falaise::bench::do_not_optimize(double(length));
+  });
+  measure(results, "value_in", [&] {
+    falaise::bench::do_not_optimize(length.value_in(cm));
+  });
+  return results.write_if_requested() ? 0 : EXIT_FAILURE;
+}
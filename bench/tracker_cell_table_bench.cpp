@@ -0,0 +1,102 @@
+// Cost of per-hit Geiger cell geometry access, comparing tracker_cell_table
+// lookups with the geometry manager queries (geom_info lookup, placement
+// transform, shape) they replace in MockTrackerCalibrator.
+//
+// Usage: tracker_cell_table_bench [geometry manager config]
+#include "bench_util.h"
+#include "tracker_cell_table.h"
+
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "bayeux/datatools/properties.h"
+#include "bayeux/datatools/utils.h"
+#include "bayeux/geomtools/box.h"
+#include "bayeux/geomtools/manager.h"
+#include "falaise/falaise.h"
+
+namespace {
+  struct Hit {
+    geomtools::geom_id gid;
+    std::uint64_t key;
+    geomtools::vector_3d position;
+  };
+
+  //! Geometry manager queries for drift distance and cell length
+  double
+  viaGeometryManager(geomtools::manager const& geo,
+                     std::vector<Hit> const& hits)
+  {
+    double sum{0.0};
+    for (auto const& h : hits) {
+      auto const& info = geo.get_mapping().get_geom_info(h.gid);
+      geomtools::vector_3d local;
+      info.get_world_placement().mother_to_child(h.position, local);
+      auto const& shape =
+        dynamic_cast<geomtools::box const&>(info.get_logical().get_shape());
+      sum += std::hypot(local.x(), local.y()) + shape.get_z();
+    }
+    return sum;
+  }
+
+  //! Table lookups for drift distance and cell length
+  double
+  viaCellTable(falaise::tracker_cell_table const& table,
+               std::vector<Hit> const& hits)
+  {
+    double sum{0.0};
+    for (auto const& h : hits) {
+      auto const& cell = table[table.index(h.key)];
+      sum += std::hypot(h.position.x() - cell.anode_x,
+                        h.position.y() - cell.anode_y) +
+             cell.length;
+    }
+    return sum;
+  }
+} // namespace
+
+int
+main(int argc, char* argv[])
+{
+  FALAISE_INIT();
+  std::string config{
+    argc > 1 ? argv[1] :
+               "@falaise:config/snemo/demonstrator/geometry/4.0/manager.conf"};
+  datatools::fetch_path_with_env(config);
+  datatools::properties geoConfig;
+  datatools::properties::read_config(config, geoConfig);
+  geomtools::manager geo;
+  geo.initialize(geoConfig);
+
+  auto table = falaise::make_tracker_cell_table(geo, "drift_cell_core");
+  std::printf("tabulated %zu cells\n", table.size());
+
+  // Ionization points within 22mm of the anode of random cells
+  std::mt19937 rng{12345};
+  std::uniform_int_distribution<std::uint32_t> cellIndex(0, table.size() - 1);
+  std::uniform_real_distribution<double> offset{-15.0, 15.0};
+  std::vector<Hit> hits;
+  for (int i = 0; i < 1000; ++i) {
+    auto key = table.gid(cellIndex(rng));
+    auto const& cell = table[table.index(key)];
+    geomtools::vector_3d pos{cell.anode_x + offset(rng),
+                             cell.anode_y + offset(rng),
+                             0.5 * (cell.z_min + cell.z_max)};
+    hits.push_back({falaise::unpack_geom_id(key), key, pos});
+  }
+
+  double geoTime = falaise::bench::time_per_call(
+    [&] { falaise::bench::do_not_optimize(viaGeometryManager(geo, hits)); });
+  double tableTime = falaise::bench::time_per_call(
+    [&] { falaise::bench::do_not_optimize(viaCellTable(table, hits)); });
+
+  std::printf("%20s %12s\n", "method", "ns/hit");
+  std::printf("%20s %12.2f\n", "geometry_manager", geoTime / hits.size());
+  std::printf("%20s %12.2f\n", "tracker_cell_table", tableTime / hits.size());
+
+  FALAISE_FINI();
+  return 0;
+}
@@ -0,0 +1,137 @@
+// Throughput of emulating a tracker trigger with tracker_trigger on a full
+// tracker (2 x 9 x 113 cells), versus scanning the fired cells of each
+// zone, for noise-like events of random cells and for track-like events of
+// one cell per layer, at increasing occupancy.
+//
+// Usage: tracker_trigger_bench
+#include "bench_util.h"
+#include "packed_geom_id.h"
+#include "tracker_trigger.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+  using condition = falaise::tracker_trigger::condition;
+
+  constexpr std::uint32_t sides = 2;
+  constexpr std::uint32_t layers = 9;
+  constexpr std::uint32_t rows = 113;
+  constexpr std::uint32_t zoneRows = 16;
+  constexpr std::uint32_t zoneStride = 8;
+
+  //! Return the conditions met by gids, scanning them for each zone
+  std::uint32_t
+  scanTrigger(std::vector<std::uint64_t> const& gids,
+              std::vector<condition> const& conditions)
+  {
+    std::uint32_t met{0};
+    for (std::size_t c = 0; c < conditions.size(); ++c) {
+      std::uint32_t sidesMet{0};
+      for (std::uint32_t side = 0; side < sides; ++side) {
+        bool any{false};
+        for (std::uint32_t start = 0; !any; start += zoneStride) {
+          std::uint32_t const first = std::min(start, rows - zoneRows);
+          std::uint32_t fired{0};
+          for (auto g : gids) {
+            std::uint32_t const row = falaise::packed_address(g, 3);
+            if (falaise::packed_address(g, 1) == side && row >= first &&
+                row < first + zoneRows) {
+              fired |= 1u << falaise::packed_address(g, 2);
+            }
+          }
+          any = static_cast<std::uint32_t>(__builtin_popcount(fired)) >=
+                  conditions[c].min_layers &&
+                (fired & conditions[c].required_layers) ==
+                  conditions[c].required_layers;
+          if (first + zoneRows >= rows) {
+            break;
+          }
+        }
+        sidesMet += any;
+      }
+      if (sidesMet >= conditions[c].sides) {
+        met |= 1u << c;
+      }
+    }
+    return met;
+  }
+} // namespace
+
+int
+main()
+{
+  // Majority of layers on one side, on both, and first and last layers
+  std::vector<condition> const conditions = {
+    {6, 0, 1}, {3, 0, 2}, {0, 0x101, 1}};
+  falaise::tracker_trigger trigger{
+    sides, layers, rows, zoneRows, zoneStride, conditions};
+
+  std::mt19937 rng{12345};
+  std::uniform_int_distribution<std::uint32_t> side{0, 1};
+  std::uniform_int_distribution<std::uint32_t> layer{0, layers - 1};
+  std::uniform_int_distribution<std::uint32_t> row{0, rows - 1};
+  std::uniform_int_distribution<int> step{-1, 1};
+  auto randomCells = [&](std::size_t n) {
+    std::vector<std::uint64_t> gids(n);
+    for (auto& g : gids) {
+      g = falaise::pack_geom_id({1204, 0, side(rng), layer(rng), row(rng)});
+    }
+    return gids;
+  };
+  auto trackCells = [&](std::size_t n) {
+    std::vector<std::uint64_t> gids;
+    while (gids.size() < n) {
+      std::uint32_t const s = side(rng);
+      int r = row(rng);
+      for (std::uint32_t l = 0; l < layers && gids.size() < n; ++l) {
+        r = std::min(std::max(r + step(rng), 0), static_cast<int>(rows) - 1);
+        gids.push_back(falaise::pack_geom_id(
+          {1204, 0, s, l, static_cast<std::uint32_t>(r)}));
+      }
+    }
+    return gids;
+  };
+
+  falaise::bench::results results{"tracker_trigger"};
+  std::printf("%8s %8s %12s %12s %14s\n",
+              "events",
+              "cells",
+              "scan (ns)",
+              "masks (ns)",
+              "masks (ev/s)");
+  for (std::string pattern : {"noise", "tracks"}) {
+    for (std::size_t n : {9, 36, 180}) {
+      // Enough events that they do not all stay in the branch predictor
+      std::vector<std::vector<std::uint64_t>> events(256);
+      for (auto& e : events) {
+        e = pattern == "noise" ? randomCells(n) : trackCells(n);
+      }
+
+      std::size_t i{0};
+      double scan = falaise::bench::time_per_call([&] {
+        falaise::bench::do_not_optimize(
+          scanTrigger(events[i++ % events.size()], conditions));
+      });
+      double masks = falaise::bench::time_per_call([&] {
+        auto const& e = events[i++ % events.size()];
+        falaise::bench::do_not_optimize(trigger.evaluate(e.data(), e.size()));
+      });
+      std::printf("%8s %8zu %12.0f %12.0f %14.3g\n",
+                  pattern.c_str(),
+                  n,
+                  scan,
+                  masks,
+                  1e9 / masks);
+      auto const tag = pattern + "/cells=" + std::to_string(n);
+      results.add("scan/" + tag, scan, "ns/event");
+      results.add("masks/" + tag, masks, "ns/event");
+      results.add("masks/" + tag + "/rate", 1e9 / masks, "events/s", true);
+    }
+  }
+  return results.write_if_requested() ? 0 : EXIT_FAILURE;
+}
@@ -0,0 +1,113 @@
+#include "cell_adjacency.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <tuple>
+#include <utility>
+
+#include "bayeux/geomtools/manager.h"
+
+#include "packed_geom_id.h"
+
+namespace falaise {
+  namespace {
+    //! Return the key of the plane of layers and rows holding a cell
+    std::uint64_t
+    plane_of(std::uint64_t gid)
+    {
+      std::uint32_t const depth = packed_depth(gid);
+      std::uint64_t plane = packed_type(gid);
+      for (std::uint32_t d = 0; d + 2 < depth; ++d) {
+        plane = plane << 8 | packed_address(gid, d);
+      }
+      return plane;
+    }
+
+    double
+    anode_distance(tracker_cell_table::cell const& a,
+                   tracker_cell_table::cell const& b)
+    {
+      return std::hypot(a.anode_x - b.anode_x, a.anode_y - b.anode_y);
+    }
+  } // namespace
+
+  cell_adjacency::cell_adjacency(tracker_cell_table const& cells,
+                                 double max_distance)
+    : offsets_(cells.size() + 1, 0)
+  {
+    // Trackers are a few thousand cells, and this is done once, so compare
+    // all pairs in a plane
+    std::vector<std::uint64_t> planes(cells.size());
+    for (std::uint32_t i = 0; i < cells.size(); ++i) {
+      planes[i] = plane_of(cells.gid(i));
+    }
+    for (std::uint32_t i = 0; i < cells.size(); ++i) {
+      for (std::uint32_t j = 0; j < cells.size(); ++j) {
+        if (j != i && planes[j] == planes[i] &&
+            anode_distance(cells[i], cells[j]) <= max_distance) {
+          neighbours_.push_back(j);
+        }
+      }
+      offsets_[i + 1] = neighbours_.size();
+    }
+    neighbours_.shrink_to_fit();
+  }
+
+  bool
+  cell_adjacency::are_neighbours(std::uint32_t i, std::uint32_t j) const
+  {
+    auto const n = neighbours(i);
+    return std::binary_search(n.begin(), n.end(), j);
+  }
+
+  double
+  anode_pitch(tracker_cell_table const& cells)
+  {
+    if (cells.size() < 2) {
+      return 0.0;
+    }
+    double pitch = std::numeric_limits<double>::infinity();
+    for (std::uint32_t i = 0; i < cells.size(); ++i) {
+      for (std::uint32_t j = i + 1; j < cells.size(); ++j) {
+        pitch = std::min(pitch, anode_distance(cells[i], cells[j]));
+      }
+    }
+    return pitch;
+  }
+
+  std::shared_ptr<tracker_cells const>
+  shared_tracker_cells(geomtools::manager const& geo,
+                       std::string const& category)
+  {
+    auto build = [&geo, &category] {
+      auto table = make_tracker_cell_table(geo, category);
+      cell_adjacency adjacency{table, 1.5 * anode_pitch(table)};
+      return std::make_shared<tracker_cells const>(
+        tracker_cells{std::move(table), std::move(adjacency)});
+    };
+    std::string const& label = geo.get_setup_label();
+    if (label.empty()) {
+      return build();
+    }
+
+    // Build under the lock, so concurrent first callers build only once
+    using key = std::tuple<std::string, std::string, std::string>;
+    static std::mutex mutex;
+    static std::map<key, std::weak_ptr<tracker_cells const>> shared;
+    std::lock_guard<std::mutex> lock{mutex};
+    for (auto i = shared.begin(); i != shared.end();) {
+      i = i->second.expired() ? shared.erase(i) : std::next(i);
+    }
+    auto& entry = shared[key{label, geo.get_setup_version(), category}];
+    auto cells = entry.lock();
+    if (!cells) {
+      cells = build();
+      entry = cells;
+    }
+    return cells;
+  }
+} /* falaise */
@@ -0,0 +1,101 @@
+#ifndef FALAISE_CELL_ADJACENCY_H
+#define FALAISE_CELL_ADJACENCY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "input_view.h"
+#include "tracker_cell_table.h"
+
+namespace geomtools {
+  class manager;
+}
+
+namespace falaise {
+  //! Neighbours of each cell of a tracker_cell_table, by dense cell index
+  /*
+   * Two cells are neighbours if they share all but their last two geom_id
+   * addresses, so are in the same plane of layers and rows (e.g. the same
+   * module and side for cells [module.side.layer.row]), and their anode
+   * wires are at most a given distance apart in the xy plane.
+   *
+   * Held in compressed sparse row form: the neighbours of all cells in one
+   * array, those of cell i, in increasing index order, from offset i to
+   * offset i + 1. A full tracker is a few tens of kB, so is built once and
+   * shared, see shared_tracker_cells().
+   */
+  class cell_adjacency {
+  public:
+    //! Construct the adjacency of no cells
+    cell_adjacency() = default;
+
+    //! Construct the adjacency of cells with anodes within max_distance
+    cell_adjacency(tracker_cell_table const& cells, double max_distance);
+
+    //! Return the number of cells
+    std::size_t
+    size() const
+    {
+      return offsets_.empty() ? 0 : offsets_.size() - 1;
+    }
+
+    //! Return the number of neighbours of cell i
+    std::size_t
+    degree(std::uint32_t i) const
+    {
+      return offsets_[i + 1] - offsets_[i];
+    }
+
+    //! Return the indices of the neighbours of cell i, in increasing order
+    input_view<std::uint32_t>
+    neighbours(std::uint32_t i) const
+    {
+      return {neighbours_.data() + offsets_[i], degree(i)};
+    }
+
+    //! Return true if cells i and j are neighbours
+    bool are_neighbours(std::uint32_t i, std::uint32_t j) const;
+
+  private:
+    std::vector<std::uint32_t> offsets_;    //< first neighbour of each cell
+    std::vector<std::uint32_t> neighbours_; //< neighbours of all cells
+  };
+
+  //! Return the smallest xy distance between the anodes of any two cells
+  /*
+   * The wire pitch for a regular grid of cells, or zero if there are fewer
+   * than two cells
+   */
+  double anode_pitch(tracker_cell_table const& cells);
+
+  //! Cells of a geometry category and their adjacency
+  struct tracker_cells {
+    tracker_cell_table table; //< cells, by dense index
+    cell_adjacency adjacency; //< ... and their neighbours, up to diagonals
+  };
+
+  //! Return the cells of category in geo, shared by all callers
+  /*
+   * Cells are tabulated and their adjacency built, with neighbours up to
+   * 1.5 anode pitches apart so that diagonal neighbours in a square grid
+   * are included, on the first call for geo and category. Later calls,
+   * from any module or thread, return the same tables for as long as any
+   * caller holds them, so modules needing cells of the same geometry share
+   * one copy rather than each building its own.
+   *
+   * Geometries are identified by their setup label and version, so
+   * managers of the same setup share tables, which are built once for as
+   * long as they are held. A geometry without a setup label cannot be
+   * identified, and gets its own tables on each call.
+   *
+   * \throw as make_tracker_cell_table
+   */
+  std::shared_ptr<tracker_cells const> shared_tracker_cells(
+    geomtools::manager const& geo,
+    std::string const& category);
+} /* falaise */
+
+#endif /* FALAISE_CELL_ADJACENCY_H */
@@ -0,0 +1,157 @@
+#include "cell_clusterer.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+#include "packed_geom_id.h"
+
+namespace falaise {
+  cell_clusterer::cell_clusterer(std::uint32_t sides,
+                                 std::uint32_t layers,
+                                 std::uint32_t rows)
+    : sides_(sides)
+    , layers_(layers)
+    , rows_(rows)
+    , words_((rows + 63) / 64)
+    , bitmap_(sides * layers * words_, 0)
+    , offset_(sides * layers + 1, 0)
+  {}
+
+  std::size_t
+  cell_clusterer::cluster(std::uint64_t const* gids,
+                          std::size_t n,
+                          std::uint32_t* clusters)
+  {
+    // Check all cells first, so a bad one leaves the bitmap clear
+    for (std::size_t i = 0; i < n; ++i) {
+      if (packed_address(gids[i], 1) >= sides_ ||
+          packed_address(gids[i], 2) >= layers_ ||
+          packed_address(gids[i], 3) >= rows_) {
+        throw std::out_of_range("cell outside clusterer's layers and rows");
+      }
+    }
+    for (std::size_t i = 0; i < n; ++i) {
+      std::uint32_t const row = packed_address(gids[i], 3);
+      std::size_t const layer =
+        packed_address(gids[i], 1) * layers_ + packed_address(gids[i], 2);
+      bitmap_[layer * words_ + row / 64] |= std::uint64_t{1} << (row % 64);
+    }
+
+    runs_.clear();
+    for (std::size_t layer = 0; layer < offset_.size() - 1; ++layer) {
+      offset_[layer] = runs_.size();
+      find_runs_(layer * words_);
+    }
+    offset_.back() = runs_.size();
+
+    parent_.resize(runs_.size());
+    for (std::uint32_t r = 0; r < parent_.size(); ++r) {
+      parent_[r] = r;
+    }
+    for (std::uint32_t side = 0; side < sides_; ++side) {
+      for (std::uint32_t layer = 1; layer < layers_; ++layer) {
+        std::size_t const l = side * layers_ + layer;
+        join_layers_(offset_[l - 1], offset_[l], offset_[l], offset_[l + 1]);
+      }
+    }
+
+    // Roots are the first runs of their clusters, so number them in order
+    label_.resize(runs_.size());
+    std::uint32_t nClusters{0};
+    for (std::uint32_t r = 0; r < runs_.size(); ++r) {
+      std::uint32_t const root = find_(r);
+      label_[r] = root == r ? nClusters++ : label_[root];
+    }
+
+    for (std::size_t i = 0; i < n; ++i) {
+      std::uint32_t const row = packed_address(gids[i], 3);
+      std::size_t const layer =
+        packed_address(gids[i], 1) * layers_ + packed_address(gids[i], 2);
+      clusters[i] = label_[run_of_(layer, row)];
+      bitmap_[layer * words_ + row / 64] = 0;
+    }
+    return nClusters;
+  }
+
+  void
+  cell_clusterer::find_runs_(std::size_t w)
+  {
+    // A run starts at a set bit whose lower neighbour is clear, and ends at
+    // one whose upper neighbour is clear, carrying across words
+    std::uint64_t const* words = bitmap_.data() + w;
+    std::size_t closing = runs_.size();
+    for (std::size_t k = 0; k < words_; ++k) {
+      std::uint64_t const bits = words[k];
+      if (bits == 0) {
+        continue;
+      }
+      std::uint64_t const below = k > 0 ? words[k - 1] >> 63 : 0;
+      std::uint64_t const above = k + 1 < words_ ? words[k + 1] << 63 : 0;
+      std::uint64_t starts = bits & ~(bits << 1 | below);
+      std::uint64_t ends = bits & ~(bits >> 1 | above);
+      std::uint32_t const base = 64 * k;
+      while (starts != 0) {
+        std::uint32_t const row = base + __builtin_ctzll(starts);
+        runs_.push_back({row, row});
+        starts &= starts - 1;
+      }
+      while (ends != 0) {
+        runs_[closing++].last = base + __builtin_ctzll(ends);
+        ends &= ends - 1;
+      }
+    }
+  }
+
+  void
+  cell_clusterer::join_layers_(std::size_t a,
+                               std::size_t a_end,
+                               std::size_t b,
+                               std::size_t b_end)
+  {
+    // Runs touch if they overlap once one is widened by a row each way
+    while (a < a_end && b < b_end) {
+      run_ const& ra = runs_[a];
+      run_ const& rb = runs_[b];
+      if (ra.first <= rb.last + 1 && rb.first <= ra.last + 1) {
+        std::uint32_t const x = find_(a);
+        std::uint32_t const y = find_(b);
+        // The earlier run stays root, so roots are first runs of clusters
+        if (x < y) {
+          parent_[y] = x;
+        }
+        else {
+          parent_[x] = y;
+        }
+      }
+      if (ra.last < rb.last) {
+        ++a;
+      }
+      else {
+        ++b;
+      }
+    }
+  }
+
+  std::uint32_t
+  cell_clusterer::find_(std::uint32_t r)
+  {
+    while (parent_[r] != r) {
+      parent_[r] = parent_[parent_[r]];
+      r = parent_[r];
+    }
+    return r;
+  }
+
+  std::uint32_t
+  cell_clusterer::run_of_(std::size_t layer, std::uint32_t row) const
+  {
+    // Last run of the layer starting at or before row
+    auto first = runs_.begin() + offset_[layer];
+    auto last = runs_.begin() + offset_[layer + 1];
+    auto after = std::upper_bound(
+      first, last, row, [](std::uint32_t r, run_ const& x) {
+        return r < x.first;
+      });
+    return static_cast<std::uint32_t>(after - runs_.begin()) - 1;
+  }
+} /* falaise */
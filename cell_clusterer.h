@@ -0,0 +1,102 @@
+#ifndef FALAISE_CELL_CLUSTERER_H
+#define FALAISE_CELL_CLUSTERER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace falaise {
+  //! Clusters of adjacent fired Geiger cells
+  /*
+   * Cells are addressed [module.side.layer.row], as packed geom_ids (see
+   * pack_geom_id), and two cells are adjacent if they are on the same side
+   * and differ by at most one in both layer and row, so diagonally too.
+   *
+   * Fired cells are set in an occupancy bitmap of each layer of each side,
+   * one bit per row. Each layer's runs of consecutive fired rows are found
+   * a word at a time from the bitmap, and become the nodes of a union-find,
+   * so cells in a run are joined without looking at them singly. Runs in
+   * neighbouring layers that touch are then joined in one merge-like pass
+   * over the two layers' runs.
+   *
+   * Clusters are numbered from 0 in order of their first cell by (side,
+   * layer, row), so numbers do not depend on the order of the input cells.
+   *
+   * Holds its working storage, so is not thread safe: use one clusterer
+   * per thread, e.g. from an object_pool. Once storage has grown to the
+   * largest event, clustering makes no heap allocations.
+   */
+  class cell_clusterer {
+  public:
+    //! Construct a clusterer of no cells
+    cell_clusterer() = default;
+
+    //! Construct a clusterer of cells in sides x layers x rows
+    cell_clusterer(std::uint32_t sides,
+                   std::uint32_t layers,
+                   std::uint32_t rows);
+
+    std::uint32_t
+    sides() const
+    {
+      return sides_;
+    }
+
+    std::uint32_t
+    layers() const
+    {
+      return layers_;
+    }
+
+    std::uint32_t
+    rows() const
+    {
+      return rows_;
+    }
+
+    //! Set clusters[i] to the cluster of the cell of gids[i], for i < n
+    /*
+     * Cells may be repeated, and are then in the same cluster.
+     *
+     * \returns the number of clusters
+     * \throw std::out_of_range if a cell is outside sides x layers x rows
+     */
+    std::size_t cluster(std::uint64_t const* gids,
+                        std::size_t n,
+                        std::uint32_t* clusters);
+
+  private:
+    //! Consecutive fired rows [first, last] of a layer
+    struct run_ {
+      std::uint32_t first;
+      std::uint32_t last;
+    };
+
+    //! Append the runs of the layer at bitmap word w, in order of row
+    void find_runs_(std::size_t w);
+
+    //! Join the runs [a, a_end) and [b, b_end) of neighbouring layers
+    void join_layers_(std::size_t a,
+                      std::size_t a_end,
+                      std::size_t b,
+                      std::size_t b_end);
+
+    //! Return the root of run r, halving its path
+    std::uint32_t find_(std::uint32_t r);
+
+    //! Return the index of the run holding row of the layer's runs
+    std::uint32_t run_of_(std::size_t layer, std::uint32_t row) const;
+
+    std::uint32_t sides_{0};
+    std::uint32_t layers_{0};
+    std::uint32_t rows_{0};
+    std::size_t words_{0};               //< bitmap words per layer
+    std::vector<std::uint64_t> bitmap_;  //< all zero between calls
+    std::vector<run_> runs_;             //< by side, layer, then row
+    std::vector<std::uint32_t> offset_;  //< first run of each layer
+    std::vector<std::uint32_t> parent_;  //< union-find forest of runs
+    std::vector<std::uint32_t> label_;   //< cluster of each root run
+  };
+} /* falaise */
+
+#endif /* FALAISE_CELL_CLUSTERER_H */
@@ -0,0 +1,196 @@
+#include "cell_constants.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <istream>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "geom_id_text.h"
+
+namespace falaise {
+  namespace {
+    //! Leading bytes of a constants file
+    struct file_header {
+      char magic[8];
+      std::uint32_t byte_order;
+      std::uint32_t version;
+      std::uint32_t record_size;
+      std::uint32_t count;
+    };
+    static_assert(sizeof(file_header) % alignof(std::uint64_t) == 0,
+                  "gids must be aligned after the header");
+
+    char const kMagic[8] = {'F', 'L', 'C', 'C', 'O', 'N', 'S', 'T'};
+    std::uint32_t const kByteOrder{0x01020304};
+    std::uint32_t const kVersion{1};
+
+    //! Sort entries by gid, throwing if any are duplicated
+    void
+    sortEntries(std::vector<cell_constants_table::entry>& entries)
+    {
+      using entry = cell_constants_table::entry;
+      std::sort(entries.begin(),
+                entries.end(),
+                [](entry const& a, entry const& b) { return a.gid < b.gid; });
+      auto dup = std::adjacent_find(
+        entries.begin(), entries.end(), [](entry const& a, entry const& b) {
+          return a.gid == b.gid;
+        });
+      if (dup != entries.end()) {
+        throw bad_cell_constants_error("duplicate cell in constants");
+      }
+    }
+  } // namespace
+
+  cell_constants_table::cell_constants_table(std::vector<entry> entries)
+  {
+    sortEntries(entries);
+    struct owned {
+      std::vector<std::uint64_t> gids;
+      std::vector<cell_constants> constants;
+    };
+    std::shared_ptr<owned> storage{new owned};
+    storage->gids.reserve(entries.size());
+    storage->constants.reserve(entries.size());
+    for (auto const& e : entries) {
+      storage->gids.push_back(e.gid);
+      storage->constants.push_back(e.constants);
+    }
+    gids_ = storage->gids.data();
+    constants_ = storage->constants.data();
+    size_ = entries.size();
+    storage_ = std::move(storage);
+  }
+
+  cell_constants_table::cell_constants_table(tracker_cell_table const& cells,
+                                             cell_constants const& c)
+    : cell_constants_table([&cells, &c] {
+      std::vector<entry> entries;
+      entries.reserve(cells.size());
+      for (std::uint32_t i = 0; i < cells.size(); ++i) {
+        entries.push_back({cells.gid(i), c});
+      }
+      return entries;
+    }())
+  {}
+
+  cell_constants_table
+  cell_constants_table::map_file(std::string const& path)
+  {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+      throw bad_cell_constants_error("cannot open constants file " + path);
+    }
+    struct stat info;
+    if (::fstat(fd, &info) != 0) {
+      ::close(fd);
+      throw bad_cell_constants_error("cannot read constants file " + path);
+    }
+    std::size_t const bytes = info.st_size;
+    if (bytes < sizeof(file_header)) {
+      ::close(fd);
+      throw bad_cell_constants_error("truncated constants file " + path);
+    }
+    void* address = ::mmap(nullptr, bytes, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (address == MAP_FAILED) {
+      throw bad_cell_constants_error("cannot map constants file " + path);
+    }
+    auto unmap = [bytes](void const* p) {
+      ::munmap(const_cast<void*>(p), bytes);
+    };
+    std::shared_ptr<void const> storage{address, unmap};
+
+    file_header header;
+    std::memcpy(&header, address, sizeof(header));
+    if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0) {
+      throw bad_cell_constants_error("not a constants file " + path);
+    }
+    if (header.byte_order != kByteOrder || header.version != kVersion ||
+        header.record_size != sizeof(cell_constants)) {
+      throw bad_cell_constants_error("unsupported constants file " + path);
+    }
+    std::size_t const n = header.count;
+    if (bytes != sizeof(header) + n * (sizeof(std::uint64_t) +
+                                       sizeof(cell_constants))) {
+      throw bad_cell_constants_error("truncated constants file " + path);
+    }
+
+    cell_constants_table table;
+    auto const* bytesIn = static_cast<char const*>(address);
+    table.gids_ =
+      reinterpret_cast<std::uint64_t const*>(bytesIn + sizeof(header));
+    table.constants_ = reinterpret_cast<cell_constants const*>(
+      bytesIn + sizeof(header) + n * sizeof(std::uint64_t));
+    table.size_ = n;
+    table.storage_ = std::move(storage);
+    return table;
+  }
+
+  bool
+  cell_constants_table::matches(tracker_cell_table const& cells) const
+  {
+    if (cells.size() != size_) {
+      return false;
+    }
+    for (std::uint32_t i = 0; i < size_; ++i) {
+      if (cells.gid(i) != gids_[i]) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  std::vector<cell_constants_table::entry>
+  read_cell_constants_text(std::istream& in)
+  {
+    std::vector<cell_constants_table::entry> entries;
+    try {
+      read_geom_id_text(
+        in, [&entries](std::uint64_t gid, std::istream& fields) {
+          cell_constants c;
+          if (!(fields >> c.anode_t0 >> c.cathode_t0 >> c.radius_factor >>
+                c.plasma_speed)) {
+            throw bad_geom_id_text_error("expected four constants");
+          }
+          entries.push_back({gid, c});
+        });
+    }
+    catch (bad_geom_id_text_error const& e) {
+      throw bad_cell_constants_error(std::string{"constants "} + e.what());
+    }
+    return entries;
+  }
+
+  void
+  write_cell_constants(std::string const& path,
+                       std::vector<cell_constants_table::entry> entries)
+  {
+    sortEntries(entries);
+    file_header header;
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.byte_order = kByteOrder;
+    header.version = kVersion;
+    header.record_size = sizeof(cell_constants);
+    header.count = entries.size();
+
+    std::ofstream out{path, std::ios::binary | std::ios::trunc};
+    out.write(reinterpret_cast<char const*>(&header), sizeof(header));
+    for (auto const& e : entries) {
+      out.write(reinterpret_cast<char const*>(&e.gid), sizeof(e.gid));
+    }
+    for (auto const& e : entries) {
+      out.write(reinterpret_cast<char const*>(&e.constants),
+                sizeof(e.constants));
+    }
+    out.close();
+    if (!out) {
+      throw bad_cell_constants_error("cannot write constants file " + path);
+    }
+  }
+} /* falaise */
@@ -0,0 +1,137 @@
+#ifndef FALAISE_CELL_CONSTANTS_H
+#define FALAISE_CELL_CONSTANTS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "tracker_cell_table.h"
+
+namespace falaise {
+  //! Exception thrown when calibration constants cannot be read or used
+  class bad_cell_constants_error : public std::runtime_error {
+    using std::runtime_error::runtime_error;
+  };
+
+  //! Calibration constants of a Geiger cell
+  struct cell_constants {
+    double anode_t0;      //< offset subtracted from anode times (ns)
+    double cathode_t0;    //< offset subtracted from cathode times (ns)
+    double radius_factor; //< correction to radius from the drift model
+    double plasma_speed;  //< longitudinal plasma speed (mm/ns)
+  };
+
+  //! Calibration constants of Geiger cells, by dense cell index
+  /*
+   * Constants are ordered by packed geom_id, so when the table holds the
+   * same cells as a tracker_cell_table (see matches()) it is indexed by the
+   * same dense cell index.
+   *
+   * Tables are either built in memory, or mapped read only from a binary
+   * file written by write_cell_constants(), which needs no parsing: the
+   * file is the table's storage. Copies share storage, and the table is
+   * immutable, so it may be shared by threads.
+   *
+   * Binary files hold, in native byte order:
+   *
+   * | bytes    | content                                             |
+   * |----------|-----------------------------------------------------|
+   * | 8        | magic "FLCCONST"                                    |
+   * | 4 x 4    | byte order mark, version, record size, count N      |
+   * | N x 8    | packed geom_ids, ascending                          |
+   * | N x 32   | cell_constants, in the same order                   |
+   */
+  class cell_constants_table {
+  public:
+    //! Constants and packed geom_id of their cell
+    struct entry {
+      std::uint64_t gid;
+      cell_constants constants;
+    };
+
+    //! Construct an empty table
+    cell_constants_table() = default;
+
+    //! Construct a table holding entries
+    /*
+     * \throw bad_cell_constants_error if a cell appears more than once
+     */
+    explicit cell_constants_table(std::vector<entry> entries);
+
+    //! Construct a table holding constants c for every cell of cells
+    cell_constants_table(tracker_cell_table const& cells,
+                         cell_constants const& c);
+
+    //! Return a table mapping the binary file at path
+    /*
+     * \throw bad_cell_constants_error if the file cannot be mapped, or is
+     * not a constants file of this version and byte order
+     */
+    static cell_constants_table map_file(std::string const& path);
+
+    //! Return the number of cells held
+    std::size_t
+    size() const
+    {
+      return size_;
+    }
+
+    //! Return true if no cells are held
+    bool
+    empty() const
+    {
+      return size_ == 0;
+    }
+
+    //! Return constants of the cell at index
+    cell_constants const& operator[](std::uint32_t i) const
+    {
+      return constants_[i];
+    }
+
+    //! Return packed geom_id of the cell at index
+    std::uint64_t
+    gid(std::uint32_t i) const
+    {
+      return gids_[i];
+    }
+
+    //! Return true if cells has exactly the same cells, so same indices
+    bool matches(tracker_cell_table const& cells) const;
+
+  private:
+    std::shared_ptr<void const> storage_;       //< owns gids_/constants_
+    std::uint64_t const* gids_{nullptr};        //< packed geom_id, by index
+    cell_constants const* constants_{nullptr};  //< constants, by index
+    std::size_t size_{0};
+  };
+
+  //! Read constants from text, one cell per line
+  /*
+   * Lines hold a geom_id then the cell_constants members, in order and in
+   * the units given there, separated by whitespace:
+   *
+   *     # geom_id      anode_t0 cathode_t0 radius_factor plasma_speed
+   *     [1204:0.0.0.0] 12.5     3.0        1.01          0.05
+   *
+   * Text after '#' and blank lines are ignored.
+   *
+   * \throw bad_cell_constants_error on a malformed line
+   */
+  std::vector<cell_constants_table::entry> read_cell_constants_text(
+    std::istream& in);
+
+  //! Write entries as a binary file for cell_constants_table::map_file
+  /*
+   * \throw bad_cell_constants_error if a cell appears more than once, or
+   * the file cannot be written
+   */
+  void write_cell_constants(std::string const& path,
+                            std::vector<cell_constants_table::entry> entries);
+} /* falaise */
+
+#endif /* FALAISE_CELL_CONSTANTS_H */
@@ -0,0 +1,262 @@
+#include "cell_constants_cache.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <exception>
+
+#include <dirent.h>
+
+namespace falaise {
+  namespace {
+    //! Parse a file name "<first>-<last>.bin", false if it is not one
+    bool
+    parseIntervalName(std::string const& name,
+                      std::int32_t& first,
+                      std::int32_t& last)
+    {
+      std::string const suffix{".bin"};
+      if (name.size() <= suffix.size() ||
+          name.compare(name.size() - suffix.size(), suffix.size(), suffix) !=
+            0) {
+        return false;
+      }
+      char const* begin = name.c_str();
+      char* end{nullptr};
+      long const a = std::strtol(begin, &end, 10);
+      if (end == begin || *end != '-') {
+        return false;
+      }
+      begin = end + 1;
+      long const b = std::strtol(begin, &end, 10);
+      if (end == begin || std::string{end} != suffix || b < a) {
+        return false;
+      }
+      first = static_cast<std::int32_t>(a);
+      last = static_cast<std::int32_t>(b);
+      return first == a && last == b;
+    }
+  } // namespace
+
+  constexpr std::size_t cell_constants_cache::none_;
+
+  cell_constants_cache::cell_constants_cache(std::string const& directory,
+                                             loader_type loader,
+                                             std::size_t capacity,
+                                             bool prefetch)
+    : loader_(std::move(loader)), capacity_(capacity)
+  {
+    if (capacity_ == 0) {
+      throw bad_cell_constants_error("constants cache capacity must be > 0");
+    }
+
+    DIR* dir = ::opendir(directory.c_str());
+    if (dir == nullptr) {
+      throw bad_cell_constants_error("cannot read constants directory " +
+                                     directory);
+    }
+    while (dirent* file = ::readdir(dir)) {
+      interval i;
+      if (parseIntervalName(file->d_name, i.first, i.last)) {
+        i.path = directory + "/" + file->d_name;
+        intervals_.push_back(std::move(i));
+      }
+    }
+    ::closedir(dir);
+
+    std::sort(intervals_.begin(),
+              intervals_.end(),
+              [](interval const& a, interval const& b) {
+                return a.first < b.first;
+              });
+    for (std::size_t i = 1; i < intervals_.size(); ++i) {
+      if (intervals_[i].first <= intervals_[i - 1].last) {
+        throw bad_cell_constants_error("overlapping constants intervals " +
+                                       intervals_[i - 1].path + " and " +
+                                       intervals_[i].path);
+      }
+    }
+
+    if (prefetch) {
+      prefetcher_ = std::thread{&cell_constants_cache::prefetch_loop_, this};
+    }
+  }
+
+  cell_constants_cache::~cell_constants_cache()
+  {
+    {
+      std::lock_guard<std::mutex> lock{mutex_};
+      stop_ = true;
+    }
+    wake_.notify_all();
+    if (prefetcher_.joinable()) {
+      prefetcher_.join();
+    }
+  }
+
+  cell_constants_cache::table_ptr
+  cell_constants_cache::get(std::int32_t run)
+  {
+    auto current = std::atomic_load(&current_);
+    if (current && current->first <= run && run <= current->last) {
+      return current->table;
+    }
+
+    auto next = std::upper_bound(
+      intervals_.begin(),
+      intervals_.end(),
+      run,
+      [](std::int32_t r, interval const& i) { return r < i.first; });
+    if (next == intervals_.begin() || run > (next - 1)->last) {
+      throw bad_cell_constants_error("no calibration constants for run " +
+                                     std::to_string(run));
+    }
+    std::size_t const i = (next - 1) - intervals_.begin();
+
+    table_ptr table;
+    bool wakePrefetcher{false};
+    {
+      std::unique_lock<std::mutex> lock{mutex_};
+      table = fetch_(i, lock, statistics_.loads);
+      ++statistics_.switches;
+      std::shared_ptr<current_interval_ const> current{new current_interval_{
+        intervals_[i].first, intervals_[i].last, table}};
+      std::atomic_store(&current_, std::move(current));
+
+      if (prefetcher_.joinable() && i + 1 < intervals_.size()) {
+        request_ = i + 1;
+        wakePrefetcher = true;
+      }
+    }
+    if (wakePrefetcher) {
+      wake_.notify_one();
+    }
+    return table;
+  }
+
+  cell_constants_cache::statistics
+  cell_constants_cache::get_statistics() const
+  {
+    std::lock_guard<std::mutex> lock{mutex_};
+    return statistics_;
+  }
+
+  void
+  cell_constants_cache::wait_prefetch() const
+  {
+    std::unique_lock<std::mutex> lock{mutex_};
+    idle_.wait(lock, [this] { return request_ == none_ && !busy_; });
+  }
+
+  cell_constants_cache::table_ptr
+  cell_constants_cache::find_(std::size_t i)
+  {
+    for (auto& e : cache_) {
+      if (e.interval == i) {
+        e.last_used = ++clock_;
+        return e.table;
+      }
+    }
+    return nullptr;
+  }
+
+  void
+  cell_constants_cache::insert_(std::size_t i, table_ptr table)
+  {
+    if (cache_.size() == capacity_) {
+      auto oldest = std::min_element(
+        cache_.begin(), cache_.end(), [](entry_ const& a, entry_ const& b) {
+          return a.last_used < b.last_used;
+        });
+      cache_.erase(oldest);
+    }
+    cache_.push_back({i, std::move(table), ++clock_});
+  }
+
+  cell_constants_cache::load_ const*
+  cell_constants_cache::find_load_(std::size_t i) const
+  {
+    for (auto const& l : loads_) {
+      if (l.interval == i) {
+        return &l;
+      }
+    }
+    return nullptr;
+  }
+
+  cell_constants_cache::table_ptr
+  cell_constants_cache::fetch_(std::size_t i,
+                               std::unique_lock<std::mutex>& lock,
+                               std::size_t& loaded)
+  {
+    if (table_ptr table = find_(i)) {
+      return table;
+    }
+
+    std::exception_ptr error;
+    table_ptr table;
+    if (load_ const* pending = find_load_(i)) {
+      std::shared_future<table_ptr> result = pending->table;
+      lock.unlock();
+      try {
+        table = result.get();
+      }
+      catch (...) {
+        error = std::current_exception();
+      }
+      lock.lock();
+    }
+    else {
+      std::promise<table_ptr> promise;
+      loads_.push_back({i, promise.get_future().share()});
+      lock.unlock();
+      try {
+        table = std::make_shared<cell_constants_table const>(
+          loader_(intervals_[i].path));
+      }
+      catch (...) {
+        error = std::current_exception();
+      }
+      lock.lock();
+      loads_.erase(loads_.begin() + (find_load_(i) - loads_.data()));
+      if (error) {
+        promise.set_exception(error);
+      }
+      else {
+        insert_(i, table);
+        ++loaded;
+        promise.set_value(table);
+      }
+    }
+    if (error) {
+      std::rethrow_exception(error);
+    }
+    return table;
+  }
+
+  void
+  cell_constants_cache::prefetch_loop_()
+  {
+    std::unique_lock<std::mutex> lock{mutex_};
+    while (true) {
+      wake_.wait(lock, [this] { return stop_ || request_ != none_; });
+      if (stop_) {
+        return;
+      }
+      std::size_t const i = request_;
+      request_ = none_;
+      if (!find_(i) && !find_load_(i)) {
+        busy_ = true;
+        // Failures are left for get() to report, if the run is reached
+        try {
+          fetch_(i, lock, statistics_.prefetches);
+        }
+        catch (std::exception const&) {
+        }
+        busy_ = false;
+      }
+      if (request_ == none_) {
+        idle_.notify_all();
+      }
+    }
+  }
+} /* falaise */
@@ -0,0 +1,163 @@
+#ifndef FALAISE_CELL_CONSTANTS_CACHE_H
+#define FALAISE_CELL_CONSTANTS_CACHE_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "cell_constants.h"
+
+namespace falaise {
+  //! Cache of calibration constants with intervals of validity in runs
+  /*
+   * Constants sets are binary files (see write_cell_constants) in a
+   * directory standing in for a conditions database, each named
+   * "<first>-<last>.bin" for the runs [first, last] it is valid for. Other
+   * files are ignored.
+   *
+   * get() returns the set valid for a run. While runs stay in the current
+   * interval this is one atomic shared_ptr load; on a change of interval
+   * the set is taken from the cache (loading it if needed) and swapped in
+   * as current. Up to capacity sets are cached, least recently used first
+   * out. Sets are loaded without holding the cache's lock, so runs of
+   * cached intervals are not held up by a load, and a set being loaded
+   * (by get() or the prefetcher) is waited for rather than loaded again.
+   *
+   * With prefetch enabled, switching to an interval asks a background
+   * thread to load the next one, so that runs processed in order find
+   * their constants already cached.
+   *
+   * All members are safe to call concurrently.
+   */
+  class cell_constants_cache {
+  public:
+    using table_ptr = std::shared_ptr<cell_constants_table const>;
+    using loader_type =
+      std::function<cell_constants_table(std::string const& path)>;
+
+    //! Constants file and the runs it is valid for
+    struct interval {
+      std::int32_t first;
+      std::int32_t last;
+      std::string path;
+    };
+
+    //! Counts of what get() and the prefetcher did
+    struct statistics {
+      std::size_t switches{0};   //< changes of current interval
+      std::size_t loads{0};      //< sets loaded by get()
+      std::size_t prefetches{0}; //< sets loaded by the prefetcher
+    };
+
+    //! Construct a cache of the constants in directory
+    /*
+     * \param loader loads the set in a file, e.g. cell_constants_table::
+     * map_file, plus any checks
+     * \throw bad_cell_constants_error if directory cannot be read, its
+     * intervals overlap, or capacity is zero
+     */
+    cell_constants_cache(std::string const& directory,
+                         loader_type loader,
+                         std::size_t capacity = 4,
+                         bool prefetch = true);
+
+    //! Stop the prefetcher
+    ~cell_constants_cache();
+
+    cell_constants_cache(cell_constants_cache const&) = delete;
+    cell_constants_cache& operator=(cell_constants_cache const&) = delete;
+
+    //! Return the constants valid for run
+    /*
+     * \throw bad_cell_constants_error if no interval holds run, or the
+     * loader throws it
+     */
+    table_ptr get(std::int32_t run);
+
+    //! Return the intervals found, in run order
+    std::vector<interval> const&
+    intervals() const
+    {
+      return intervals_;
+    }
+
+    //! Return counts of switches and loads so far
+    statistics get_statistics() const;
+
+    //! Wait until the prefetcher has no pending work
+    void wait_prefetch() const;
+
+  private:
+    //! Current interval and its constants
+    struct current_interval_ {
+      std::int32_t first;
+      std::int32_t last;
+      table_ptr table;
+    };
+
+    //! Cached constants of an interval
+    struct entry_ {
+      std::size_t interval;
+      table_ptr table;
+      std::uint64_t last_used;
+    };
+
+    //! Constants of an interval being loaded
+    struct load_ {
+      std::size_t interval;
+      std::shared_future<table_ptr> table;
+    };
+
+    static constexpr std::size_t none_ = static_cast<std::size_t>(-1);
+
+    //! Return constants of interval i if cached, marking them used
+    table_ptr find_(std::size_t i);
+
+    //! Cache constants of interval i, evicting the least recently used
+    void insert_(std::size_t i, table_ptr table);
+
+    //! Return the load in progress of interval i, or nullptr
+    load_ const* find_load_(std::size_t i) const;
+
+    //! Return constants of interval i, loading them if needed
+    /*
+     * Cached constants are returned at once. Otherwise lock is released
+     * while waiting for a load in progress, or while loading the set and
+     * counting it in loaded. Holds lock again on return.
+     *
+     * \throw as the loader
+     */
+    table_ptr fetch_(std::size_t i,
+                     std::unique_lock<std::mutex>& lock,
+                     std::size_t& loaded);
+
+    //! Load requested intervals until stopped
+    void prefetch_loop_();
+
+    std::vector<interval> intervals_; //< sorted by first run
+    loader_type loader_;              //< file -> constants
+    std::size_t capacity_;            //< largest number of cached sets
+    std::shared_ptr<current_interval_ const> current_; //< atomic access only
+
+    mutable std::mutex mutex_;             //< guards all members below
+    std::vector<entry_> cache_;            //< cached sets
+    std::vector<load_> loads_;             //< sets being loaded
+    std::uint64_t clock_{0};               //< counts uses, for last_used
+    statistics statistics_;                //< counts so far
+    std::size_t request_{none_};           //< interval to prefetch, or none_
+    bool busy_{false};                     //< prefetcher is loading
+    bool stop_{false};                     //< prefetcher must exit
+    std::condition_variable wake_;         //< signals request_ or stop_
+    mutable std::condition_variable idle_; //< signals prefetcher idle
+    std::thread prefetcher_;               //< runs prefetch_loop_
+  };
+} /* falaise */
+
+#endif /* FALAISE_CELL_CONSTANTS_CACHE_H */
@@ -0,0 +1,44 @@
+#include "cell_mask.h"
+
+#include <fstream>
+#include <istream>
+
+#include "geom_id_text.h"
+
+namespace falaise {
+  std::size_t
+  cell_mask::count() const
+  {
+    std::size_t n{0};
+    for (std::uint64_t w : words_) {
+      n += __builtin_popcountll(w);
+    }
+    return n;
+  }
+
+  cell_mask
+  read_cell_mask(std::istream& in, tracker_cell_table const& cells)
+  {
+    cell_mask mask{cells.size()};
+    try {
+      read_tracker_cell_text(
+        in, cells, [&mask](std::uint32_t index, std::istream&) {
+          mask.set(index);
+        });
+    }
+    catch (bad_geom_id_text_error const& e) {
+      throw bad_cell_mask_error(std::string{"cell mask "} + e.what());
+    }
+    return mask;
+  }
+
+  cell_mask
+  load_cell_mask(std::string const& path, tracker_cell_table const& cells)
+  {
+    std::ifstream in{path};
+    if (!in) {
+      throw bad_cell_mask_error("cannot open cell mask file " + path);
+    }
+    return read_cell_mask(in, cells);
+  }
+} /* falaise */
@@ -0,0 +1,85 @@
+#ifndef FALAISE_CELL_MASK_H
+#define FALAISE_CELL_MASK_H
+
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "tracker_cell_table.h"
+
+namespace falaise {
+  //! Exception thrown when a cell mask cannot be read
+  class bad_cell_mask_error : public std::runtime_error {
+    using std::runtime_error::runtime_error;
+  };
+
+  //! Set of masked (dead or noisy) Geiger cells, by dense cell index
+  /*
+   * Stored as a packed bitset over the indices of a tracker_cell_table, so
+   * the mask of a full tracker is 32 words and testing a cell is one load
+   * and shift.
+   */
+  class cell_mask {
+  public:
+    //! Construct a mask of no cells
+    cell_mask() = default;
+
+    //! Construct a mask of n cells, none of them masked
+    explicit cell_mask(std::size_t n) : size_(n), words_((n + 63) / 64, 0) {}
+
+    //! Return the number of cells covered
+    std::size_t
+    size() const
+    {
+      return size_;
+    }
+
+    //! Return the number of masked cells
+    std::size_t count() const;
+
+    //! Return true if the cell at index i (< size()) is masked
+    bool
+    test(std::uint32_t i) const
+    {
+      return (words_[i >> 6] >> (i & 63)) & 1;
+    }
+
+    //! Mask the cell at index i (< size())
+    void
+    set(std::uint32_t i)
+    {
+      words_[i >> 6] |= std::uint64_t{1} << (i & 63);
+    }
+
+  private:
+    std::size_t size_{0};             //< number of cells
+    std::vector<std::uint64_t> words_; //< bit i % 64 of word i / 64 is cell i
+  };
+
+  //! Read a mask of cells from text, one masked cell per line
+  /*
+   * Lines hold the geom_id of a cell of cells, e.g.
+   *
+   *     # Dead since 2019-03
+   *     [1204:0.1.2.3]
+   *
+   * Text after '#' and blank lines are ignored, and cells may be listed
+   * more than once.
+   *
+   * \throw bad_cell_mask_error on a malformed line or a cell not in cells
+   */
+  cell_mask read_cell_mask(std::istream& in, tracker_cell_table const& cells);
+
+  //! Read a mask of cells from the text file at path
+  /*
+   * \throw bad_cell_mask_error if the file cannot be read, or as
+   * read_cell_mask
+   */
+  cell_mask load_cell_mask(std::string const& path,
+                           tracker_cell_table const& cells);
+} /* falaise */
+
+#endif /* FALAISE_CELL_MASK_H */
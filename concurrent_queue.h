@@ -0,0 +1,135 @@
+#ifndef FALAISE_CONCURRENT_QUEUE_H
+#define FALAISE_CONCURRENT_QUEUE_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <utility>
+
+namespace falaise {
+  //! Blocking first-in first-out queue with a fixed capacity
+  /*
+   * Producers block in push() while the queue is full, consumers block in
+   * pop() while it is empty. Once close() is called, push() fails and pop()
+   * drains the remaining items before failing, so consumers can use
+   *
+   *   while (queue.pop(item)) { ... }
+   */
+  template <typename T>
+  class bounded_queue {
+  public:
+    //! Construct a queue holding at most capacity (> 0) items
+    explicit bounded_queue(std::size_t capacity) : capacity_(capacity) {}
+
+    //! Append item, blocking while full
+    /*
+     * \returns false, leaving item untouched, if the queue is closed
+     */
+    bool
+    push(T& item)
+    {
+      std::unique_lock<std::mutex> lock{mutex_};
+      notFull_.wait(lock,
+                    [this] { return closed_ || items_.size() < capacity_; });
+      if (closed_) {
+        return false;
+      }
+      items_.push_back(std::move(item));
+      notEmpty_.notify_one();
+      return true;
+    }
+
+    //! Remove the front item into item, blocking while empty
+    /*
+     * \returns false if the queue is closed and empty
+     */
+    bool
+    pop(T& item)
+    {
+      std::unique_lock<std::mutex> lock{mutex_};
+      notEmpty_.wait(lock, [this] { return closed_ || !items_.empty(); });
+      if (items_.empty()) {
+        return false;
+      }
+      item = std::move(items_.front());
+      items_.pop_front();
+      notFull_.notify_one();
+      return true;
+    }
+
+    //! Refuse further pushes and wake all waiting threads
+    void
+    close()
+    {
+      std::lock_guard<std::mutex> lock{mutex_};
+      closed_ = true;
+      notFull_.notify_all();
+      notEmpty_.notify_all();
+    }
+
+  private:
+    std::size_t const capacity_;
+    std::deque<T> items_;
+    bool closed_{false};
+    std::mutex mutex_;
+    std::condition_variable notFull_;
+    std::condition_variable notEmpty_;
+  };
+
+  //! Restores sequence order of items completed out of order
+  /*
+   * Items are inserted with their sequence number (0, 1, 2, ...) in any
+   * order, and released strictly in sequence order as soon as all earlier
+   * items have been inserted. Not thread-safe, intended for use by a single
+   * consumer (e.g. an output writer).
+   */
+  template <typename T>
+  class reorder_buffer {
+  public:
+    //! Insert item with sequence number seq
+    void
+    insert(std::size_t seq, T item)
+    {
+      pending_.emplace(seq, std::move(item));
+    }
+
+    //! Move the next in-sequence item into item, if it has been inserted
+    /*
+     * \returns true if an item was released
+     */
+    bool
+    release(T& item)
+    {
+      auto iter = pending_.begin();
+      if (iter == pending_.end() || iter->first != next_) {
+        return false;
+      }
+      item = std::move(iter->second);
+      pending_.erase(iter);
+      ++next_;
+      return true;
+    }
+
+    //! Return the number of items waiting for earlier ones
+    std::size_t
+    pending() const
+    {
+      return pending_.size();
+    }
+
+    //! Return the sequence number of the next item to be released
+    std::size_t
+    next() const
+    {
+      return next_;
+    }
+
+  private:
+    std::map<std::size_t, T> pending_;
+    std::size_t next_{0};
+  };
+} /* falaise */
+
+#endif /* FALAISE_CONCURRENT_QUEUE_H */
@@ -0,0 +1,108 @@
+#include "drift_model.h"
+
+#include <algorithm>
+
+namespace falaise {
+  namespace {
+    //! Set y[i] to table values interpolated at x[i] * scale, for i < n
+    /*
+     * Clamping the interval index to [0, last] extrapolates outside the
+     * table. x must not hold NaN.
+     */
+    void
+    interpolate(std::size_t n,
+                double const* __restrict x,
+                double* __restrict y,
+                double const* __restrict table,
+                double scale,
+                double last)
+    {
+      for (std::size_t i = 0; i < n; ++i) {
+        double const u = x[i] * scale;
+        int const k = static_cast<int>(std::min(std::max(u, 0.0), last));
+        double const y0 = table[k];
+        double const y1 = table[k + 1];
+        y[i] = y0 + (u - k) * (y1 - y0);
+      }
+    }
+  } // namespace
+
+  drift_model::drift_model(function_type radius,
+                           double max_time,
+                           std::size_t n)
+    : max_time_(max_time)
+  {
+    if (n < 2) {
+      throw bad_drift_model_error("drift table needs at least two points");
+    }
+    if (!(max_time > 0.0)) {
+      throw bad_drift_model_error("drift table maximum time must be > 0");
+    }
+
+    double const dt = max_time / (n - 1);
+    radius_.y.resize(n);
+    for (std::size_t i = 0; i < n; ++i) {
+      radius_.y[i] = radius(i * dt);
+      if (i > 0 && !(radius_.y[i] > radius_.y[i - 1])) {
+        throw bad_drift_model_error("drift radius must increase with time");
+      }
+    }
+    radius_.scale = 1.0 / dt;
+    radius_.last = n - 2;
+    max_radius_ = radius_.y.back();
+
+    // Invert by bisection, inside the interval of r(t) holding each radius
+    double const dr = max_radius_ / (n - 1);
+    time_.y.resize(n);
+    std::size_t i{0};
+    for (std::size_t j = 0; j < n; ++j) {
+      double const r = j * dr;
+      while (i + 2 < n && radius_.y[i + 1] < r) {
+        ++i;
+      }
+      double lo = i * dt;
+      double hi = (i + 1) * dt;
+      for (int iteration = 0; iteration < 64 && lo < hi; ++iteration) {
+        double const mid = 0.5 * (lo + hi);
+        if (radius(mid) < r) {
+          lo = mid;
+        }
+        else {
+          hi = mid;
+        }
+      }
+      time_.y[j] = 0.5 * (lo + hi);
+    }
+    time_.y.back() = max_time;
+    time_.scale = 1.0 / dr;
+    time_.last = n - 2;
+  }
+
+  double
+  drift_model::radius(double t) const
+  {
+    double r;
+    radius(&t, &r, 1);
+    return r;
+  }
+
+  void
+  drift_model::radius(double const* t, double* r, std::size_t n) const
+  {
+    interpolate(n, t, r, radius_.y.data(), radius_.scale, radius_.last);
+  }
+
+  double
+  drift_model::time(double r) const
+  {
+    double t;
+    time(&r, &t, 1);
+    return t;
+  }
+
+  void
+  drift_model::time(double const* r, double* t, std::size_t n) const
+  {
+    interpolate(n, r, t, time_.y.data(), time_.scale, time_.last);
+  }
+} /* falaise */
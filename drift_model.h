@@ -0,0 +1,116 @@
+#ifndef FALAISE_DRIFT_MODEL_H
+#define FALAISE_DRIFT_MODEL_H
+
+#include <cmath>
+#include <cstddef>
+#include <functional>
+#include <stdexcept>
+#include <vector>
+
+namespace falaise {
+  //! Exception thrown when a drift relation cannot be tabulated
+  class bad_drift_model_error : public std::logic_error {
+    using std::logic_error::logic_error;
+  };
+
+  //! Tabulated relation between drift time and drift radius in a cell
+  /*
+   * The relation r(t) is sampled at construction on a uniform grid of
+   * times in [0, max_time()], and its inverse t(r) on a uniform grid of
+   * radii in [0, max_radius()], where max_radius() = r(max_time()).
+   * Evaluation is then linear interpolation in the table, costing the same
+   * whatever the relation, with an error falling as the square of the grid
+   * spacing. Outside the grid, values are extrapolated from its first or
+   * last interval.
+   *
+   * The buffer overloads of radius() and time() are written as branch-free
+   * loops that can be vectorized, table lookups included, which GCC only
+   * does from -O3 or with -ftree-vectorize, as set for this file in
+   * CMakeLists.txt. Without hardware gathers (e.g. on baseline x86-64) this
+   * gains little over scalar code. Arguments must not be NaN.
+   */
+  class drift_model {
+  public:
+    using function_type = std::function<double(double)>;
+
+    //! Construct an empty model
+    drift_model() = default;
+
+    //! Construct a model tabulating radius(t) at n points in [0, max_time]
+    /*
+     * \throw bad_drift_model_error if n < 2, max_time is not positive, or
+     * radius is not strictly increasing on the grid
+     */
+    drift_model(function_type radius, double max_time, std::size_t n);
+
+    //! Return the number of points in each table
+    std::size_t
+    size() const
+    {
+      return radius_.y.size();
+    }
+
+    //! Return the largest tabulated drift time
+    double
+    max_time() const
+    {
+      return max_time_;
+    }
+
+    //! Return the drift radius at max_time()
+    double
+    max_radius() const
+    {
+      return max_radius_;
+    }
+
+    //! Return the drift radius after drift time t
+    double radius(double t) const;
+
+    //! Set r[i] to the drift radius after drift time t[i], for i < n
+    void radius(double const* t, double* r, std::size_t n) const;
+
+    //! Return the drift time from radius r
+    double time(double r) const;
+
+    //! Set t[i] to the drift time from radius r[i], for i < n
+    void time(double const* r, double* t, std::size_t n) const;
+
+  private:
+    //! Values at uniform points in [0, x_max]
+    struct table_ {
+      std::vector<double> y; //< values
+      double scale{0.0};     //< (n - 1) / x_max, x to fractional point index
+      double last{0.0};      //< n - 2, index of the last interval
+    };
+
+    double max_time_{0.0};
+    double max_radius_{0.0};
+    table_ radius_; //< r(t)
+    table_ time_;   //< t(r)
+  };
+
+  //! Mock drift radius after drift time t
+  /*
+   * Radius reached when the drift velocity at radius r is
+   * anode_velocity * radius_scale / (r + radius_scale), i.e. falls off
+   * with the 1/r field of the anode wire away from it.
+   */
+  inline double
+  mock_drift_radius(double t, double anode_velocity, double radius_scale)
+  {
+    return std::sqrt(radius_scale * radius_scale +
+                     2.0 * anode_velocity * radius_scale * t) -
+           radius_scale;
+  }
+
+  //! Mock drift time from radius r, the inverse of mock_drift_radius
+  inline double
+  mock_drift_time(double r, double anode_velocity, double radius_scale)
+  {
+    return r * (r + 2.0 * radius_scale) /
+           (2.0 * anode_velocity * radius_scale);
+  }
+} /* falaise */
+
+#endif /* FALAISE_DRIFT_MODEL_H */
@@ -0,0 +1,38 @@
+#ifndef FALAISE_EVENT_BANK_H
+#define FALAISE_EVENT_BANK_H
+
+#include <string>
+
+#include "bayeux/datatools/things.h"
+
+namespace falaise {
+  //! Add a bank of type T at label in event, filled in place by fill
+  /*
+   * datatools::things default-constructs the banks it holds, so a bank
+   * built elsewhere and assigned costs a second construction and a move of
+   * its contents. Instead, fill(T&) is called on the bank once it is held
+   * by event, so T is constructed exactly once.
+   *
+   * If fill throws, the partly filled bank is removed from event before
+   * the exception is rethrown.
+   *
+   * \returns the bank
+   * \throw as datatools::things::add if label is already held
+   */
+  template <typename T, typename F>
+  T&
+  add_bank(datatools::things& event, std::string const& label, F&& fill)
+  {
+    T& bank = event.add<T>(label);
+    try {
+      fill(bank);
+    }
+    catch (...) {
+      event.remove(label);
+      throw;
+    }
+    return bank;
+  }
+} /* falaise */
+
+#endif /* FALAISE_EVENT_BANK_H */
@@ -0,0 +1,42 @@
+// flcellconstants - convert Geiger cell calibration constants to binary
+//
+// Usage: flcellconstants input.txt output.bin
+//
+// The input is text with one cell per line (see read_cell_constants_text
+// in cell_constants.h); the output is the binary file mapped by the
+// MockTrackerCalibrator "calibration.constants_file" property.
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+#include "cell_constants.h"
+
+int
+main(int argc, char* argv[])
+{
+  if (argc != 3) {
+    std::cerr << "Usage: flcellconstants input.txt output.bin\n";
+    return EXIT_FAILURE;
+  }
+  const std::string input{argv[1]};
+  const std::string output{argv[2]};
+
+  try {
+    std::ifstream in{input};
+    if (!in) {
+      throw falaise::bad_cell_constants_error("cannot open " + input);
+    }
+    auto entries = falaise::read_cell_constants_text(in);
+    std::size_t const n = entries.size();
+    falaise::write_cell_constants(output, std::move(entries));
+    std::clog << "flcellconstants: wrote constants of " << n << " cells to "
+              << output << "\n";
+  }
+  catch (std::exception const& e) {
+    std::cerr << "flcellconstants: " << e.what() << "\n";
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,179 @@
+// flparallel - run a flreconstruct pipeline over a file on worker threads
+//
+// Usage: flparallel -p pipeline.conf -i input [-o output] [-j workers]
+//                   [-m module] [-g geometry.conf] [--unordered]
+//
+// The pipeline script is the multi_properties file read by flreconstruct
+// (e.g. MockTrackerCalibrator.conf). Plugins in its flreconstruct.plugins
+// section are loaded, and the module named by -m (default "pipeline") is
+// run on every event with one instance per worker thread (-j, default one
+// per core). Output events are written in input order unless --unordered
+// is given.
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+#include "bayeux/datatools/library_loader.h"
+#include "bayeux/datatools/multi_properties.h"
+#include "bayeux/datatools/service_manager.h"
+#include "bayeux/datatools/things.h"
+#include "bayeux/datatools/utils.h"
+#include "bayeux/dpp/input_module.h"
+#include "bayeux/dpp/output_module.h"
+#include "falaise/falaise.h"
+#include "falaise/snemo/processing/services.h"
+
+#include "parallel_pipeline.h"
+
+namespace {
+  struct Arguments {
+    std::string pipeline;
+    std::string input;
+    std::string output;
+    std::string geometry{
+      "@falaise:config/snemo/demonstrator/geometry/4.0/manager.conf"};
+    falaise::parallel_pipeline::options options;
+  };
+
+  void
+  usage(std::ostream& os)
+  {
+    os << "Usage: flparallel -p pipeline.conf -i input [-o output]\n"
+          "                  [-j workers] [-m module] [-g geometry.conf]\n"
+          "                  [--unordered]\n";
+  }
+
+  //! Parse command line into args, false if it is invalid
+  bool
+  parseArguments(int argc, char* argv[], Arguments& args)
+  {
+    for (int i = 1; i < argc; ++i) {
+      const std::string opt{argv[i]};
+      if (opt == "--unordered") {
+        args.options.ordered = false;
+        continue;
+      }
+      if (i + 1 == argc) {
+        return false;
+      }
+      const std::string value{argv[++i]};
+      if (opt == "-p") {
+        args.pipeline = value;
+      }
+      else if (opt == "-i") {
+        args.input = value;
+      }
+      else if (opt == "-o") {
+        args.output = value;
+      }
+      else if (opt == "-j") {
+        try {
+          args.options.workers = std::stoul(value);
+        }
+        catch (std::exception const&) {
+          return false;
+        }
+      }
+      else if (opt == "-m") {
+        args.options.module = value;
+      }
+      else if (opt == "-g") {
+        args.geometry = value;
+      }
+      else {
+        return false;
+      }
+    }
+    return !args.pipeline.empty() && !args.input.empty();
+  }
+
+  int
+  run(Arguments const& args)
+  {
+    std::string pipelineFile{args.pipeline};
+    datatools::fetch_path_with_env(pipelineFile);
+    datatools::multi_properties config{"name", "type"};
+    config.read(pipelineFile);
+
+    datatools::library_loader loader;
+    falaise::load_pipeline_plugins(config, loader);
+
+    datatools::service_manager services;
+    datatools::properties geoConfig;
+    geoConfig.store_path("manager.configuration_file", args.geometry);
+    services.load(
+      snemo::processing::service_info::default_geometry_service_label(),
+      "geomtools::geometry_service",
+      geoConfig);
+    services.initialize();
+
+    falaise::parallel_pipeline pipeline{config, services, args.options};
+
+    dpp::input_module input;
+    input.set_single_input_file(args.input);
+    input.initialize_simple();
+    auto source = [&input]() -> falaise::parallel_pipeline::event_ptr {
+      if (input.is_terminated()) {
+        return nullptr;
+      }
+      falaise::parallel_pipeline::event_ptr event{new datatools::things};
+      if (input.process(*event) != dpp::base_module::PROCESS_OK) {
+        return nullptr;
+      }
+      return event;
+    };
+
+    std::unique_ptr<dpp::output_module> output;
+    if (!args.output.empty()) {
+      output.reset(new dpp::output_module);
+      output->set_single_output_file(args.output);
+      output->initialize_simple();
+    }
+    auto sink = [&output](datatools::things& event) {
+      if (output) {
+        output->process(event);
+      }
+    };
+
+    auto start = std::chrono::steady_clock::now();
+    auto stats = pipeline.run(source, sink);
+    std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - start;
+
+    std::clog << "flparallel: " << stats.read << " events read, "
+              << stats.written << " written, " << stats.stopped
+              << " stopped, " << stats.errors << " errors on "
+              << pipeline.workers() << " workers in " << elapsed.count()
+              << " s (" << stats.read / elapsed.count() << " events/s)\n";
+
+    if (output) {
+      output->reset();
+    }
+    input.reset();
+    return stats.errors == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+  }
+} // namespace
+
+int
+main(int argc, char* argv[])
+{
+  Arguments args;
+  if (!parseArguments(argc, argv, args)) {
+    usage(std::cerr);
+    return EXIT_FAILURE;
+  }
+
+  FALAISE_INIT_MAIN(argc, argv);
+  int status{EXIT_FAILURE};
+  try {
+    status = run(args);
+  }
+  catch (std::exception const& e) {
+    std::cerr << "flparallel: " << e.what() << "\n";
+  }
+  FALAISE_FINI();
+  return status;
+}
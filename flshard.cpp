@@ -0,0 +1,395 @@
+// flshard - run a flreconstruct pipeline over a file in worker processes
+//
+// Usage: flshard -p pipeline.conf -i input -o output [-j workers]
+//                [-b block] [-m module] [-g geometry.conf]
+//
+// As flparallel, but the pipeline is run by forked worker processes (-j,
+// default one per core) rather than threads, so modules and upstream code
+// need not be thread-safe. Input events are dealt to workers in blocks of
+// -b consecutive events (default 1000), block i to worker i % workers.
+// Each worker loads only the events of its own blocks from the input,
+// which must be a brio file so events can be read by entry, runs the
+// module named by -m (default "pipeline") on each of them in turn,
+// and writes the events it keeps to a shard file next to the output,
+// tagged with their input index. Once all workers succeed, their shards
+// are merged into the output in input order by a streaming k-way merge,
+// holding one event per worker, and removed.
+//
+// Events are dropped as by flparallel: those the module stops or fails
+// with PROCESS_ERROR are counted and not written, and failed events make
+// the exit status a failure, although the output is complete. A worker
+// meeting PROCESS_FATAL or an exception fails, and no output is written.
+// Nor is any if the merge fails, the partial output being removed.
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "bayeux/brio/reader.h"
+#include "bayeux/datatools/library_loader.h"
+#include "bayeux/datatools/multi_properties.h"
+#include "bayeux/datatools/properties.h"
+#include "bayeux/datatools/service_manager.h"
+#include "bayeux/datatools/things.h"
+#include "bayeux/datatools/utils.h"
+#include "bayeux/dpp/base_module.h"
+#include "bayeux/dpp/brio_common.h"
+#include "bayeux/dpp/input_module.h"
+#include "bayeux/dpp/module_manager.h"
+#include "bayeux/dpp/output_module.h"
+#include "falaise/falaise.h"
+#include "falaise/snemo/processing/services.h"
+
+#include "kway_merge.h"
+#include "parallel_pipeline.h"
+
+namespace {
+  //! Bank holding an event's input index while in a shard file
+  const char* const indexBank = "flshard.index";
+
+  //! Exit status of workers that wrote their shard but failed events
+  const int workerErrors = 2;
+
+  struct Arguments {
+    std::string pipeline;
+    std::string input;
+    std::string output;
+    std::string geometry{
+      "@falaise:config/snemo/demonstrator/geometry/4.0/manager.conf"};
+    std::string module{"pipeline"};
+    std::size_t workers{0};
+    std::size_t block{1000};
+  };
+
+  void
+  usage(std::ostream& os)
+  {
+    os << "Usage: flshard -p pipeline.conf -i input -o output [-j workers]\n"
+          "               [-b block] [-m module] [-g geometry.conf]\n";
+  }
+
+  //! Parse command line into args, false if it is invalid
+  bool
+  parseArguments(int argc, char* argv[], Arguments& args)
+  {
+    for (int i = 1; i < argc; ++i) {
+      const std::string opt{argv[i]};
+      if (i + 1 == argc) {
+        return false;
+      }
+      const std::string value{argv[++i]};
+      if (opt == "-p") {
+        args.pipeline = value;
+      }
+      else if (opt == "-i") {
+        args.input = value;
+      }
+      else if (opt == "-o") {
+        args.output = value;
+      }
+      else if (opt == "-j" || opt == "-b") {
+        try {
+          (opt == "-j" ? args.workers : args.block) = std::stoul(value);
+        }
+        catch (std::exception const&) {
+          return false;
+        }
+      }
+      else if (opt == "-m") {
+        args.module = value;
+      }
+      else if (opt == "-g") {
+        args.geometry = value;
+      }
+      else {
+        return false;
+      }
+    }
+    return !args.pipeline.empty() && !args.input.empty() &&
+           !args.output.empty() && args.block > 0;
+  }
+
+  //! Return true if file is a brio file, as named by dpp's I/O modules
+  bool
+  isBrioFile(std::string const& file)
+  {
+    const std::string extension{".brio"};
+    return file.size() > extension.size() &&
+           file.compare(file.size() - extension.size(),
+                        extension.size(),
+                        extension) == 0;
+  }
+
+  //! Return the name of worker w's shard of output, keeping its extension
+  std::string
+  shardFile(std::string const& output, std::size_t w)
+  {
+    const auto slash = output.find_last_of('/');
+    const auto dir = slash == std::string::npos ? 0 : slash + 1;
+    return output.substr(0, dir) + ".flshard-" + std::to_string(w) + "-" +
+           output.substr(dir);
+  }
+
+  //! Tag event with its input index, as two 32 bit integer properties
+  void
+  storeIndex(datatools::things& event, std::uint64_t index)
+  {
+    auto& bank = event.add<datatools::properties>(indexBank);
+    bank.store("index.high", static_cast<int>(index >> 32));
+    bank.store("index.low", static_cast<int>(index & 0xFFFFFFFF));
+  }
+
+  //! Return the input index event was tagged with by storeIndex
+  std::uint64_t
+  fetchIndex(datatools::things const& event)
+  {
+    const auto& bank = event.get<datatools::properties>(indexBank);
+    const std::uint64_t high =
+      static_cast<std::uint32_t>(bank.fetch_integer("index.high"));
+    const std::uint64_t low =
+      static_cast<std::uint32_t>(bank.fetch_integer("index.low"));
+    return high << 32 | low;
+  }
+
+  //! Run the pipeline on worker w's blocks of input, into its shard
+  /*
+   * Called in the worker process, so loads plugins and services itself.
+   * Returns EXIT_SUCCESS, or workerErrors if events failed with
+   * PROCESS_ERROR.
+   *
+   * \throw falaise::pipeline_fatal_error if the module returns
+   * PROCESS_FATAL
+   * \throw std::runtime_error if an input event cannot be read
+   */
+  int
+  runWorker(Arguments const& args, std::size_t w)
+  {
+    std::string pipelineFile{args.pipeline};
+    datatools::fetch_path_with_env(pipelineFile);
+    datatools::multi_properties config{"name", "type"};
+    config.read(pipelineFile);
+
+    datatools::library_loader loader;
+    falaise::load_pipeline_plugins(config, loader);
+
+    datatools::service_manager services;
+    datatools::properties geoConfig;
+    geoConfig.store_path("manager.configuration_file", args.geometry);
+    services.load(
+      snemo::processing::service_info::default_geometry_service_label(),
+      "geomtools::geometry_service",
+      geoConfig);
+    services.initialize();
+
+    dpp::module_manager modules;
+    auto& pipeline =
+      falaise::load_pipeline_modules(config, services, args.module, modules);
+
+    std::string inputFile{args.input};
+    datatools::fetch_path_with_env(inputFile);
+    brio::reader input;
+    input.open(inputFile);
+    const auto& store = dpp::brio_common::EVENT_RECORD_STORE_LABEL;
+    const std::uint64_t entries = input.get_number_of_entries(store);
+
+    dpp::output_module output;
+    output.set_single_output_file(shardFile(args.output, w));
+    output.initialize_simple();
+
+    falaise::parallel_pipeline::statistics stats;
+    datatools::things event;
+    const std::uint64_t stride = args.workers * args.block;
+    for (std::uint64_t first = w * args.block; first < entries;
+         first += stride) {
+      const std::uint64_t last = std::min(first + args.block, entries);
+      for (std::uint64_t i = first; i < last; ++i) {
+        event.clear();
+        if (input.load(event, store, i) != 0) {
+          throw std::runtime_error("cannot read event " + std::to_string(i) +
+                                   " of '" + inputFile + "'");
+        }
+        ++stats.read;
+        const auto status = pipeline.process(event);
+        if (status & dpp::base_module::PROCESS_FATAL) {
+          throw falaise::pipeline_fatal_error("module '" + args.module +
+                                              "' failed processing event " +
+                                              std::to_string(i));
+        }
+        if (status == dpp::base_module::PROCESS_OK) {
+          storeIndex(event, i);
+          output.process(event);
+          ++stats.written;
+        }
+        else if (status & dpp::base_module::PROCESS_STOP) {
+          ++stats.stopped;
+        }
+        else {
+          ++stats.errors;
+        }
+      }
+    }
+
+    std::clog << "flshard: worker " << w << ": " << stats.read
+              << " events read, " << stats.written << " written, "
+              << stats.stopped << " stopped, " << stats.errors << " errors\n";
+    output.reset();
+    input.close();
+    modules.reset();
+    return stats.errors == 0 ? EXIT_SUCCESS : workerErrors;
+  }
+
+  //! Merge the workers' shards into the output, in input order
+  /*
+   * \throw std::runtime_error if a shard cannot be read to its end
+   */
+  std::size_t
+  mergeShards(Arguments const& args)
+  {
+    using event_ptr = falaise::parallel_pipeline::event_ptr;
+    std::vector<std::unique_ptr<dpp::input_module>> shards;
+    std::vector<falaise::kway_merge<datatools::things>::source_type> sources;
+    for (std::size_t w = 0; w < args.workers; ++w) {
+      // Workers that wrote no events, e.g. having no blocks, leave no shard
+      const std::string file{shardFile(args.output, w)};
+      if (access(file.c_str(), F_OK) != 0) {
+        continue;
+      }
+      shards.emplace_back(new dpp::input_module);
+      auto& shard = *shards.back();
+      shard.set_single_input_file(file);
+      shard.initialize_simple();
+      sources.push_back([&shard, file]() -> event_ptr {
+        if (shard.is_terminated()) {
+          return nullptr;
+        }
+        event_ptr event{new datatools::things};
+        const auto status = shard.process(*event);
+        if (status & dpp::base_module::PROCESS_STOP) {
+          return nullptr;
+        }
+        if (status != dpp::base_module::PROCESS_OK) {
+          throw std::runtime_error("cannot read shard '" + file + "'");
+        }
+        return event;
+      });
+    }
+    falaise::kway_merge<datatools::things> merge{
+      std::move(sources), fetchIndex};
+
+    dpp::output_module output;
+    output.set_single_output_file(args.output);
+    output.initialize_simple();
+    std::size_t written{0};
+    while (auto event = merge.next()) {
+      event->remove(indexBank);
+      output.process(*event);
+      ++written;
+    }
+    output.reset();
+    for (auto& shard : shards) {
+      shard->reset();
+    }
+    return written;
+  }
+
+  //! Fork the workers, wait for them, and merge their shards
+  int
+  run(Arguments const& args, int argc, char* argv[])
+  {
+    // Fork before initializing anything, so each worker starts from a
+    // clean, single threaded process
+    const auto start = std::chrono::steady_clock::now();
+    std::vector<pid_t> workers;
+    for (std::size_t w = 0; w < args.workers; ++w) {
+      const pid_t pid = fork();
+      if (pid < 0) {
+        std::perror("flshard: fork");
+        break;
+      }
+      if (pid == 0) {
+        FALAISE_INIT_MAIN(argc, argv);
+        int status{EXIT_FAILURE};
+        try {
+          status = runWorker(args, w);
+        }
+        catch (std::exception const& e) {
+          std::cerr << "flshard: worker " << w << ": " << e.what() << "\n";
+        }
+        FALAISE_FINI();
+        std::fflush(nullptr);
+        _exit(status);
+      }
+      workers.push_back(pid);
+    }
+
+    bool failed{workers.size() != args.workers};
+    bool errors{false};
+    for (const pid_t pid : workers) {
+      int status{0};
+      if (waitpid(pid, &status, 0) != pid || !WIFEXITED(status)) {
+        failed = true;
+      }
+      else if (WEXITSTATUS(status) == workerErrors) {
+        errors = true;
+      }
+      else if (WEXITSTATUS(status) != EXIT_SUCCESS) {
+        failed = true;
+      }
+    }
+
+    if (!failed) {
+      FALAISE_INIT_MAIN(argc, argv);
+      try {
+        const std::size_t written = mergeShards(args);
+        std::chrono::duration<double> elapsed =
+          std::chrono::steady_clock::now() - start;
+        std::clog << "flshard: " << written << " events written by "
+                  << args.workers << " workers in " << elapsed.count()
+                  << " s\n";
+      }
+      catch (std::exception const& e) {
+        std::cerr << "flshard: merge: " << e.what() << "\n";
+        std::remove(args.output.c_str());
+        failed = true;
+      }
+      FALAISE_FINI();
+    }
+    else {
+      std::cerr << "flshard: a worker failed, output not written\n";
+    }
+    for (std::size_t w = 0; w < args.workers; ++w) {
+      std::remove(shardFile(args.output, w).c_str());
+    }
+    return failed || errors ? EXIT_FAILURE : EXIT_SUCCESS;
+  }
+} // namespace
+
+int
+main(int argc, char* argv[])
+{
+  Arguments args;
+  if (!parseArguments(argc, argv, args)) {
+    usage(std::cerr);
+    return EXIT_FAILURE;
+  }
+  if (!isBrioFile(args.input)) {
+    std::cerr << "flshard: input must be a .brio file\n";
+    return EXIT_FAILURE;
+  }
+  if (args.workers == 0) {
+    args.workers = std::max(1u, std::thread::hardware_concurrency());
+  }
+  return run(args, argc, argv);
+}
@@ -0,0 +1,293 @@
+#include "geiger_digitizer.h"
+
+#include <cmath>
+#include <stdexcept>
+#include <utility>
+
+#include "bayeux/datatools/utils.h"
+
+#include "packed_geom_id.h"
+
+namespace falaise {
+  namespace {
+    //! Bit of flags set if the anode fired, alongside the raw hit flags
+    enum : std::uint8_t { anode_fired = 1 << 7 };
+
+    //! Compute distance of n step hits from their anode wires
+    /*
+     * Written as a branch-free loop over non-aliasing columns so that it is
+     * vectorized (sqrt needs -fno-math-errno for that).
+     */
+    void
+    drift_radii(std::size_t n,
+                double const* __restrict x,
+                double const* __restrict y,
+                double const* __restrict anode_x,
+                double const* __restrict anode_y,
+                double* __restrict radius)
+    {
+      for (std::size_t i = 0; i < n; ++i) {
+        double const dx = x[i] - anode_x[i];
+        double const dy = y[i] - anode_y[i];
+        radius[i] = std::sqrt(dx * dx + dy * dy);
+      }
+    }
+
+    //! Compute anode and cathode times of n step hits from drift times
+    /*
+     * anode_time holds the drift times on input, and the anode times on
+     * output
+     */
+    void
+    signal_times(std::size_t n,
+                 double const* __restrict z,
+                 double const* __restrict t,
+                 double const* __restrict z_min,
+                 double const* __restrict z_max,
+                 double plasma_speed,
+                 double* __restrict anode_time,
+                 double* __restrict bottom_time,
+                 double* __restrict top_time)
+    {
+      for (std::size_t i = 0; i < n; ++i) {
+        double const anode = t[i] + anode_time[i];
+        anode_time[i] = anode;
+        bottom_time[i] = anode + (z[i] - z_min[i]) / plasma_speed;
+        top_time[i] = anode + (z_max[i] - z[i]) / plasma_speed;
+      }
+    }
+  } // namespace
+
+  geiger_digitizer::scratch::scratch(std::string const& random_id)
+    : rng_(make_random_stream(random_id))
+  {}
+
+  void
+  geiger_digitizer::scratch::clear()
+  {
+    events_.clear();
+  }
+
+  void
+  geiger_digitizer::scratch::add_event(step_hit_view hits,
+                                       std::int32_t run_number,
+                                       std::int32_t event_number,
+                                       cell_mask const* mask)
+  {
+    events_.push_back({hits, run_number, event_number, mask});
+  }
+
+  void
+  geiger_digitizer::scratch::resize_(std::size_t n)
+  {
+    for (auto* column : {&x_,
+                         &y_,
+                         &z_,
+                         &t_,
+                         &anode_x_,
+                         &anode_y_,
+                         &z_min_,
+                         &z_max_,
+                         &radius_,
+                         &anode_draw_,
+                         &bottom_draw_,
+                         &top_draw_,
+                         &anode_time_,
+                         &bottom_time_,
+                         &top_time_}) {
+      column->resize(n);
+    }
+    gid_.resize(n);
+    flags_.resize(n);
+  }
+
+  geiger_digitizer::geiger_digitizer()
+    : cells_(std::make_shared<tracker_cell_table const>())
+  {}
+
+  geiger_digitizer::geiger_digitizer(
+    std::shared_ptr<tracker_cell_table const> cells,
+    drift_model drift,
+    parameters const& p,
+    noise_model noise)
+    : cells_(std::move(cells))
+    , drift_(std::move(drift))
+    , parameters_(p)
+    , noise_(std::move(noise))
+  {
+    if (!cells_) {
+      throw std::logic_error("digitizer needs a cell table");
+    }
+    if (noise_.size() != 0 && noise_.size() != cells_->size()) {
+      throw std::logic_error("noise model is not for the digitizer's cells");
+    }
+  }
+
+  std::unique_ptr<geiger_digitizer::scratch>
+  geiger_digitizer::make_scratch() const
+  {
+    return std::unique_ptr<scratch>{new scratch{parameters_.random_id}};
+  }
+
+  void
+  geiger_digitizer::digitize(scratch& s) const
+  {
+    tracker_cell_table const& cells = *cells_;
+    // 1. Size columns for all step hits of the batch, growing them below
+    //    only if there are noise hits
+    std::size_t pending{0};
+    for (auto const& e : s.events_) {
+      pending += e.hits.size();
+    }
+    if (s.x_.size() < pending) {
+      s.resize_(pending);
+    }
+
+    // 2. Gather hits in unmasked cells, and draw each event's random numbers
+    //    in one call per column from the event's own stream, then its noise
+    s.offset_.assign(1, 0);
+    std::size_t row{0};
+    for (auto const& event : s.events_) {
+      pending -= event.hits.size();
+      cell_mask const* const mask = event.mask;
+      if (mask != nullptr && mask->size() != cells.size()) {
+        throw std::logic_error("cell mask is not for the digitizer's cells");
+      }
+      std::size_t const first = row;
+      for (auto const& hit : event.hits) {
+        std::uint64_t const key = pack_geom_id(hit.get().get_geom_id());
+        std::uint32_t const index = cells.index(key);
+        if (index == tracker_cell_table::invalid_index) {
+          throw std::logic_error("Geiger step hit is not in a tracker cell");
+        }
+        if (mask != nullptr && mask->test(index)) {
+          continue;
+        }
+        auto const& cell = cells[index];
+        auto const& ionization = hit.get().get_position_start();
+        s.gid_[row] = key;
+        s.x_[row] = ionization.x();
+        s.y_[row] = ionization.y();
+        s.z_[row] = ionization.z();
+        s.t_[row] = hit.get().get_time_start();
+        s.anode_x_[row] = cell.anode_x;
+        s.anode_y_[row] = cell.anode_y;
+        s.z_min_[row] = cell.z_min;
+        s.z_max_[row] = cell.z_max;
+        ++row;
+      }
+      s.offset_.push_back(row);
+
+      std::size_t const count = row - first;
+      s.rng_->reseed(parameters_.random_seed, event.run, event.event);
+      s.rng_->fill_uniform(s.anode_draw_.data() + first, count);
+      s.rng_->fill_uniform(s.bottom_draw_.data() + first, count);
+      s.rng_->fill_uniform(s.top_draw_.data() + first, count);
+
+      if (noise_.mean_hits() > 0.0) {
+        std::size_t const nNoise = noise_.count(*s.rng_);
+        if (s.x_.size() < row + nNoise + pending) {
+          s.resize_(row + nNoise + pending);
+        }
+        for (std::size_t j = 0; j < nNoise; ++j) {
+          std::uint32_t const index = noise_.cell(s.rng_->uniform());
+          double const t = noise_.window() * s.rng_->uniform();
+          double const u = s.rng_->uniform();
+          double const bottom = s.rng_->uniform();
+          double const top = s.rng_->uniform();
+          if (mask != nullptr && mask->test(index)) {
+            continue;
+          }
+          auto const& cell = cells[index];
+          s.gid_[row] = cells.gid(index);
+          s.x_[row] = cell.anode_x;
+          s.y_[row] = cell.anode_y;
+          s.z_[row] = cell.z_min + u * cell.length;
+          s.t_[row] = t;
+          s.anode_x_[row] = cell.anode_x;
+          s.anode_y_[row] = cell.anode_y;
+          s.z_min_[row] = cell.z_min;
+          s.z_max_[row] = cell.z_max;
+          s.anode_draw_[row] = 0.0;
+          s.bottom_draw_[row] = bottom;
+          s.top_draw_[row] = top;
+          ++row;
+        }
+        s.offset_.back() = row;
+      }
+    }
+    std::size_t const n = row;
+
+    // 3. Sweep all hits of the batch
+    drift_radii(n,
+                s.x_.data(),
+                s.y_.data(),
+                s.anode_x_.data(),
+                s.anode_y_.data(),
+                s.radius_.data());
+    drift_.time(s.radius_.data(), s.anode_time_.data(), n);
+    signal_times(n,
+                 s.z_.data(),
+                 s.t_.data(),
+                 s.z_min_.data(),
+                 s.z_max_.data(),
+                 parameters_.plasma_speed,
+                 s.anode_time_.data(),
+                 s.bottom_time_.data(),
+                 s.top_time_.data());
+
+    double const anode_efficiency = parameters_.anode_efficiency;
+    double const cathode_efficiency = parameters_.cathode_efficiency;
+    for (std::size_t i = 0; i < n; ++i) {
+      s.flags_[i] =
+        (s.anode_draw_[i] <= anode_efficiency ? anode_fired : 0) |
+        (s.bottom_draw_[i] < cathode_efficiency ?
+           raw_tracker_hit_buffer::bottom_cathode :
+           0) |
+        (s.top_draw_[i] < cathode_efficiency ?
+           raw_tracker_hit_buffer::top_cathode :
+           0);
+    }
+  }
+
+  raw_tracker_hit_buffer const&
+  geiger_digitizer::raw_hits(scratch& s, std::size_t e) const
+  {
+    raw_tracker_hit_buffer& output = s.raw_hits_;
+    gid_index_map& hit_index = s.hit_index_;
+    std::size_t const first = s.offset_[e];
+    std::size_t const last = s.offset_[e + 1];
+
+    // Rows already in output, by packed GID, so that merging a step hit
+    // costs amortised O(1) rather than a scan of output
+    output.clear();
+    output.reserve(last - first);
+    hit_index.clear();
+    hit_index.reserve(last - first);
+
+    for (std::size_t i = first; i < last; ++i) {
+      if (!(s.flags_[i] & anode_fired)) {
+        continue;
+      }
+      std::uint8_t const flags = s.flags_[i] & ~anode_fired;
+      double const anode_time = s.anode_time_[i];
+      double const bottom_time =
+        (flags & raw_tracker_hit_buffer::bottom_cathode) ?
+          s.bottom_time_[i] :
+          datatools::invalid_real();
+      double const top_time = (flags & raw_tracker_hit_buffer::top_cathode) ?
+                                s.top_time_[i] :
+                                datatools::invalid_real();
+
+      // Insert directly if GID not used before, else keep earliest anode time
+      auto slot = hit_index.try_emplace(s.gid_[i], output.size());
+      if (slot.second) {
+        output.push_back(s.gid_[i], anode_time, bottom_time, top_time, flags);
+      }
+      else if (anode_time < output.anode_times()[*slot.first]) {
+        output.update(*slot.first, anode_time, bottom_time, top_time, flags);
+      }
+    }
+    return output;
+  }
+} /* falaise */
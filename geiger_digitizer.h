@@ -0,0 +1,190 @@
+#ifndef FALAISE_GEIGER_DIGITIZER_H
+#define FALAISE_GEIGER_DIGITIZER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "cell_mask.h"
+#include "drift_model.h"
+#include "gid_index_map.h"
+#include "noise_model.h"
+#include "random_stream.h"
+#include "raw_tracker_hit_buffer.h"
+#include "step_hit_view.h"
+#include "tracker_cell_table.h"
+
+namespace falaise {
+  //! Mock digitization of Geiger step hits into raw tracker hits
+  /*
+   * Digitizes the step hits of a batch of events in one pass:
+   *
+   * 1. Anode fires with probability anode_efficiency, at the ionization
+   *    time plus the drift time from its distance to the anode, given by
+   *    a drift_model
+   * 2. Each cathode is seen with probability cathode_efficiency, at the
+   *    anode time plus the time for the plasma to propagate from the
+   *    ionization z to that end of the cell
+   * 3. Hits of an event in the same cell are merged, keeping the one with
+   *    the earliest anode time
+   *
+   * Noise hits drawn from a noise_model are added to each event as step
+   * hits on the anode wire at a uniform time in [0, window) and uniform z,
+   * that always fire the anode, before step 2. Step hits, noise included,
+   * in cells masked for their event (see scratch::add_event) are dropped
+   * before any of this.
+   *
+   * Random numbers for an event come from a random_stream reseeded from
+   * (random_seed, run, event), so results depend only on event identity, not
+   * on processing order or batching.
+   *
+   * All working storage is held in a scratch object that is reused across
+   * batches. Once it has grown to the largest batch, digitizing makes no
+   * heap allocations. The digitizer itself is immutable, so may be shared by
+   * threads each using their own scratch.
+   */
+  class geiger_digitizer {
+  public:
+    struct parameters {
+      double anode_efficiency{0.98};       //< P(step hit fires anode)
+      double cathode_efficiency{0.95};     //< P(cathode signal), each end
+      double plasma_speed{0.05};           //< plasma speed along z (mm/ns)
+      std::string random_id{"philox4x32"}; //< random_stream engine
+      std::uint64_t random_seed{12345};    //< seeds streams with run/event
+    };
+
+    //! Working storage for digitizing batches of events
+    class scratch {
+    public:
+      //! Construct storage drawing random numbers from engine random_id
+      explicit scratch(std::string const& random_id);
+
+      //! Remove all events, keeping the allocated storage
+      void clear();
+
+      //! Append an event to the batch
+      /*
+       * Hits in cells masked by mask, if it is not null, are dropped. hits
+       * and mask must stay valid until the batch is digitized.
+       */
+      void add_event(step_hit_view hits,
+                     std::int32_t run_number,
+                     std::int32_t event_number,
+                     cell_mask const* mask = nullptr);
+
+      //! Return the number of events in the batch
+      std::size_t
+      events() const
+      {
+        return events_.size();
+      }
+
+    private:
+      friend class geiger_digitizer;
+
+      //! Step hits, identity and masked cells of an event
+      struct event_ {
+        step_hit_view hits;
+        std::int32_t run;
+        std::int32_t event;
+        cell_mask const* mask;
+      };
+
+      //! Resize all per-hit columns to n rows
+      void resize_(std::size_t n);
+
+      std::unique_ptr<random_stream> rng_; //< reseeded per event
+      std::vector<event_> events_;         //< events of the batch
+      std::vector<std::size_t> offset_;    //< first row of each event, then end
+      // Per-hit columns, for all events of the batch
+      std::vector<std::uint64_t> gid_;     //< packed geom_id of hit cell
+      std::vector<double> x_, y_, z_;      //< ionization position...
+      std::vector<double> t_;              //< ... and time
+      std::vector<double> anode_x_;        //< hit cell geometry...
+      std::vector<double> anode_y_;        //
+      std::vector<double> z_min_;          //
+      std::vector<double> z_max_;          //< ... from the cell table
+      std::vector<double> radius_;         //< distance from anode wire
+      std::vector<double> anode_draw_;     //< uniforms deciding if the...
+      std::vector<double> bottom_draw_;    //
+      std::vector<double> top_draw_;       //< ... anode and cathodes fire
+      std::vector<double> anode_time_;     //< digitized times...
+      std::vector<double> bottom_time_;    //
+      std::vector<double> top_time_;       //
+      std::vector<std::uint8_t> flags_;    //< ... and which are present
+      // Per-event output
+      gid_index_map hit_index_;            //< packed geom_id -> raw hit row
+      raw_tracker_hit_buffer raw_hits_;    //< raw hits of one event
+    };
+
+    //! Construct a digitizer with no cells
+    geiger_digitizer();
+
+    //! Construct a digitizer for hits in cells, drifting as drift
+    /*
+     * cells are shared rather than copied, as a full tracker's table is
+     * held once for all modules (see shared_tracker_cells).
+     *
+     * \throw std::logic_error if cells is null, or noise is not empty or
+     * for cells
+     */
+    geiger_digitizer(std::shared_ptr<tracker_cell_table const> cells,
+                     drift_model drift,
+                     parameters const& p,
+                     noise_model noise = {});
+
+    //! Return the cell table
+    tracker_cell_table const&
+    cells() const
+    {
+      return *cells_;
+    }
+
+    //! Return the drift time/radius relation
+    drift_model const&
+    drift() const
+    {
+      return drift_;
+    }
+
+    //! Return the parameters
+    parameters const&
+    get_parameters() const
+    {
+      return parameters_;
+    }
+
+    //! Return the noise model
+    noise_model const&
+    noise() const
+    {
+      return noise_;
+    }
+
+    //! Return new working storage for this digitizer
+    std::unique_ptr<scratch> make_scratch() const;
+
+    //! Digitize the step hits of all events added to s
+    /*
+     * \throw std::logic_error if a step hit is not in a cell of the table,
+     * or a mask is not the size of the table
+     */
+    void digitize(scratch& s) const;
+
+    //! Return the raw hits of event e of the batch last digitized in s
+    /*
+     * The returned buffer is owned by s, and overwritten by the next call
+     */
+    raw_tracker_hit_buffer const& raw_hits(scratch& s, std::size_t e) const;
+
+  private:
+    std::shared_ptr<tracker_cell_table const> cells_;
+    drift_model drift_;
+    parameters parameters_;
+    noise_model noise_;
+  };
+} /* falaise */
+
+#endif /* FALAISE_GEIGER_DIGITIZER_H */
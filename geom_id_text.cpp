@@ -0,0 +1,83 @@
+#include "geom_id_text.h"
+
+#include <istream>
+#include <sstream>
+
+#include "packed_geom_id.h"
+#include "tracker_cell_table.h"
+
+namespace falaise {
+  namespace {
+    //! Read the text, calling row with each line's geom_id as written
+    void
+    readRows(std::istream& in,
+             std::function<void(std::string const& id,
+                                std::uint64_t gid,
+                                std::istream& fields)> const& row)
+    {
+      std::string line;
+      for (std::size_t lineNumber = 1; std::getline(in, line); ++lineNumber) {
+        line = line.substr(0, line.find('#'));
+        std::istringstream fields{line};
+        std::string id;
+        if (!(fields >> id)) {
+          continue;
+        }
+
+        auto error = [lineNumber](std::string const& what) {
+          return bad_geom_id_text_error("line " + std::to_string(lineNumber) +
+                                        ": " + what);
+        };
+        geomtools::geom_id gid;
+        if (!parse_geom_id(id, gid)) {
+          throw error("malformed geom_id '" + id + "'");
+        }
+        std::uint64_t key{0};
+        try {
+          key = pack_geom_id(gid);
+        }
+        catch (unpackable_geom_id_error const&) {
+          throw error("geom_id '" + id + "' cannot be packed");
+        }
+        try {
+          row(id, key, fields);
+        }
+        catch (bad_geom_id_text_error const& e) {
+          throw error(e.what());
+        }
+        std::string extra;
+        if (fields >> extra) {
+          throw error("unexpected '" + extra + "'");
+        }
+      }
+    }
+  } // namespace
+
+  void
+  read_geom_id_text(
+    std::istream& in,
+    std::function<void(std::uint64_t gid, std::istream& fields)> const& row)
+  {
+    readRows(in,
+             [&row](std::string const&, std::uint64_t gid,
+                    std::istream& fields) { row(gid, fields); });
+  }
+
+  void
+  read_tracker_cell_text(
+    std::istream& in,
+    tracker_cell_table const& cells,
+    std::function<void(std::uint32_t index, std::istream& fields)> const& row)
+  {
+    readRows(
+      in,
+      [&](std::string const& id, std::uint64_t gid, std::istream& fields) {
+        std::uint32_t const index = cells.index(gid);
+        if (index == tracker_cell_table::invalid_index) {
+          throw bad_geom_id_text_error("geom_id '" + id +
+                                       "' is not a tracker cell");
+        }
+        row(index, fields);
+      });
+  }
+} /* falaise */
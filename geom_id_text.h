@@ -0,0 +1,52 @@
+#ifndef FALAISE_GEOM_ID_TEXT_H
+#define FALAISE_GEOM_ID_TEXT_H
+
+#include <cstdint>
+#include <functional>
+#include <iosfwd>
+#include <stdexcept>
+#include <string>
+
+namespace falaise {
+  class tracker_cell_table;
+
+  //! Exception thrown on an invalid line of geom_id keyed text
+  class bad_geom_id_text_error : public std::runtime_error {
+    using std::runtime_error::runtime_error;
+  };
+
+  //! Read rows of fields keyed by geom_id from text, one per line
+  /*
+   * Lines hold a geom_id, as read by @ref parse_geom_id, then the row's
+   * fields, separated by whitespace, e.g.
+   *
+   *     # geom_id      rate
+   *     [1204:0.1.2.3] 250
+   *
+   * Text after '#' and blank lines are ignored. row is called with the
+   * packed geom_id of each line and a stream of its fields, which it must
+   * read all of, throwing bad_geom_id_text_error if they are invalid.
+   *
+   * \throw bad_geom_id_text_error on a malformed or unpackable geom_id,
+   * fields row rejects or leaves unread, with a message starting with the
+   * line number
+   */
+  void read_geom_id_text(
+    std::istream& in,
+    std::function<void(std::uint64_t gid, std::istream& fields)> const& row);
+
+  //! Read rows of fields keyed by tracker cell from text, one per line
+  /*
+   * As @ref read_geom_id_text, but row is called with the dense index in
+   * cells (see tracker_cell_table::index) of each line's cell.
+   *
+   * \throw bad_geom_id_text_error as read_geom_id_text, or on a geom_id
+   * not in cells
+   */
+  void read_tracker_cell_text(
+    std::istream& in,
+    tracker_cell_table const& cells,
+    std::function<void(std::uint32_t index, std::istream& fields)> const& row);
+} /* falaise */
+
+#endif /* FALAISE_GEOM_ID_TEXT_H */
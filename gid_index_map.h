@@ -0,0 +1,161 @@
+#ifndef FALAISE_GID_INDEX_MAP_H
+#define FALAISE_GID_INDEX_MAP_H
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace falaise {
+  //! Open addressing hash table from packed geom_id keys to indices
+  /*
+   * Designed for per-event deduplication of hits by detector cell: keys are
+   * 64 bit packed geom_ids (see @ref pack_geom_id), values are indices into
+   * the caller's hit storage.
+   *
+   * Slots are stored contiguously and probed linearly, so a lookup costs one
+   * hash plus (typically) a single cache line. Each slot is stamped with the
+   * "epoch" in which it was filled, so that clear() is O(1) and a map can be
+   * reused across events without touching its storage.
+   */
+  class gid_index_map {
+  public:
+    using key_type = std::uint64_t;
+    using mapped_type = std::uint32_t;
+
+    //! Construct a map able to hold expected_size keys without rehashing
+    explicit gid_index_map(std::size_t expected_size = 64)
+    {
+      reserve(expected_size);
+    }
+
+    //! Insert the key-value pair if key is not already held
+    /*
+     * \returns pair of a pointer to the value mapped to key and a bool that
+     * is true if the pair was inserted, false if key was already present
+     */
+    std::pair<mapped_type*, bool>
+    try_emplace(key_type key, mapped_type value)
+    {
+      if (2 * (size_ + 1) > slots_.size()) {
+        rehash_(2 * slots_.size());
+      }
+
+      slot_* s = probe_(key);
+      if (s->epoch == epoch_) {
+        return {&(s->value), false};
+      }
+      *s = slot_{key, value, epoch_};
+      ++size_;
+      return {&(s->value), true};
+    }
+
+    //! Return pointer to the value mapped to key, nullptr if key is not held
+    mapped_type const*
+    find(key_type key) const
+    {
+      slot_ const* s = const_cast<gid_index_map*>(this)->probe_(key);
+      return s->epoch == epoch_ ? &(s->value) : nullptr;
+    }
+
+    //! Return the number of keys held
+    std::size_t
+    size() const
+    {
+      return size_;
+    }
+
+    //! Return true if no keys are held
+    bool
+    empty() const
+    {
+      return size_ == 0;
+    }
+
+    //! Return the number of slots allocated
+    std::size_t
+    capacity() const
+    {
+      return slots_.size();
+    }
+
+    //! Ensure n keys can be held without rehashing
+    void
+    reserve(std::size_t n)
+    {
+      std::size_t required{16};
+      while (required < 2 * n) {
+        required *= 2;
+      }
+      if (required > slots_.size()) {
+        rehash_(required);
+      }
+    }
+
+    //! Remove all keys, keeping the allocated storage
+    void
+    clear()
+    {
+      size_ = 0;
+      if (++epoch_ == 0) {
+        // Epoch wrapped around, so slots could alias the new one
+        for (auto& s : slots_) {
+          s.epoch = 0;
+        }
+        epoch_ = 1;
+      }
+    }
+
+  private:
+    struct slot_ {
+      key_type key;
+      mapped_type value;
+      std::uint32_t epoch; //< slot is occupied iff epoch == map epoch
+    };
+
+    //! Mix bits of key (splitmix64 finalizer) as packed keys are structured
+    static std::uint64_t
+    hash_(key_type key)
+    {
+      key ^= key >> 30;
+      key *= 0xbf58476d1ce4e5b9ULL;
+      key ^= key >> 27;
+      key *= 0x94d049bb133111ebULL;
+      key ^= key >> 31;
+      return key;
+    }
+
+    //! Return the slot holding key, or the empty slot where it would go
+    slot_*
+    probe_(key_type key)
+    {
+      std::size_t const mask{slots_.size() - 1};
+      std::size_t i{static_cast<std::size_t>(hash_(key)) & mask};
+      while (slots_[i].epoch == epoch_ && slots_[i].key != key) {
+        i = (i + 1) & mask;
+      }
+      return &slots_[i];
+    }
+
+    //! Reallocate to n slots (a power of two) and reinsert held keys
+    void
+    rehash_(std::size_t n)
+    {
+      std::vector<slot_> old(n, slot_{0, 0, 0});
+      old.swap(slots_);
+      std::uint32_t const oldEpoch{epoch_};
+      epoch_ = 1;
+      for (auto const& s : old) {
+        if (s.epoch == oldEpoch) {
+          *probe_(s.key) = slot_{s.key, s.value, epoch_};
+        }
+      }
+    }
+
+    std::vector<slot_> slots_;   //< storage, size always a power of two
+    std::size_t size_{0};        //< number of occupied slots
+    std::uint32_t epoch_{1};     //< current fill epoch
+  };
+} /* falaise */
+
+#endif /* FALAISE_GID_INDEX_MAP_H */
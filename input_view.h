@@ -0,0 +1,67 @@
+#ifndef FALAISE_INPUT_VIEW_H
+#define FALAISE_INPUT_VIEW_H
+
+#include <cstddef>
+
+namespace falaise {
+  //! Borrowed, read-only view over a contiguous sequence of T
+  /*
+   * Lets modules read input collections held in the event (e.g. step hit
+   * handles in mctools::simulated_data, see step_hit_view.h) without
+   * copying them. A view does not own its elements, so must not outlive the
+   * collection it was created from, nor be used after that collection is
+   * modified.
+   */
+  template <typename T>
+  class input_view {
+  public:
+    using value_type = T;
+    using const_reference = T const&;
+    using const_iterator = T const*;
+    using size_type = std::size_t;
+
+    //! Construct an empty view
+    input_view() = default;
+
+    //! Construct a view of count elements starting at first
+    input_view(T const* first, size_type count) : first_(first), size_(count)
+    {}
+
+    //! Construct a view of a contiguous container (e.g. std::vector<T>)
+    template <typename Container>
+    input_view(Container const& c) : first_(c.data()), size_(c.size())
+    {}
+
+    const_iterator
+    begin() const
+    {
+      return first_;
+    }
+
+    const_iterator
+    end() const
+    {
+      return first_ + size_;
+    }
+
+    size_type
+    size() const
+    {
+      return size_;
+    }
+
+    bool
+    empty() const
+    {
+      return size_ == 0;
+    }
+
+    const_reference operator[](size_type i) const { return first_[i]; }
+
+  private:
+    T const* first_{nullptr}; //< first element viewed
+    size_type size_{0};       //< number of elements viewed
+  };
+} /* falaise */
+
+#endif /* FALAISE_INPUT_VIEW_H */
@@ -0,0 +1,112 @@
+#ifndef FALAISE_KWAY_MERGE_H
+#define FALAISE_KWAY_MERGE_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace falaise {
+  //! Exception thrown when a merged source is not in key order
+  class bad_merge_order_error : public std::logic_error {
+    using std::logic_error::logic_error;
+  };
+
+  //! Streaming merge of k sources, each in increasing key order
+  /*
+   * Items are pulled from the sources as they are needed, holding only the
+   * next item of each, so merging costs O(k) memory and O(log k) key
+   * comparisons per item whatever the sources' lengths (e.g. events
+   * processed by k workers, each reading its items back from a file).
+   *
+   * Items of equal key are returned in the order of their sources.
+   */
+  template <typename T>
+  class kway_merge {
+  public:
+    using item_ptr = std::unique_ptr<T>;
+    //! Return the next item of a source, nullptr at its end
+    using source_type = std::function<item_ptr()>;
+    //! Return the key of an item
+    using key_type = std::function<std::uint64_t(T const&)>;
+
+    //! Construct a merge of sources, ordered by key
+    /*
+     * Reads the first item of each source
+     */
+    kway_merge(std::vector<source_type> sources, key_type key)
+      : sources_(std::move(sources))
+      , key_(std::move(key))
+      , heads_(sources_.size())
+      , last_(sources_.size(), 0)
+    {
+      for (std::size_t s = 0; s < sources_.size(); ++s) {
+        pull_(s);
+      }
+    }
+
+    //! Return the item of least key left in any source, nullptr if none
+    /*
+     * \throw bad_merge_order_error if a source's items are not in order
+     */
+    item_ptr
+    next()
+    {
+      if (heap_.empty()) {
+        return nullptr;
+      }
+      std::pop_heap(heap_.begin(), heap_.end(), later_);
+      std::size_t const s = heap_.back().second;
+      heap_.pop_back();
+      item_ptr item = std::move(heads_[s]);
+      pull_(s);
+      return item;
+    }
+
+    //! Return the number of sources not yet exhausted
+    std::size_t
+    active() const
+    {
+      return heap_.size();
+    }
+
+  private:
+    using entry_ = std::pair<std::uint64_t, std::size_t>; //< key, source
+
+    //! Order of a min-heap on key then source
+    static bool
+    later_(entry_ const& a, entry_ const& b)
+    {
+      return a > b;
+    }
+
+    //! Read the next item of source s into the heap, if it has one
+    void
+    pull_(std::size_t s)
+    {
+      heads_[s] = sources_[s]();
+      if (!heads_[s]) {
+        return;
+      }
+      std::uint64_t const k = key_(*heads_[s]);
+      if (k < last_[s]) {
+        throw bad_merge_order_error("merge source is not in key order");
+      }
+      last_[s] = k;
+      heap_.emplace_back(k, s);
+      std::push_heap(heap_.begin(), heap_.end(), later_);
+    }
+
+    std::vector<source_type> sources_;
+    key_type key_;
+    std::vector<item_ptr> heads_;     //< next item of each source
+    std::vector<std::uint64_t> last_; //< ... and the key of its last
+    std::vector<entry_> heap_;        //< keys of heads, least first
+  };
+} /* falaise */
+
+#endif /* FALAISE_KWAY_MERGE_H */
@@ -0,0 +1,114 @@
+#include "noise_model.h"
+
+#include <algorithm>
+#include <cmath>
+#include <istream>
+#include <numeric>
+#include <string>
+
+#include "geom_id_text.h"
+
+namespace falaise {
+  namespace {
+    //! Largest Poisson mean sampled by a single inversion
+    /*
+     * Keeps exp(-mean) well clear of underflow, larger means are sampled as
+     * sums of Poisson deviates
+     */
+    double const kMaxInversionMean{64.0};
+  } // namespace
+
+  noise_model::noise_model(std::vector<double> rates, double window)
+    : rates_(std::move(rates)), window_(window)
+  {
+    if (!(window_ >= 0.0)) {
+      throw bad_noise_model_error("noise window must not be negative");
+    }
+    for (double r : rates_) {
+      if (!(r >= 0.0)) {
+        throw bad_noise_model_error("noise rates must not be negative");
+      }
+    }
+    double const total = std::accumulate(rates_.begin(), rates_.end(), 0.0);
+    mean_hits_ = window_ * total;
+    if (!(mean_hits_ > 0.0)) {
+      return;
+    }
+
+    // Vose's construction: bins of cells with less than the average rate
+    // are topped up from a cell with more
+    std::size_t const n = rates_.size();
+    std::vector<double> scaled(n);
+    std::vector<std::uint32_t> small;
+    std::vector<std::uint32_t> large;
+    for (std::uint32_t i = 0; i < n; ++i) {
+      scaled[i] = rates_[i] * n / total;
+      (scaled[i] < 1.0 ? small : large).push_back(i);
+    }
+    alias_.resize(n);
+    while (!small.empty() && !large.empty()) {
+      std::uint32_t const s = small.back();
+      std::uint32_t const l = large.back();
+      small.pop_back();
+      large.pop_back();
+      alias_[s] = {scaled[s], l};
+      scaled[l] -= 1.0 - scaled[s];
+      (scaled[l] < 1.0 ? small : large).push_back(l);
+    }
+    // Left over bins are full, up to rounding
+    for (auto i : small) {
+      alias_[i] = {1.0, i};
+    }
+    for (auto i : large) {
+      alias_[i] = {1.0, i};
+    }
+  }
+
+  std::size_t
+  noise_model::count(random_stream& rng) const
+  {
+    std::size_t k{0};
+    double mean = mean_hits_;
+    while (mean > 0.0) {
+      double const m = std::min(mean, kMaxInversionMean);
+      mean -= m;
+      // Inversion by sequential search, so O(m) steps
+      double p = std::exp(-m);
+      double cdf = p;
+      double const u = rng.uniform();
+      std::size_t j{0};
+      while (u > cdf && p > 0.0) {
+        ++j;
+        p *= m / j;
+        cdf += p;
+      }
+      k += j;
+    }
+    return k;
+  }
+
+  std::vector<double>
+  read_noise_rates(std::istream& in,
+                   tracker_cell_table const& cells,
+                   double default_rate)
+  {
+    std::vector<double> rates(cells.size(), default_rate);
+    try {
+      read_tracker_cell_text(
+        in, cells, [&rates](std::uint32_t index, std::istream& fields) {
+          double rate{0.0};
+          if (!(fields >> rate)) {
+            throw bad_geom_id_text_error("expected a rate");
+          }
+          if (!(rate >= 0.0)) {
+            throw bad_geom_id_text_error("negative rate");
+          }
+          rates[index] = rate;
+        });
+    }
+    catch (bad_geom_id_text_error const& e) {
+      throw bad_noise_model_error(std::string{"noise rates "} + e.what());
+    }
+    return rates;
+  }
+} /* falaise */
@@ -0,0 +1,113 @@
+#ifndef FALAISE_NOISE_MODEL_H
+#define FALAISE_NOISE_MODEL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <stdexcept>
+#include <vector>
+
+#include "random_stream.h"
+#include "tracker_cell_table.h"
+
+namespace falaise {
+  //! Exception thrown when noise rates are invalid or cannot be read
+  class bad_noise_model_error : public std::runtime_error {
+    using std::runtime_error::runtime_error;
+  };
+
+  //! Uncorrelated noise hits in Geiger cells
+  /*
+   * Cell i, by dense cell index, fires at random at rate(i) hits per unit
+   * time, so the number of noise hits in an event's readout window is
+   * Poisson with mean window() times the sum of rates, and each falls in a
+   * cell chosen with probability proportional to its rate.
+   *
+   * Events are sampled as such, drawing the number of hits and then a cell
+   * per hit from a Walker alias table, so the cost scales with the number
+   * of noise hits rather than the number of cells.
+   */
+  class noise_model {
+  public:
+    //! Construct a model of no noise
+    noise_model() = default;
+
+    //! Construct a model of rates[i] hits per unit time in cell i
+    /*
+     * \throw bad_noise_model_error if a rate or window is negative
+     */
+    noise_model(std::vector<double> rates, double window);
+
+    //! Return the number of cells
+    std::size_t
+    size() const
+    {
+      return rates_.size();
+    }
+
+    //! Return the readout window over which noise hits are drawn
+    double
+    window() const
+    {
+      return window_;
+    }
+
+    //! Return the noise rate of the cell at index i
+    double
+    rate(std::uint32_t i) const
+    {
+      return rates_[i];
+    }
+
+    //! Return the mean number of noise hits per event
+    double
+    mean_hits() const
+    {
+      return mean_hits_;
+    }
+
+    //! Draw the number of noise hits of an event from rng
+    std::size_t count(random_stream& rng) const;
+
+    //! Return the cell index of a noise hit, for a uniform deviate u
+    std::uint32_t
+    cell(double u) const
+    {
+      double const x = u * alias_.size();
+      std::uint32_t const i = static_cast<std::uint32_t>(x);
+      return x - i < alias_[i].threshold ? i : alias_[i].alias;
+    }
+
+  private:
+    //! Alias table bin: keep its own cell below threshold, else alias
+    struct bin_ {
+      double threshold;
+      std::uint32_t alias;
+    };
+
+    std::vector<double> rates_; //< hits per unit time, by cell index
+    double window_{0.0};        //< readout window
+    double mean_hits_{0.0};     //< window_ times sum of rates_
+    std::vector<bin_> alias_;   //< by cell index, empty if no noise
+  };
+
+  //! Read noise rates of cells from text, one cell per line
+  /*
+   * Lines hold the geom_id of a cell of cells and its rate, e.g.
+   *
+   *     # Noisy since 2019-03, rates in Hz
+   *     [1204:0.1.2.3] 250
+   *
+   * Text after '#' and blank lines are ignored. Returns the rates by dense
+   * cell index, default_rate for cells not listed, as written: the caller
+   * applies units.
+   *
+   * \throw bad_noise_model_error on a malformed line, a cell not in cells,
+   * or a negative rate
+   */
+  std::vector<double> read_noise_rates(std::istream& in,
+                                       tracker_cell_table const& cells,
+                                       double default_rate);
+} /* falaise */
+
+#endif /* FALAISE_NOISE_MODEL_H */
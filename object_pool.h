@@ -0,0 +1,130 @@
+#ifndef FALAISE_OBJECT_POOL_H
+#define FALAISE_OBJECT_POOL_H
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace falaise {
+  //! Thread-safe pool of reusable objects
+  /*
+   * Hands out objects (e.g. per-event scratch buffers) to concurrent users,
+   * creating them on demand with the supplied factory. Objects are returned
+   * to the pool when the handle from acquire() is destroyed, keeping their
+   * state (e.g. allocated capacity) for the next user, so in steady state
+   * there is one object per concurrent user and none are created.
+   *
+   * Idle objects remember the thread that released them, and acquire()
+   * prefers one last used by the calling thread, so with a fixed set of
+   * worker threads each keeps reusing its own object (and the memory it
+   * has touched) rather than taking over another core's. Otherwise idle
+   * objects are reused last in, first out, so the most recently used (and
+   * so most likely cache-resident) object is handed out first.
+   *
+   * The pool must outlive all handles acquired from it.
+   */
+  template <typename T>
+  class object_pool {
+  private:
+    //! Deleter returning objects to their pool
+    struct releaser_ {
+      object_pool* pool;
+
+      void
+      operator()(T* object) const
+      {
+        pool->release_(object);
+      }
+    };
+
+  public:
+    using factory_type = std::function<std::unique_ptr<T>()>;
+    using handle = std::unique_ptr<T, releaser_>;
+
+    //! Construct a pool creating objects with factory
+    explicit object_pool(factory_type factory) : factory_(std::move(factory))
+    {}
+
+    //! Construct a pool of default constructed objects
+    object_pool() : object_pool([] { return std::unique_ptr<T>{new T}; }) {}
+
+    object_pool(object_pool const&) = delete;
+    object_pool& operator=(object_pool const&) = delete;
+
+    //! Return an idle object, or a new one if none are idle
+    handle
+    acquire()
+    {
+      {
+        std::lock_guard<std::mutex> lock{mutex_};
+        if (!idle_.empty()) {
+          // Newest object last used by this thread, else newest of all
+          auto const self = std::this_thread::get_id();
+          auto slot = idle_.end() - 1;
+          for (auto i = idle_.rbegin(); i != idle_.rend(); ++i) {
+            if (i->owner == self) {
+              slot = i.base() - 1;
+              break;
+            }
+          }
+          T* object = slot->object.release();
+          idle_.erase(slot);
+          return handle{object, releaser_{this}};
+        }
+      }
+      return handle{factory_().release(), releaser_{this}};
+    }
+
+    //! Return the number of idle objects
+    std::size_t
+    idle() const
+    {
+      std::lock_guard<std::mutex> lock{mutex_};
+      return idle_.size();
+    }
+
+    //! Call f with each idle object, e.g. to collect their state
+    template <typename F>
+    void
+    for_each_idle(F&& f)
+    {
+      std::lock_guard<std::mutex> lock{mutex_};
+      for (auto& e : idle_) {
+        f(*e.object);
+      }
+    }
+
+    //! Destroy all idle objects
+    void
+    clear()
+    {
+      std::lock_guard<std::mutex> lock{mutex_};
+      idle_.clear();
+    }
+
+  private:
+    void
+    release_(T* object)
+    {
+      entry_ e{std::unique_ptr<T>{object}, std::this_thread::get_id()};
+      std::lock_guard<std::mutex> lock{mutex_};
+      idle_.push_back(std::move(e));
+    }
+
+    //! Idle object and the thread that last used it
+    struct entry_ {
+      std::unique_ptr<T> object;
+      std::thread::id owner;
+    };
+
+    factory_type factory_;      //< creates objects on demand
+    mutable std::mutex mutex_;  //< guards idle_
+    std::vector<entry_> idle_;  //< objects not in use
+  };
+} /* falaise */
+
+#endif /* FALAISE_OBJECT_POOL_H */
@@ -0,0 +1,136 @@
+#ifndef FALAISE_PACKED_GEOM_ID_H
+#define FALAISE_PACKED_GEOM_ID_H
+
+#include <cstdint>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+#include "bayeux/geomtools/geom_id.h"
+
+namespace falaise {
+  //! Exception thrown when a geom_id does not fit in a packed key
+  class unpackable_geom_id_error : public std::logic_error {
+    using std::logic_error::logic_error;
+  };
+
+  //! Pack a geom_id into a 64 bit integer key
+  /*
+   * The key layout, from most to least significant bits, is
+   *
+   *   type(16) | addr0(8) | addr1(8) | addr2(8) | addr3(16) | depth(8)
+   *
+   * which covers geom_ids of depth up to four, e.g. Geiger cells as
+   * [module.side.layer.row], but not deeper ones such as calorimeter blocks
+   * (depth 5), which throw. Two geom_ids compare equal iff their keys do.
+   *
+   * \throw unpackable_geom_id_error if gid is deeper than four addresses, or
+   * has a type or address (including "any" or invalid ones) out of range
+   */
+  inline std::uint64_t
+  pack_geom_id(geomtools::geom_id const& gid)
+  {
+    static unsigned const widths[4] = {8, 8, 8, 16};
+    static unsigned const shifts[4] = {40, 32, 24, 8};
+
+    std::uint32_t const depth = gid.get_depth();
+    if (depth > 4 || gid.get_type() > 0xFFFF) {
+      throw unpackable_geom_id_error("geom_id cannot be packed in 64 bits");
+    }
+
+    std::uint64_t key{std::uint64_t{gid.get_type()} << 48 | depth};
+    for (std::uint32_t i = 0; i < depth; ++i) {
+      std::uint32_t const address = gid.get(i);
+      if (address >= (1u << widths[i])) {
+        throw unpackable_geom_id_error("geom_id address out of packing range");
+      }
+      key |= std::uint64_t{address} << shifts[i];
+    }
+    return key;
+  }
+
+  //! Return the type held in a key created by pack_geom_id
+  inline std::uint32_t
+  packed_type(std::uint64_t key)
+  {
+    return static_cast<std::uint32_t>(key >> 48);
+  }
+
+  //! Return the depth held in a key created by pack_geom_id
+  inline std::uint32_t
+  packed_depth(std::uint64_t key)
+  {
+    return key & 0xFF;
+  }
+
+  //! Return address i (< 4) held in a key created by pack_geom_id
+  inline std::uint32_t
+  packed_address(std::uint64_t key, std::uint32_t i)
+  {
+    static unsigned const widths[4] = {8, 8, 8, 16};
+    static unsigned const shifts[4] = {40, 32, 24, 8};
+    return (key >> shifts[i]) & ((1u << widths[i]) - 1);
+  }
+
+  //! Recover the geom_id from a key created by pack_geom_id
+  inline geomtools::geom_id
+  unpack_geom_id(std::uint64_t key)
+  {
+    geomtools::geom_id gid;
+    std::uint32_t const depth = packed_depth(key);
+    gid.set_depth(depth);
+    gid.set_type(packed_type(key));
+    for (std::uint32_t i = 0; i < depth; ++i) {
+      gid.set(i, packed_address(key, i));
+    }
+    return gid;
+  }
+
+  //! Parse a geom_id written as [type:a0.a1...], false if malformed
+  /*
+   * This is the format of geom_id's operator<<, limited to the four
+   * addresses a packed key can hold
+   */
+  inline bool
+  parse_geom_id(std::string const& s, geomtools::geom_id& gid)
+  {
+    if (s.size() < 4 || s.front() != '[' || s.back() != ']') {
+      return false;
+    }
+    std::istringstream in{s.substr(1, s.size() - 2)};
+    std::uint32_t type{0};
+    std::uint32_t a[4] = {0, 0, 0, 0};
+    char separator{0};
+    if (!(in >> type >> separator) || separator != ':') {
+      return false;
+    }
+    int depth{0};
+    do {
+      if (depth == 4 || !(in >> a[depth])) {
+        return false;
+      }
+      ++depth;
+    } while (in >> separator && separator == '.');
+    if (!in.eof()) {
+      return false;
+    }
+    switch (depth) {
+    case 1:
+      gid = geomtools::geom_id{type, a[0]};
+      return true;
+    case 2:
+      gid = geomtools::geom_id{type, a[0], a[1]};
+      return true;
+    case 3:
+      gid = geomtools::geom_id{type, a[0], a[1], a[2]};
+      return true;
+    case 4:
+      gid = geomtools::geom_id{type, a[0], a[1], a[2], a[3]};
+      return true;
+    default:
+      return false;
+    }
+  }
+} /* falaise */
+
+#endif /* FALAISE_PACKED_GEOM_ID_H */
@@ -0,0 +1,256 @@
+#include "parallel_pipeline.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+#include "bayeux/datatools/library_loader.h"
+#include "bayeux/datatools/multi_properties.h"
+#include "bayeux/datatools/service_manager.h"
+#include "bayeux/dpp/base_module.h"
+#include "bayeux/dpp/module_manager.h"
+
+#include "concurrent_queue.h"
+
+namespace {
+  //! Type of multi_properties sections that configure flreconstruct itself
+  const std::string kSectionType{"flreconstruct::section"};
+
+  //! Event in flight with its position in the source
+  struct SequencedEvent {
+    std::size_t seq;
+    falaise::parallel_pipeline::event_ptr event;
+    dpp::base_module::process_status status;
+  };
+
+  //! Counting limit on events read but not yet written
+  class InFlightLimit {
+  public:
+    explicit InFlightLimit(std::size_t limit) : available_(limit) {}
+
+    //! Block until an event may be read, false if cancelled
+    bool
+    acquire()
+    {
+      std::unique_lock<std::mutex> lock{mutex_};
+      released_.wait(lock, [this] { return cancelled_ || available_ > 0; });
+      if (cancelled_) {
+        return false;
+      }
+      --available_;
+      return true;
+    }
+
+    void
+    release()
+    {
+      std::lock_guard<std::mutex> lock{mutex_};
+      ++available_;
+      released_.notify_one();
+    }
+
+    void
+    cancel()
+    {
+      std::lock_guard<std::mutex> lock{mutex_};
+      cancelled_ = true;
+      released_.notify_all();
+    }
+
+  private:
+    std::size_t available_;
+    bool cancelled_{false};
+    std::mutex mutex_;
+    std::condition_variable released_;
+  };
+} // namespace
+
+namespace falaise {
+  void
+  load_pipeline_plugins(datatools::multi_properties const& config,
+                        datatools::library_loader& loader)
+  {
+    const std::string section{"flreconstruct.plugins"};
+    if (!config.has_key(section)) {
+      return;
+    }
+    auto const& props = config.get(section).get_properties();
+    if (!props.has_key("plugins")) {
+      return;
+    }
+    std::vector<std::string> plugins;
+    props.fetch("plugins", plugins);
+    for (auto const& p : plugins) {
+      std::string directory;
+      if (props.has_key(p + ".directory")) {
+        directory = props.fetch_string(p + ".directory");
+      }
+      if (loader.load(p, directory) != 0) {
+        throw bad_pipeline_config_error("failed to load plugin '" + p + "'");
+      }
+    }
+  }
+
+  dpp::base_module&
+  load_pipeline_modules(datatools::multi_properties const& config,
+                        datatools::service_manager& services,
+                        std::string const& module,
+                        dpp::module_manager& manager)
+  {
+    if (!config.has_key(module)) {
+      throw bad_pipeline_config_error("no module '" + module +
+                                      "' in pipeline configuration");
+    }
+    manager.set_service_manager(services);
+    for (auto const& key : config.ordered_keys()) {
+      auto const& section = config.get(key);
+      if (section.get_meta() != kSectionType) {
+        manager.load_module(key, section.get_meta(), section.get_properties());
+      }
+    }
+    manager.initialize_simple();
+    return manager.grab(module);
+  }
+
+  parallel_pipeline::parallel_pipeline(
+    datatools::multi_properties const& config,
+    datatools::service_manager& services,
+    options const& opts)
+    : options_(opts)
+  {
+    if (options_.workers == 0) {
+      options_.workers = std::max(1u, std::thread::hardware_concurrency());
+    }
+    if (options_.max_in_flight == 0) {
+      options_.max_in_flight = 4 * options_.workers;
+    }
+
+    for (std::size_t w = 0; w < options_.workers; ++w) {
+      std::unique_ptr<dpp::module_manager> manager{new dpp::module_manager};
+      modules_.push_back(
+        &load_pipeline_modules(config, services, options_.module, *manager));
+      managers_.push_back(std::move(manager));
+    }
+  }
+
+  parallel_pipeline::~parallel_pipeline()
+  {
+    for (auto& m : managers_) {
+      m->reset();
+    }
+  }
+
+  parallel_pipeline::statistics
+  parallel_pipeline::run(source_type const& source, sink_type const& sink)
+  {
+    statistics stats;
+    bounded_queue<SequencedEvent> input{options_.max_in_flight};
+    bounded_queue<SequencedEvent> output{options_.max_in_flight};
+    InFlightLimit inFlight{options_.max_in_flight};
+
+    // First failure on any thread, which stops all of them
+    std::mutex failureMutex;
+    std::exception_ptr failure;
+    auto fail = [&](std::exception_ptr e) {
+      {
+        std::lock_guard<std::mutex> lock{failureMutex};
+        if (!failure) {
+          failure = e;
+        }
+      }
+      inFlight.cancel();
+      input.close();
+      output.close();
+    };
+
+    // Workers: process events in whatever order they arrive
+    std::vector<std::thread> workers;
+    for (auto* module : modules_) {
+      workers.emplace_back([&, module] {
+        SequencedEvent e;
+        while (input.pop(e)) {
+          try {
+            e.status = module->process(*e.event);
+            if (e.status & dpp::base_module::PROCESS_FATAL) {
+              throw pipeline_fatal_error("module '" + options_.module +
+                                         "' failed processing event " +
+                                         std::to_string(e.seq));
+            }
+          }
+          catch (...) {
+            fail(std::current_exception());
+            return;
+          }
+          if (!output.push(e)) {
+            return;
+          }
+        }
+      });
+    }
+
+    // Writer: one sink call at a time, in sequence if ordered
+    std::thread writer{[&] {
+      auto write = [&](SequencedEvent& e) {
+        if (e.status == dpp::base_module::PROCESS_OK) {
+          sink(*e.event);
+          ++stats.written;
+        }
+        else if (e.status & dpp::base_module::PROCESS_STOP) {
+          ++stats.stopped;
+        }
+        else {
+          ++stats.errors;
+        }
+        e.event.reset();
+        inFlight.release();
+      };
+
+      reorder_buffer<SequencedEvent> pending;
+      SequencedEvent e;
+      try {
+        while (output.pop(e)) {
+          if (!options_.ordered) {
+            write(e);
+            continue;
+          }
+          pending.insert(e.seq, std::move(e));
+          while (pending.release(e)) {
+            write(e);
+          }
+        }
+      }
+      catch (...) {
+        fail(std::current_exception());
+      }
+    }};
+
+    // Reader, on this thread
+    try {
+      for (std::size_t seq = 0; inFlight.acquire(); ++seq) {
+        SequencedEvent e{seq, source(), dpp::base_module::PROCESS_OK};
+        if (!e.event || !input.push(e)) {
+          break;
+        }
+        ++stats.read;
+      }
+    }
+    catch (...) {
+      fail(std::current_exception());
+    }
+
+    input.close();
+    for (auto& w : workers) {
+      w.join();
+    }
+    output.close();
+    writer.join();
+
+    if (failure) {
+      std::rethrow_exception(failure);
+    }
+    return stats;
+  }
+} /* falaise */
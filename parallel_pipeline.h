@@ -0,0 +1,138 @@
+#ifndef FALAISE_PARALLEL_PIPELINE_H
+#define FALAISE_PARALLEL_PIPELINE_H
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "bayeux/datatools/things.h"
+
+namespace datatools {
+  class library_loader;
+  class multi_properties;
+  class service_manager;
+}
+
+namespace dpp {
+  class base_module;
+  class module_manager;
+}
+
+namespace falaise {
+  //! Exception thrown when a pipeline cannot be configured
+  class bad_pipeline_config_error : public std::logic_error {
+    using std::logic_error::logic_error;
+  };
+
+  //! Exception thrown when a pipeline module reports a fatal error
+  class pipeline_fatal_error : public std::runtime_error {
+    using std::runtime_error::runtime_error;
+  };
+
+  //! Load the plugins listed in a pipeline's flreconstruct.plugins section
+  /*
+   * Reads the section as flreconstruct does: the "plugins" string list, and
+   * an optional "<plugin>.directory" for each. Does nothing if the section
+   * is not present.
+   *
+   * \throw bad_pipeline_config_error if a plugin cannot be loaded
+   */
+  void load_pipeline_plugins(datatools::multi_properties const& config,
+                             datatools::library_loader& loader);
+
+  //! Load and initialize a pipeline's modules, returning the named one
+  /*
+   * Sections of config whose type is "flreconstruct::section" are not
+   * modules and are skipped, plugins must already be loaded (see
+   * @ref load_pipeline_plugins).
+   *
+   * \throw bad_pipeline_config_error if module is not configured
+   */
+  dpp::base_module& load_pipeline_modules(
+    datatools::multi_properties const& config,
+    datatools::service_manager& services,
+    std::string const& module,
+    dpp::module_manager& manager);
+
+  //! Run a dpp module pipeline over events on a pool of worker threads
+  /*
+   * Modules are configured from a multi_properties file as used by
+   * flreconstruct (e.g. MockTrackerCalibrator.conf), and each worker gets
+   * its own instance of every module, so modules need not be thread-safe.
+   * Workers share the service manager, whose services must be initialized
+   * and safe to read concurrently (e.g. geometry).
+   *
+   * run() reads events from a source on the calling thread, hands them to
+   * the workers, and passes processed events to a sink on a dedicated
+   * writer thread. Sink calls are serialized, in source order if the
+   * ordered option is set, else in order of completion. The number of
+   * events read but not yet written is bounded, so memory use does not
+   * depend on the number of events.
+   *
+   * Events for which the pipeline module returns:
+   *
+   * - PROCESS_OK are passed to the sink
+   * - PROCESS_STOP are dropped (rejected, e.g. by a filter)
+   * - PROCESS_ERROR are dropped and counted
+   * - PROCESS_FATAL stop the run, which throws pipeline_fatal_error
+   */
+  class parallel_pipeline {
+  public:
+    using event_ptr = std::unique_ptr<datatools::things>;
+    //! Return the next event to process, nullptr at end of input
+    using source_type = std::function<event_ptr()>;
+    //! Consume a processed event
+    using sink_type = std::function<void(datatools::things&)>;
+
+    struct options {
+      std::string module{"pipeline"}; //< module processing each event
+      std::size_t workers{0};         //< worker threads, 0 for one per core
+      bool ordered{true};             //< write events in source order
+      std::size_t max_in_flight{0};   //< events read but not written,
+                                      //  0 for 4 per worker
+    };
+
+    struct statistics {
+      std::size_t read{0};    //< events read from the source
+      std::size_t written{0}; //< events passed to the sink
+      std::size_t stopped{0}; //< events rejected with PROCESS_STOP
+      std::size_t errors{0};  //< events failed with PROCESS_ERROR
+    };
+
+    //! Construct and initialize the modules of each worker
+    /*
+     * Modules are loaded by @ref load_pipeline_modules.
+     *
+     * \throw bad_pipeline_config_error if opts.module is not configured
+     */
+    parallel_pipeline(datatools::multi_properties const& config,
+                      datatools::service_manager& services,
+                      options const& opts);
+
+    ~parallel_pipeline();
+
+    //! Process all events from source, passing them to sink
+    /*
+     * Exceptions thrown by the source, modules or sink stop the run and are
+     * rethrown once all threads have finished.
+     */
+    statistics run(source_type const& source, sink_type const& sink);
+
+    //! Return the number of worker threads
+    std::size_t
+    workers() const
+    {
+      return modules_.size();
+    }
+
+  private:
+    options options_;
+    std::vector<std::unique_ptr<dpp::module_manager>> managers_;
+    std::vector<dpp::base_module*> modules_; //< pipeline module per worker
+  };
+} /* falaise */
+
+#endif /* FALAISE_PARALLEL_PIPELINE_H */
@@ -0,0 +1,226 @@
+#include "random_stream.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <random>
+
+namespace falaise {
+  namespace {
+    //! Seed sequence of four words, generating as std::seed_seq does
+    /*
+     * std::seed_seq copies its input to the heap, so reseeding per event
+     * with it allocates. This keeps the input in place and implements the
+     * same generate() algorithm ([rand.util.seedseq]), so engines are seeded
+     * identically.
+     */
+    class seed_seq4 {
+    public:
+      using result_type = std::uint32_t;
+
+      seed_seq4(std::uint32_t a,
+                std::uint32_t b,
+                std::uint32_t c,
+                std::uint32_t d)
+        : v_{a, b, c, d}
+      {}
+
+      template <typename Iterator>
+      void
+      generate(Iterator begin, Iterator end) const
+      {
+        std::size_t const n = end - begin;
+        if (n == 0) {
+          return;
+        }
+        std::fill(begin, end, 0x8b8b8b8bu);
+
+        std::size_t const s = 4;
+        std::size_t t = (n - 1) / 2;
+        if (n >= 623) {
+          t = 11;
+        }
+        else if (n >= 68) {
+          t = 7;
+        }
+        else if (n >= 39) {
+          t = 5;
+        }
+        else if (n >= 7) {
+          t = 3;
+        }
+        std::size_t const p = (n - t) / 2;
+        std::size_t const q = p + t;
+        std::size_t const m = std::max(s + 1, n);
+        auto at = [begin, n](std::size_t k) -> std::uint32_t& {
+          return begin[k % n];
+        };
+        auto mix = [](std::uint32_t x) { return x ^ (x >> 27); };
+
+        for (std::size_t k = 0; k < m; ++k) {
+          std::uint32_t const r1 =
+            1664525u * mix(at(k) ^ at(k + p) ^ at(k + n - 1));
+          std::uint32_t r2 = r1;
+          if (k == 0) {
+            r2 += s;
+          }
+          else if (k <= s) {
+            r2 += k % n + v_[k - 1];
+          }
+          else {
+            r2 += k % n;
+          }
+          at(k + p) += r1;
+          at(k + q) += r2;
+          at(k) = r2;
+        }
+        for (std::size_t k = m; k < m + n; ++k) {
+          std::uint32_t const r3 =
+            1566083941u * mix(at(k) + at(k + p) + at(k + n - 1));
+          std::uint32_t const r4 = r3 - k % n;
+          at(k + p) ^= r3;
+          at(k + q) ^= r4;
+          at(k) = r4;
+        }
+      }
+
+    private:
+      std::uint32_t v_[4];
+    };
+
+    //! Adapt a <random> engine, reseeding it from (seed, run, event)
+    /*
+     * Engine must produce at least 32 random bits per call
+     */
+    template <typename Engine>
+    class engine_stream : public random_stream {
+    public:
+      result_type
+      operator()() override
+      {
+        return static_cast<result_type>(engine_());
+      }
+
+      void
+      reseed(std::uint64_t seed, std::int32_t run, std::int32_t event) override
+      {
+        seed_seq4 seq{static_cast<std::uint32_t>(seed),
+                      static_cast<std::uint32_t>(seed >> 32),
+                      static_cast<std::uint32_t>(run),
+                      static_cast<std::uint32_t>(event)};
+        engine_.seed(seq);
+      }
+
+    private:
+      Engine engine_;
+    };
+
+    //! Philox stream keyed by seed, with (run, event) as stream identifier
+    class philox_stream : public random_stream {
+    public:
+      result_type
+      operator()() override
+      {
+        return engine_();
+      }
+
+      void
+      fill_uniform(double* out, std::size_t n) override
+      {
+        for (std::size_t i = 0; i < n; ++i) {
+          out[i] = to_uniform(engine_());
+        }
+      }
+
+      void
+      reseed(std::uint64_t seed, std::int32_t run, std::int32_t event) override
+      {
+        engine_ = philox4x32{{{static_cast<std::uint32_t>(seed),
+                               static_cast<std::uint32_t>(seed >> 32)}},
+                             {{0,
+                               0,
+                               static_cast<std::uint32_t>(run),
+                               static_cast<std::uint32_t>(event)}}};
+      }
+
+    private:
+      philox4x32 engine_;
+    };
+
+    template <typename Stream>
+    std::unique_ptr<random_stream>
+    make_stream()
+    {
+      return std::unique_ptr<random_stream>{new Stream};
+    }
+  } // namespace
+
+  philox4x32::counter_type
+  philox4x32::generate(counter_type ctr, key_type key)
+  {
+    std::uint64_t const M0{0xD2511F53};
+    std::uint64_t const M1{0xCD9E8D57};
+    std::uint32_t const W0{0x9E3779B9};
+    std::uint32_t const W1{0xBB67AE85};
+
+    for (int round = 0; round < 10; ++round) {
+      if (round > 0) {
+        key[0] += W0;
+        key[1] += W1;
+      }
+      std::uint64_t const p0 = M0 * ctr[0];
+      std::uint64_t const p1 = M1 * ctr[2];
+      ctr = {{static_cast<std::uint32_t>(p1 >> 32) ^ ctr[1] ^ key[0],
+              static_cast<std::uint32_t>(p1),
+              static_cast<std::uint32_t>(p0 >> 32) ^ ctr[3] ^ key[1],
+              static_cast<std::uint32_t>(p0)}};
+    }
+    return ctr;
+  }
+
+  random_stream_registry::random_stream_registry()
+  {
+    add("philox4x32", make_stream<philox_stream>);
+    add("mt19937", make_stream<engine_stream<std::mt19937>>);
+    add("mt19937_64", make_stream<engine_stream<std::mt19937_64>>);
+  }
+
+  random_stream_registry&
+  random_stream_registry::instance()
+  {
+    static random_stream_registry registry;
+    return registry;
+  }
+
+  void
+  random_stream_registry::add(std::string const& id, factory_type factory)
+  {
+    factories_[id] = std::move(factory);
+  }
+
+  bool
+  random_stream_registry::has(std::string const& id) const
+  {
+    return factories_.find(id) != factories_.end();
+  }
+
+  std::vector<std::string>
+  random_stream_registry::ids() const
+  {
+    std::vector<std::string> result;
+    for (auto const& f : factories_) {
+      result.push_back(f.first);
+    }
+    return result;
+  }
+
+  std::unique_ptr<random_stream>
+  random_stream_registry::create(std::string const& id) const
+  {
+    auto iter = factories_.find(id);
+    if (iter == factories_.end()) {
+      throw unknown_random_id_error("no random engine registered as '" + id +
+                                    "'");
+    }
+    return iter->second();
+  }
+} /* falaise */
@@ -0,0 +1,187 @@
+#ifndef FALAISE_RANDOM_STREAM_H
+#define FALAISE_RANDOM_STREAM_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace falaise {
+  //! Exception thrown when requesting an engine that is not registered
+  class unknown_random_id_error : public std::logic_error {
+    using std::logic_error::logic_error;
+  };
+
+  //! Philox4x32-10 counter-based random number generator
+  /*
+   * Implements the Philox4x32 bijection with 10 rounds from Salmon et al,
+   * "Parallel random numbers: as easy as 1, 2, 3" (SC'11). Output block n of
+   * a stream is a pure function of (key, counter + n), so streams need no
+   * state beyond those two and can be positioned anywhere in O(1).
+   *
+   * Counter words 0 and 1 hold the block number within the stream, words 2
+   * and 3 are free for the caller to identify the stream.
+   *
+   * Satisfies the UniformRandomBitGenerator requirements.
+   */
+  class philox4x32 {
+  public:
+    using result_type = std::uint32_t;
+    using counter_type = std::array<std::uint32_t, 4>;
+    using key_type = std::array<std::uint32_t, 2>;
+
+    //! Construct the stream starting at block counter under key
+    philox4x32(key_type const& key = {{0, 0}},
+               counter_type const& counter = {{0, 0, 0, 0}})
+      : key_(key), counter_(counter)
+    {}
+
+    static constexpr result_type
+    min()
+    {
+      return 0;
+    }
+
+    static constexpr result_type
+    max()
+    {
+      return 0xFFFFFFFF;
+    }
+
+    //! Return the next 32 bits of the stream
+    result_type
+    operator()()
+    {
+      if (next_ == 4) {
+        block_ = generate(counter_, key_);
+        next_ = 0;
+        // Increment the 64 bit block number in words 0 and 1
+        if (++counter_[0] == 0) {
+          ++counter_[1];
+        }
+      }
+      return block_[next_++];
+    }
+
+    //! Apply the Philox4x32-10 bijection to counter under key
+    static counter_type generate(counter_type counter, key_type key);
+
+  private:
+    key_type key_;
+    counter_type counter_;
+    counter_type block_ = {{0, 0, 0, 0}}; //< last generated output block
+    unsigned next_{4};                    //< next word of block_ to return
+  };
+
+  //! Stream of random bits for processing one event
+  /*
+   * A stream is positioned by reseed() at the start of the sequence
+   * for (seed, run, event), so the numbers an event sees depend only on its
+   * identity, and not on the order or thread in which events are processed.
+   *
+   * Satisfies the UniformRandomBitGenerator requirements, so can be used
+   * with the <random> distributions.
+   */
+  class random_stream {
+  public:
+    using result_type = std::uint32_t;
+
+    virtual ~random_stream() = default;
+
+    static constexpr result_type
+    min()
+    {
+      return 0;
+    }
+
+    static constexpr result_type
+    max()
+    {
+      return 0xFFFFFFFF;
+    }
+
+    //! Return the next 32 random bits
+    virtual result_type operator()() = 0;
+
+    //! Position the stream at the start of the sequence for an event
+    virtual void reseed(std::uint64_t seed,
+                        std::int32_t run,
+                        std::int32_t event) = 0;
+
+    //! Return a uniform deviate in (0, 1)
+    double
+    uniform()
+    {
+      return to_uniform((*this)());
+    }
+
+    //! Fill out[0, n) with the next n uniform deviates of the stream
+    /*
+     * Equivalent to n calls to uniform(), but engines may override it to
+     * avoid a virtual call per number.
+     */
+    virtual void
+    fill_uniform(double* out, std::size_t n)
+    {
+      for (std::size_t i = 0; i < n; ++i) {
+        out[i] = uniform();
+      }
+    }
+
+  protected:
+    //! Map 32 random bits to a uniform deviate in (0, 1)
+    static double
+    to_uniform(result_type bits)
+    {
+      return (bits + 0.5) * (1.0 / 4294967296.0);
+    }
+  };
+
+  //! Registry of random_stream engines, keyed by id
+  /*
+   * The engines "philox4x32" (counter-based, cheapest to reseed per event),
+   * "mt19937" and "mt19937_64" are always registered. Further engines can
+   * be added by id, e.g. for the "random.id" property of modules.
+   */
+  class random_stream_registry {
+  public:
+    using factory_type = std::function<std::unique_ptr<random_stream>()>;
+
+    //! Return the process-wide registry
+    static random_stream_registry& instance();
+
+    //! Register a factory for engine id, replacing any existing one
+    void add(std::string const& id, factory_type factory);
+
+    //! Return true if an engine is registered under id
+    bool has(std::string const& id) const;
+
+    //! Return the ids of all registered engines
+    std::vector<std::string> ids() const;
+
+    //! Return a new stream for engine id
+    /*
+     * \throw unknown_random_id_error if no engine is registered under id
+     */
+    std::unique_ptr<random_stream> create(std::string const& id) const;
+
+  private:
+    random_stream_registry();
+
+    std::map<std::string, factory_type> factories_;
+  };
+
+  //! Return a new stream for engine id from the process-wide registry
+  inline std::unique_ptr<random_stream>
+  make_random_stream(std::string const& id)
+  {
+    return random_stream_registry::instance().create(id);
+  }
+} /* falaise */
+
+#endif /* FALAISE_RANDOM_STREAM_H */
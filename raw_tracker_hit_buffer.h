@@ -0,0 +1,225 @@
+#ifndef FALAISE_RAW_TRACKER_HIT_BUFFER_H
+#define FALAISE_RAW_TRACKER_HIT_BUFFER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <vector>
+
+namespace falaise {
+  //! Structure-of-arrays buffer of raw (digitized) Geiger hits
+  /*
+   * Each hit is a row of five columns: the packed geom_id of its cell (see
+   * @ref pack_geom_id), the anode time, the two cathode times, and flags
+   * marking which cathode times are present. Columns are contiguous, so
+   * passes over hits (e.g. calibration) are linear scans with no per-hit
+   * heap allocation or pointer chasing.
+   *
+   * The buffer is intended to be reused across events: clear() keeps the
+   * allocated storage.
+   */
+  class raw_tracker_hit_buffer {
+  public:
+    //! Bits of a hit's flags column
+    enum flag : std::uint8_t {
+      bottom_cathode = 1 << 0, //< bottom cathode time is present
+      top_cathode = 1 << 1     //< top cathode time is present
+    };
+
+    //! Value copy of one row of the buffer
+    struct hit {
+      std::uint64_t gid;
+      double anode_time;
+      double bottom_cathode_time;
+      double top_cathode_time;
+      std::uint8_t flags;
+
+      bool
+      has_bottom_cathode_time() const
+      {
+        return flags & bottom_cathode;
+      }
+
+      bool
+      has_top_cathode_time() const
+      {
+        return flags & top_cathode;
+      }
+    };
+
+    //! Forward iterator over rows, yielding hits by value
+    class const_iterator {
+    public:
+      using iterator_category = std::forward_iterator_tag;
+      using value_type = hit;
+      using difference_type = std::ptrdiff_t;
+      using pointer = hit const*;
+      using reference = hit;
+
+      const_iterator(raw_tracker_hit_buffer const& b, std::size_t i)
+        : buffer_(&b), index_(i)
+      {}
+
+      hit operator*() const { return (*buffer_)[index_]; }
+
+      const_iterator& operator++()
+      {
+        ++index_;
+        return *this;
+      }
+
+      bool
+      operator==(const_iterator const& other) const
+      {
+        return index_ == other.index_;
+      }
+
+      bool
+      operator!=(const_iterator const& other) const
+      {
+        return !(*this == other);
+      }
+
+    private:
+      raw_tracker_hit_buffer const* buffer_;
+      std::size_t index_;
+    };
+
+    //! Return the memory used by one hit
+    static constexpr std::size_t
+    bytes_per_hit()
+    {
+      return sizeof(std::uint64_t) + 3 * sizeof(double) + sizeof(std::uint8_t);
+    }
+
+    // - Modifiers
+    //! Append a hit, returning its row index
+    std::size_t
+    push_back(std::uint64_t gid,
+              double anode,
+              double bottom,
+              double top,
+              std::uint8_t flags)
+    {
+      gid_.push_back(gid);
+      anode_.push_back(anode);
+      bottom_.push_back(bottom);
+      top_.push_back(top);
+      flags_.push_back(flags);
+      return gid_.size() - 1;
+    }
+
+    //! Replace the times and flags of the hit at row i
+    void
+    update(std::size_t i,
+           double anode,
+           double bottom,
+           double top,
+           std::uint8_t flags)
+    {
+      anode_[i] = anode;
+      bottom_[i] = bottom;
+      top_[i] = top;
+      flags_[i] = flags;
+    }
+
+    //! Remove all hits, keeping the allocated storage
+    void
+    clear()
+    {
+      gid_.clear();
+      anode_.clear();
+      bottom_.clear();
+      top_.clear();
+      flags_.clear();
+    }
+
+    //! Ensure n hits can be held without reallocation
+    void
+    reserve(std::size_t n)
+    {
+      gid_.reserve(n);
+      anode_.reserve(n);
+      bottom_.reserve(n);
+      top_.reserve(n);
+      flags_.reserve(n);
+    }
+
+    // - Observers
+    std::size_t
+    size() const
+    {
+      return gid_.size();
+    }
+
+    bool
+    empty() const
+    {
+      return gid_.empty();
+    }
+
+    std::size_t
+    capacity() const
+    {
+      return gid_.capacity();
+    }
+
+    //! Return a copy of the hit at row i
+    hit operator[](std::size_t i) const
+    {
+      return {gid_[i], anode_[i], bottom_[i], top_[i], flags_[i]};
+    }
+
+    const_iterator
+    begin() const
+    {
+      return {*this, 0};
+    }
+
+    const_iterator
+    end() const
+    {
+      return {*this, size()};
+    }
+
+    // - Column access
+    std::uint64_t const*
+    gids() const
+    {
+      return gid_.data();
+    }
+
+    double const*
+    anode_times() const
+    {
+      return anode_.data();
+    }
+
+    double const*
+    bottom_cathode_times() const
+    {
+      return bottom_.data();
+    }
+
+    double const*
+    top_cathode_times() const
+    {
+      return top_.data();
+    }
+
+    std::uint8_t const*
+    flags() const
+    {
+      return flags_.data();
+    }
+
+  private:
+    std::vector<std::uint64_t> gid_; //< packed geom_id of cell
+    std::vector<double> anode_;      //< anode time
+    std::vector<double> bottom_;     //< bottom cathode time
+    std::vector<double> top_;        //< top cathode time
+    std::vector<std::uint8_t> flags_;
+  };
+} /* falaise */
+
+#endif /* FALAISE_RAW_TRACKER_HIT_BUFFER_H */
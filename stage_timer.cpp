@@ -0,0 +1,149 @@
+#include "stage_timer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <ostream>
+#include <stdexcept>
+#include <thread>
+
+namespace falaise {
+  namespace {
+    //! Reference readings of both clocks, taken at static initialization
+    struct clock_origin {
+      std::uint64_t ticks{tick_clock::now()};
+      std::chrono::steady_clock::time_point time{
+        std::chrono::steady_clock::now()};
+    };
+    clock_origin const origin;
+  } // namespace
+
+  double
+  tick_clock::ns_per_tick()
+  {
+    // Ensure an interval long enough to measure the tick rate to 1e-4
+    auto const minimum = origin.time + std::chrono::milliseconds(10);
+    if (std::chrono::steady_clock::now() < minimum) {
+      std::this_thread::sleep_until(minimum);
+    }
+    std::uint64_t const ticks = tick_clock::now();
+    std::chrono::duration<double, std::nano> const elapsed =
+      std::chrono::steady_clock::now() - origin.time;
+    return elapsed.count() / (ticks - origin.ticks);
+  }
+
+  constexpr unsigned duration_histogram::sub_bits_;
+  constexpr std::size_t duration_histogram::sub_bins_;
+  constexpr std::size_t duration_histogram::bins_size_;
+
+  void
+  duration_histogram::merge(duration_histogram const& other)
+  {
+    for (std::size_t b = 0; b < bins_size_; ++b) {
+      bins_[b] += other.bins_[b];
+    }
+    count_ += other.count_;
+    sum_ += other.sum_;
+    max_ = std::max(max_, other.max_);
+  }
+
+  void
+  duration_histogram::clear()
+  {
+    bins_.fill(0);
+    count_ = 0;
+    sum_ = 0;
+    max_ = 0;
+  }
+
+  double
+  duration_histogram::mean() const
+  {
+    return count_ > 0 ? static_cast<double>(sum_) / count_ : 0.0;
+  }
+
+  std::uint64_t
+  duration_histogram::quantile(double q) const
+  {
+    if (count_ == 0) {
+      return 0;
+    }
+    double const r = std::ceil(q * count_);
+    std::uint64_t const rank =
+      r < 1.0 ? 1 : std::min<std::uint64_t>(static_cast<std::uint64_t>(r),
+                                              count_);
+    std::uint64_t seen{0};
+    for (std::size_t b = 0; b < bins_size_; ++b) {
+      seen += bins_[b];
+      if (seen >= rank) {
+        return std::min(last_in_bin_(b), max_);
+      }
+    }
+    return max_;
+  }
+
+  std::uint64_t
+  duration_histogram::last_in_bin_(std::size_t b)
+  {
+    if (b < sub_bins_) {
+      return b;
+    }
+    unsigned const shift = b / sub_bins_ - 1;
+    std::uint64_t const first = std::uint64_t{sub_bins_ + b % sub_bins_}
+                                << shift;
+    return first + ((std::uint64_t{1} << shift) - 1);
+  }
+
+  stage_timings::stage_timings(std::vector<std::string> names)
+    : names_(std::move(names)), stages_(names_.size())
+  {}
+
+  void
+  stage_timings::merge(stage_timings const& other)
+  {
+    if (other.names_ != names_) {
+      throw std::logic_error("cannot merge timings of different stages");
+    }
+    for (std::size_t i = 0; i < stages_.size(); ++i) {
+      stages_[i].merge(other.stages_[i]);
+    }
+  }
+
+  void
+  stage_timings::clear()
+  {
+    for (auto& s : stages_) {
+      s.clear();
+    }
+  }
+
+  void
+  stage_timings::report(std::ostream& out) const
+  {
+    double const us = tick_clock::ns_per_tick() / 1000;
+    char line[128];
+    std::snprintf(line,
+                  sizeof(line),
+                  "%-12s %10s %10s %10s %10s %10s\n",
+                  "stage (us)",
+                  "count",
+                  "mean",
+                  "p50",
+                  "p99",
+                  "max");
+    out << line;
+    for (std::size_t i = 0; i < stages_.size(); ++i) {
+      auto const& s = stages_[i];
+      std::snprintf(line,
+                    sizeof(line),
+                    "%-12s %10llu %10.2f %10.2f %10.2f %10.2f\n",
+                    names_[i].c_str(),
+                    static_cast<unsigned long long>(s.count()),
+                    s.mean() * us,
+                    s.quantile(0.5) * us,
+                    s.quantile(0.99) * us,
+                    s.max() * us);
+      out << line;
+    }
+  }
+} /* falaise */
@@ -0,0 +1,196 @@
+#ifndef FALAISE_STAGE_TIMER_H
+#define FALAISE_STAGE_TIMER_H
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+namespace falaise {
+  //! Distribution of durations, in integer ticks of some clock
+  /*
+   * Durations are counted in log-linear bins, 16 per power of two, so
+   * quantiles are found to within 1/16 of their value in a fixed 8 kB and
+   * recording one costs a count-leading-zeros and an increment.
+   */
+  class duration_histogram {
+  public:
+    //! Count a duration of t ticks
+    void
+    record(std::uint64_t t)
+    {
+      ++bins_[bin_(t)];
+      ++count_;
+      sum_ += t;
+      max_ = t > max_ ? t : max_;
+    }
+
+    //! Add the durations counted by other
+    void merge(duration_histogram const& other);
+
+    //! Forget all durations
+    void clear();
+
+    //! Return the number of durations counted
+    std::uint64_t
+    count() const
+    {
+      return count_;
+    }
+
+    //! Return the mean duration, or zero if none are counted
+    double mean() const;
+
+    //! Return the longest duration, or zero if none are counted
+    std::uint64_t
+    max() const
+    {
+      return max_;
+    }
+
+    //! Return the q quantile (q in [0, 1]), rounded up to its bin's end
+    std::uint64_t quantile(double q) const;
+
+  private:
+    static constexpr unsigned sub_bits_ = 4;
+    static constexpr std::size_t sub_bins_ = 1 << sub_bits_;
+    static constexpr std::size_t bins_size_ = (64 - sub_bits_ + 1) * sub_bins_;
+
+    //! Return the bin of t: exact below sub_bins_, else log-linear
+    static std::size_t
+    bin_(std::uint64_t t)
+    {
+      if (t < sub_bins_) {
+        return t;
+      }
+      unsigned const e = 63 - __builtin_clzll(t);
+      return (e - sub_bits_ + 1) * sub_bins_ +
+             ((t >> (e - sub_bits_)) & (sub_bins_ - 1));
+    }
+
+    //! Return the largest duration in bin b
+    static std::uint64_t last_in_bin_(std::size_t b);
+
+    std::array<std::uint64_t, bins_size_> bins_{}; //< counts by bin_()
+    std::uint64_t count_{0};                       //< sum of bins_
+    std::uint64_t sum_{0};                         //< of durations counted
+    std::uint64_t max_{0};                         //< longest counted
+  };
+
+  //! Duration histograms of the named stages of some processing
+  /*
+   * Durations are in tick_clock ticks. Meant to be held per thread, e.g.
+   * in per-thread scratch storage, so recording needs no synchronization,
+   * and merged for reporting.
+   */
+  class stage_timings {
+  public:
+    //! Construct timings of no stages
+    stage_timings() = default;
+
+    //! Construct empty timings of stages named names
+    explicit stage_timings(std::vector<std::string> names);
+
+    //! Return the number of stages
+    std::size_t
+    size() const
+    {
+      return names_.size();
+    }
+
+    //! Return the name of stage i
+    std::string const&
+    name(std::size_t i) const
+    {
+      return names_[i];
+    }
+
+    //! Return the durations of stage i
+    duration_histogram& operator[](std::size_t i) { return stages_[i]; }
+    duration_histogram const& operator[](std::size_t i) const
+    {
+      return stages_[i];
+    }
+
+    //! Add the durations of other, which must have the same stages
+    void merge(stage_timings const& other);
+
+    //! Forget all durations
+    void clear();
+
+    //! Write count, mean, p50, p99 and max of each stage in microseconds
+    void report(std::ostream& out) const;
+
+  private:
+    std::vector<std::string> names_;
+    std::vector<duration_histogram> stages_;
+  };
+
+  //! Cheapest available monotonic clock, for timing short stages
+  /*
+   * Reads the time stamp counter on x86, a few ns, else steady_clock. The
+   * counter is assumed invariant (constant rate, synchronized across
+   * cores) as on all recent x86 processors. Ticks are converted to ns only
+   * when reporting, by ns_per_tick().
+   */
+  struct tick_clock {
+    //! Return the current tick count
+    static std::uint64_t
+    now()
+    {
+#if defined(__x86_64__) || defined(__i386__)
+      return __rdtsc();
+#else
+      return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+#endif
+    }
+
+    //! Return the duration of a tick in ns
+    /*
+     * Measured against steady_clock since program start, so it is most
+     * accurate when called at the end of processing
+     */
+    static double ns_per_tick();
+  };
+
+  //! Record consecutive stages of processing into stage_timings
+  /*
+   * Each lap() ends the current stage and starts the next, so timing n
+   * stages costs n + 1 clock reads. Does nothing, not even read the clock,
+   * if the timings are null, so timing can be switched off at run time for
+   * the cost of a test.
+   */
+  class stage_timer {
+  public:
+    //! Start timing the first stage into timings, if it is not null
+    explicit stage_timer(stage_timings* timings)
+      : timings_(timings), last_(timings != nullptr ? tick_clock::now() : 0)
+    {}
+
+    //! Record the time since the last lap as a duration of stage i
+    void
+    lap(std::size_t i)
+    {
+      if (timings_ != nullptr) {
+        std::uint64_t const now = tick_clock::now();
+        (*timings_)[i].record(now - last_);
+        last_ = now;
+      }
+    }
+
+  private:
+    stage_timings* timings_;
+    std::uint64_t last_;
+  };
+} /* falaise */
+
+#endif /* FALAISE_STAGE_TIMER_H */
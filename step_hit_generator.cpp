@@ -0,0 +1,135 @@
+#include "step_hit_generator.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+#include <stdexcept>
+
+#include "bayeux/mctools/simulated_data.h"
+
+#include "packed_geom_id.h"
+
+namespace falaise {
+  step_hit_generator::step_hit_generator(tracker_cell_table cells,
+                                         parameters const& p)
+    : cells_(std::move(cells))
+    , parameters_(p)
+    , rng_(make_random_stream("philox4x32"))
+  {
+    if (cells_.empty()) {
+      throw std::logic_error("step hits need cells to be generated in");
+    }
+    if (!(p.multi_hit_fraction >= 0.0 && p.multi_hit_fraction < 1.0)) {
+      throw std::logic_error("multi-hit fraction must be in [0, 1)");
+    }
+    if (p.pattern == occupancy::tracks && packed_depth(cells_.gid(0)) != 4) {
+      throw std::logic_error("tracks need cells addressed by "
+                             "[module.side.layer.row]");
+    }
+
+    std::uint32_t max[4] = {0, 0, 0, 0};
+    std::fill(std::begin(min_), std::end(min_), ~0u);
+    for (std::uint32_t i = 0; i < cells_.size(); ++i) {
+      for (std::uint32_t d = 0; d < packed_depth(cells_.gid(i)); ++d) {
+        std::uint32_t const a = packed_address(cells_.gid(i), d);
+        min_[d] = std::min(min_[d], a);
+        max[d] = std::max(max[d], a);
+      }
+    }
+    for (std::uint32_t d = 0; d < 4; ++d) {
+      extent_[d] = min_[d] <= max[d] ? max[d] - min_[d] + 1 : 0;
+    }
+  }
+
+  void
+  step_hit_generator::generate(std::int32_t event, mctools::simulated_data& sd)
+  {
+    rng_->reseed(parameters_.seed, 0, event);
+
+    std::size_t const n = parameters_.hits;
+    std::size_t distinct = std::min<std::size_t>(
+      n - std::lround(n * parameters_.multi_hit_fraction), cells_.size());
+    if (n > 0 && distinct == 0) {
+      distinct = 1;
+    }
+    cells_hit_.clear();
+    if (parameters_.pattern == occupancy::tracks) {
+      choose_tracks_(distinct);
+    }
+    else {
+      choose_uniform_(distinct);
+    }
+
+    std::string const& category = parameters_.category;
+    sd.remove_step_hits(category);
+    sd.add_step_hits(category, n);
+    double const offset = parameters_.max_offset;
+    for (std::size_t i = 0; i < n; ++i) {
+      std::uint32_t const index =
+        i < distinct ? cells_hit_[i] :
+                       cells_hit_[static_cast<std::size_t>(rng_->uniform() *
+                                                           distinct)];
+      auto const& cell = cells_[index];
+      double const x = cell.anode_x + offset * (2 * rng_->uniform() - 1);
+      double const y = cell.anode_y + offset * (2 * rng_->uniform() - 1);
+      double const z = cell.z_min + cell.length * rng_->uniform();
+      double const t = 10.0 * rng_->uniform();
+
+      auto& hit = sd.add_step_hit(category);
+      hit.set_hit_id(i);
+      hit.set_geom_id(unpack_geom_id(cells_.gid(index)));
+      hit.set_position_start({x, y, z});
+      hit.set_time_start(t);
+    }
+  }
+
+  void
+  step_hit_generator::choose_uniform_(std::size_t n)
+  {
+    while (cells_hit_.size() < n) {
+      auto const index =
+        static_cast<std::uint32_t>(rng_->uniform() * cells_.size());
+      if (std::find(cells_hit_.begin(), cells_hit_.end(), index) ==
+          cells_hit_.end()) {
+        cells_hit_.push_back(index);
+      }
+    }
+  }
+
+  void
+  step_hit_generator::choose_tracks_(std::size_t n)
+  {
+    // Cells are [module.side.layer.row], tracks cross the layers of a side
+    std::uint64_t const first = cells_.gid(0);
+    std::uint32_t const type = packed_type(first);
+    std::uint32_t const module = packed_address(first, 0);
+    double const rows = extent_[3];
+
+    while (cells_hit_.size() < n) {
+      auto const side =
+        min_[1] + static_cast<std::uint32_t>(rng_->uniform() * extent_[1]);
+      double const row0 = rng_->uniform() * rows;
+      double const slope = 4 * rng_->uniform() - 2;
+      for (std::uint32_t layer = 0; layer < extent_[2]; ++layer) {
+        double const row = std::floor(row0 + slope * layer);
+        if (row < 0 || row >= rows) {
+          break;
+        }
+        std::uint32_t const index = cells_.index(
+          pack_geom_id({type,
+                        module,
+                        side,
+                        min_[2] + layer,
+                        min_[3] + static_cast<std::uint32_t>(row)}));
+        if (index != tracker_cell_table::invalid_index &&
+            std::find(cells_hit_.begin(), cells_hit_.end(), index) ==
+              cells_hit_.end()) {
+          cells_hit_.push_back(index);
+          if (cells_hit_.size() == n) {
+            break;
+          }
+        }
+      }
+    }
+  }
+} /* falaise */
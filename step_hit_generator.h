@@ -0,0 +1,81 @@
+#ifndef FALAISE_STEP_HIT_GENERATOR_H
+#define FALAISE_STEP_HIT_GENERATOR_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "random_stream.h"
+#include "tracker_cell_table.h"
+
+namespace mctools {
+  class simulated_data;
+}
+
+namespace falaise {
+  //! Synthetic Geiger step hits, for testing and benchmarking without a
+  //! full simulation
+  /*
+   * Each event holds a fixed number of step hits in the cells of a
+   * tracker_cell_table, each at a uniform offset from its cell's anode
+   * wire, uniform z in the cell and uniform time in [0, 10) ns. Which
+   * cells are hit follows an occupancy pattern:
+   *
+   * - uniform: cells chosen uniformly at random
+   * - tracks: straight tracks crossing the layers of one side, hitting
+   *   one cell per layer in rows drifting by up to two per layer, as for
+   *   cells addressed [module.side.layer.row]
+   *
+   * A given fraction of the hits are extra hits in cells already hit by
+   * the event, so that the digitizer has hits to merge.
+   *
+   * Events depend only on the seed and the event number, so are the same
+   * whatever order or thread they are generated in.
+   */
+  class step_hit_generator {
+  public:
+    enum class occupancy { uniform, tracks };
+
+    struct parameters {
+      std::size_t hits{16};                  //< step hits per event
+      occupancy pattern{occupancy::uniform}; //< cells hit
+      double multi_hit_fraction{0.0};        //< of hits in a cell already hit
+      double max_offset{20.0};               //< largest x/y offset from anode
+      std::uint64_t seed{12345};             //< with event number, seeds it
+      std::string category{"gg"};            //< simulated_data hit category
+    };
+
+    //! Construct a generator of hits in cells
+    /*
+     * \throw std::logic_error if cells is empty, or multi_hit_fraction is
+     * not in [0, 1)
+     */
+    step_hit_generator(tracker_cell_table cells, parameters const& p);
+
+    //! Return the parameters
+    parameters const&
+    get_parameters() const
+    {
+      return parameters_;
+    }
+
+    //! Replace the step hits of sd's category with those of event
+    void generate(std::int32_t event, mctools::simulated_data& sd);
+
+  private:
+    //! Fill cells_hit_ with n distinct cells, in the occupancy pattern
+    void choose_uniform_(std::size_t n);
+    void choose_tracks_(std::size_t n);
+
+    tracker_cell_table cells_;
+    parameters parameters_;
+    std::unique_ptr<random_stream> rng_;
+    std::uint32_t min_[4] = {0, 0, 0, 0};    //< lowest address at each depth
+    std::uint32_t extent_[4] = {0, 0, 0, 0}; //< address range at each depth
+    std::vector<std::uint32_t> cells_hit_;   //< distinct cells of the event
+  };
+} /* falaise */
+
+#endif /* FALAISE_STEP_HIT_GENERATOR_H */
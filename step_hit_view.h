@@ -0,0 +1,27 @@
+#ifndef FALAISE_STEP_HIT_VIEW_H
+#define FALAISE_STEP_HIT_VIEW_H
+
+#include <string>
+
+#include "bayeux/mctools/simulated_data.h"
+
+#include "input_view.h"
+
+namespace falaise {
+  //! View of step hit handles in mctools::simulated_data
+  using step_hit_view = input_view<mctools::simulated_data::hit_handle_type>;
+
+  //! Return a view of the step hits of category, empty if there are none
+  inline step_hit_view
+  view_step_hits(mctools::simulated_data const& sd, std::string const& category)
+  {
+    auto const& dict = sd.get_step_hits_dict();
+    auto iter = dict.find(category);
+    if (iter == dict.end()) {
+      return step_hit_view{};
+    }
+    return step_hit_view{iter->second};
+  }
+} /* falaise */
+
+#endif /* FALAISE_STEP_HIT_VIEW_H */
@@ -0,0 +1,94 @@
+#include "synthetic_events.h"
+
+#include <string>
+
+#include "bayeux/geomtools/geometry_service.h"
+#include "bayeux/mctools/simulated_data.h"
+#include "falaise/snemo/datamodels/calibrated_data.h"
+#include "falaise/snemo/datamodels/calibrated_tracker_hit.h"
+#include "falaise/snemo/datamodels/event_header.h"
+#include "falaise/snemo/processing/services.h"
+
+#include "packed_geom_id.h"
+
+namespace falaise {
+  namespace {
+    std::string const&
+    geometry_label()
+    {
+      static std::string const label{
+        snemo::processing::service_info::default_geometry_service_label()};
+      return label;
+    }
+  } // namespace
+
+  demonstrator_geometry::demonstrator_geometry()
+  {
+    datatools::properties config;
+    config.store_path(
+      "manager.configuration_file",
+      "@falaise:config/snemo/demonstrator/geometry/4.0/manager.conf");
+    services.load(geometry_label(), "geomtools::geometry_service", config);
+    services.initialize();
+    cells = make_tracker_cell_table(manager(), "drift_cell_core");
+  }
+
+  geomtools::manager const&
+  demonstrator_geometry::manager() const
+  {
+    return services.get<geomtools::geometry_service>(geometry_label())
+      .get_geom_manager();
+  }
+
+  std::uint64_t
+  demonstrator_geometry::cell(std::uint32_t side,
+                              std::uint32_t layer,
+                              std::uint32_t row) const
+  {
+    // Cells are [module.side.layer.row], all of one module
+    std::uint64_t const first = cells.gid(0);
+    return pack_geom_id({packed_type(first),
+                         packed_address(first, 0),
+                         side,
+                         layer,
+                         row});
+  }
+
+  std::unique_ptr<datatools::things>
+  make_synthetic_event(step_hit_generator& generator, std::int32_t event)
+  {
+    std::unique_ptr<datatools::things> e{new datatools::things};
+    e->add<snemo::datamodel::event_header>("EH").grab_id().set(1, event);
+    generator.generate(event, e->add<mctools::simulated_data>("SD"));
+    return e;
+  }
+
+  std::vector<std::unique_ptr<datatools::things>>
+  make_synthetic_events(step_hit_generator& generator, std::size_t n)
+  {
+    std::vector<std::unique_ptr<datatools::things>> events;
+    events.reserve(n);
+    for (std::size_t i = 0; i < n; ++i) {
+      events.push_back(make_synthetic_event(generator, i));
+    }
+    return events;
+  }
+
+  std::unique_ptr<datatools::things>
+  make_calibrated_event(std::vector<std::uint64_t> const& gids,
+                        std::int32_t event)
+  {
+    using calibrated_data = snemo::datamodel::calibrated_data;
+    std::unique_ptr<datatools::things> e{new datatools::things};
+    e->add<snemo::datamodel::event_header>("EH").grab_id().set(1, event);
+    auto& hits = e->add<calibrated_data>("CD").calibrated_tracker_hits();
+    for (std::size_t i = 0; i < gids.size(); ++i) {
+      calibrated_data::tracker_hit_handle_type hit{
+        new snemo::datamodel::calibrated_tracker_hit};
+      hit.grab().set_hit_id(i);
+      hit.grab().set_geom_id(unpack_geom_id(gids[i]));
+      hits.push_back(hit);
+    }
+    return e;
+  }
+} /* falaise */
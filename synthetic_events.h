@@ -0,0 +1,68 @@
+#ifndef FALAISE_SYNTHETIC_EVENTS_H
+#define FALAISE_SYNTHETIC_EVENTS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "bayeux/datatools/service_manager.h"
+#include "bayeux/datatools/things.h"
+
+#include "step_hit_generator.h"
+#include "tracker_cell_table.h"
+
+namespace geomtools {
+  class manager;
+}
+
+namespace falaise {
+  //! Geometry service of the demonstrator, and its Geiger cells
+  /*
+   * For tests and benchmarks of the tracker modules, which find the
+   * service under its default label. Falaise must be initialized first,
+   * and loading the geometry takes seconds, so one is best held for a whole
+   * program, e.g. as a static.
+   */
+  struct demonstrator_geometry {
+    //! Load and initialize the geometry service
+    demonstrator_geometry();
+
+    //! Return the geometry manager of the service
+    geomtools::manager const& manager() const;
+
+    //! Return the packed geom_id of the cell at side, layer and row
+    std::uint64_t cell(std::uint32_t side,
+                       std::uint32_t layer,
+                       std::uint32_t row) const;
+
+    datatools::service_manager services; //< holding the geometry service
+    tracker_cell_table cells;            //< "drift_cell_core" cells of it
+  };
+
+  //! Return an event of run 1, numbered event, filled by generator
+  /*
+   * Holds an event header "EH" and the step hits of generator in
+   * simulated data "SD", as MockTrackerCalibrator expects by default
+   */
+  std::unique_ptr<datatools::things> make_synthetic_event(
+    step_hit_generator& generator,
+    std::int32_t event);
+
+  //! Return events 0 to n - 1 of make_synthetic_event
+  std::vector<std::unique_ptr<datatools::things>> make_synthetic_events(
+    step_hit_generator& generator,
+    std::size_t n);
+
+  //! Return an event of run 1, numbered event, with calibrated data "CD"
+  //! holding one calibrated tracker hit in each cell of gids, in order
+  /*
+   * For modules working on calibrated hits, which only set the hits'
+   * geom_ids and ids
+   */
+  std::unique_ptr<datatools::things> make_calibrated_event(
+    std::vector<std::uint64_t> const& gids,
+    std::int32_t event = 0);
+} /* falaise */
+
+#endif /* FALAISE_SYNTHETIC_EVENTS_H */
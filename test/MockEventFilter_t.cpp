@@ -0,0 +1,141 @@
+#include "catch.hpp"
+
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+
+#include "bayeux/datatools/library_loader.h"
+#include "bayeux/datatools/things.h"
+#include "bayeux/dpp/module_manager.h"
+#include "falaise/falaise.h"
+
+#include "synthetic_events.h"
+
+// - Fixtures and helpers
+//! Geometry service for the events' cells, created once for all tests
+struct FilterFixture {
+  FilterFixture()
+  {
+    FALAISE_INIT();
+    REQUIRE(loader.load("MockEventFilter", MOCKTRACKERCALIBRATOR_DIR) == 0);
+    geometry.reset(new falaise::demonstrator_geometry);
+  }
+
+  datatools::library_loader loader;
+  std::unique_ptr<falaise::demonstrator_geometry> geometry;
+};
+
+FilterFixture&
+fixture()
+{
+  static FilterFixture f;
+  return f;
+}
+
+//! Create event with nHits Geiger step hits from a step_hit_generator
+std::unique_ptr<datatools::things>
+makeEvent(int eventNumber, std::size_t nHits)
+{
+  falaise::step_hit_generator::parameters p;
+  p.hits = nHits;
+  falaise::step_hit_generator generator{fixture().geometry->cells, p};
+  return falaise::make_synthetic_event(generator, eventNumber);
+}
+
+//! Filter module "filter" configured by config, in its own manager
+struct Filter {
+  explicit Filter(datatools::properties const& config)
+  {
+    modules.set_service_manager(fixture().geometry->services);
+    modules.load_module("filter", "MockEventFilter", config);
+    modules.initialize_simple();
+  }
+
+  dpp::base_module::process_status
+  process(datatools::things& event)
+  {
+    return modules.grab("filter").process(event);
+  }
+
+  //! Reset the filter, returning what it wrote to std::clog
+  std::string
+  reset()
+  {
+    std::ostringstream report;
+    auto* const clog = std::clog.rdbuf(report.rdbuf());
+    try {
+      modules.reset();
+    }
+    catch (...) {
+      std::clog.rdbuf(clog);
+      throw;
+    }
+    std::clog.rdbuf(clog);
+    return report.str();
+  }
+
+  dpp::module_manager modules;
+};
+
+TEST_CASE("Events failing the filter's predicates are stopped", "")
+{
+  datatools::properties config;
+  config.store("min_tracker_hits", 10);
+  Filter filter{config};
+  REQUIRE(filter.process(*makeEvent(1, 0)) ==
+          dpp::base_module::PROCESS_STOP);
+  REQUIRE(filter.process(*makeEvent(2, 9)) ==
+          dpp::base_module::PROCESS_STOP);
+  REQUIRE(filter.process(*makeEvent(3, 10)) == dpp::base_module::PROCESS_OK);
+
+  // Events without simulated data have no tracker hits
+  datatools::things empty;
+  REQUIRE(filter.process(empty) == dpp::base_module::PROCESS_STOP);
+}
+
+TEST_CASE("Rejections are counted by the first predicate failed", "")
+{
+  datatools::properties config;
+  config.store("min_tracker_hits", 10);
+  // Two events without hits, three with too few, four passing
+  std::size_t const hits[] = {0, 0, 5, 5, 5, 20, 20, 20, 20};
+
+  SECTION("events without hits fail no_tracker_hits")
+  {
+    Filter filter{config};
+    for (int i = 0; i < 9; ++i) {
+      filter.process(*makeEvent(i, hits[i]));
+    }
+    REQUIRE(filter.reset() == "MockEventFilter 'filter' rejected 5 of 9 "
+                              "events:\n"
+                              "  no_tracker_hits: 2\n"
+                              "  few_tracker_hits: 3\n");
+  }
+
+  SECTION("or few_tracker_hits if no_tracker_hits is off")
+  {
+    config.store("reject.no_tracker_hits", false);
+    Filter filter{config};
+    for (int i = 0; i < 9; ++i) {
+      filter.process(*makeEvent(i, hits[i]));
+    }
+    REQUIRE(filter.reset() == "MockEventFilter 'filter' rejected 5 of 9 "
+                              "events:\n"
+                              "  no_tracker_hits: 0\n"
+                              "  few_tracker_hits: 5\n");
+  }
+
+  SECTION("and nothing is rejected with no predicate on")
+  {
+    config.store("reject.no_tracker_hits", false);
+    config.update("min_tracker_hits", 0);
+    Filter filter{config};
+    REQUIRE(filter.process(*makeEvent(0, 0)) ==
+            dpp::base_module::PROCESS_OK);
+    REQUIRE(filter.reset() == "MockEventFilter 'filter' rejected 0 of 1 "
+                              "events:\n"
+                              "  no_tracker_hits: 0\n"
+                              "  few_tracker_hits: 0\n");
+  }
+}
@@ -0,0 +1,95 @@
+#include "catch.hpp"
+
+#include <memory>
+#include <vector>
+
+#include "bayeux/datatools/library_loader.h"
+#include "bayeux/datatools/things.h"
+#include "bayeux/dpp/module_manager.h"
+#include "falaise/falaise.h"
+#include "falaise/snemo/datamodels/calibrated_data.h"
+
+#include "synthetic_events.h"
+
+// - Fixtures and helpers
+//! Geometry service for the clusterer, created once for all tests
+struct ClustererFixture {
+  ClustererFixture()
+  {
+    FALAISE_INIT();
+    REQUIRE(loader.load("MockGeigerClusterer", MOCKTRACKERCALIBRATOR_DIR) ==
+            0);
+    geometry.reset(new falaise::demonstrator_geometry);
+  }
+
+  datatools::library_loader loader;
+  std::unique_ptr<falaise::demonstrator_geometry> geometry;
+};
+
+ClustererFixture&
+fixture()
+{
+  static ClustererFixture f;
+  return f;
+}
+
+//! Return the packed geom_id of the cell at side, layer and row
+std::uint64_t
+cell(std::uint32_t side, std::uint32_t layer, std::uint32_t row)
+{
+  return fixture().geometry->cell(side, layer, row);
+}
+
+//! Return the integer property key of each calibrated hit of event
+std::vector<int>
+hitProperty(datatools::things const& event, std::string const& key)
+{
+  std::vector<int> values;
+  auto const& cd = event.get<snemo::datamodel::calibrated_data>("CD");
+  for (auto const& hit : cd.calibrated_tracker_hits()) {
+    values.push_back(hit.get().get_auxiliaries().fetch_integer(key));
+  }
+  return values;
+}
+
+//! Return the integer property key of event's calibrated data
+int
+eventProperty(datatools::things const& event, std::string const& key)
+{
+  return event.get<snemo::datamodel::calibrated_data>("CD")
+    .get_properties()
+    .fetch_integer(key);
+}
+
+TEST_CASE("Hits are numbered by cluster", "")
+{
+  datatools::properties config;
+  std::string key{"cluster_id"};
+  SECTION("under the default key") {}
+  SECTION("or the configured one")
+  {
+    key = "gg_cluster";
+    config.store("cluster_key", key);
+  }
+
+  dpp::module_manager modules;
+  modules.set_service_manager(fixture().geometry->services);
+  modules.load_module("clusterer", "MockGeigerClusterer", config);
+  modules.initialize_simple();
+  auto& clusterer = modules.grab("clusterer");
+
+  // A diagonal pair, a cell two layers from it, its mirror on the other
+  // side, and a repeated cell, out of order
+  auto event = falaise::make_calibrated_event({cell(0, 1, 11),
+                                               cell(1, 0, 10),
+                                               cell(0, 3, 10),
+                                               cell(0, 0, 10),
+                                               cell(0, 1, 11)});
+  REQUIRE(clusterer.process(*event) == dpp::base_module::PROCESS_OK);
+  REQUIRE(hitProperty(*event, key) == std::vector<int>{0, 2, 1, 0, 0});
+  REQUIRE(eventProperty(*event, key + ".count") == 3);
+
+  auto empty = falaise::make_calibrated_event({});
+  REQUIRE(clusterer.process(*empty) == dpp::base_module::PROCESS_OK);
+  REQUIRE(eventProperty(*empty, key + ".count") == 0);
+}
@@ -0,0 +1,242 @@
+#include "catch.hpp"
+
+#include <algorithm>
+#include <memory>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "bayeux/datatools/library_loader.h"
+#include "bayeux/datatools/things.h"
+#include "bayeux/dpp/module_manager.h"
+#include "bayeux/mctools/simulated_data.h"
+#include "falaise/falaise.h"
+#include "falaise/snemo/datamodels/calibrated_data.h"
+
+#include "batch_module.h"
+#include "cell_adjacency.h"
+#include "packed_geom_id.h"
+#include "synthetic_events.h"
+#include "tracker_layer_index.h"
+
+// - Fixtures and helpers
+//! Geometry service and calibrator module, created once for all tests
+struct CalibratorFixture {
+  CalibratorFixture()
+  {
+    FALAISE_INIT();
+    REQUIRE(loader.load("MockTrackerCalibrator", MOCKTRACKERCALIBRATOR_DIR) ==
+            0);
+    geometry.reset(new falaise::demonstrator_geometry);
+
+    modules.set_service_manager(geometry->services);
+    modules.load_module(
+      "calibrator", "MockTrackerCalibrator", datatools::properties{});
+    modules.initialize_simple();
+  }
+
+  dpp::base_module&
+  calibrator()
+  {
+    return modules.grab("calibrator");
+  }
+
+  datatools::library_loader loader;
+  std::unique_ptr<falaise::demonstrator_geometry> geometry;
+  dpp::module_manager modules;
+};
+
+CalibratorFixture&
+fixture()
+{
+  static CalibratorFixture f;
+  return f;
+}
+
+//! Create event with nHits Geiger step hits from a step_hit_generator
+std::unique_ptr<datatools::things>
+makeEvent(int eventNumber, std::size_t nHits)
+{
+  // Several hits per cell, as along a track
+  falaise::step_hit_generator::parameters p;
+  p.hits = nHits;
+  p.multi_hit_fraction = 0.3;
+  falaise::step_hit_generator generator{fixture().geometry->cells, p};
+  return falaise::make_synthetic_event(generator, eventNumber);
+}
+
+struct HitSummary {
+  std::uint64_t gid;
+  double anode_time;
+  double r;
+  double z;
+
+  bool
+  operator==(HitSummary const& other) const
+  {
+    return gid == other.gid && anode_time == other.anode_time &&
+           r == other.r && z == other.z;
+  }
+};
+
+using EventSummary = std::vector<HitSummary>;
+
+//! Return calibrated hits of event, for bitwise comparison
+EventSummary
+summarize(datatools::things const& event)
+{
+  EventSummary result;
+  auto const& cd = event.get<snemo::datamodel::calibrated_data>("CD");
+  for (auto const& hdl : cd.calibrated_tracker_hits()) {
+    auto const& hit = hdl.get();
+    result.push_back({falaise::pack_geom_id(hit.get_geom_id()),
+                      hit.get_anode_time(),
+                      hit.get_r(),
+                      hit.get_z()});
+  }
+  return result;
+}
+
+//! Process events in an order shuffled by seed, returning summaries
+std::vector<EventSummary>
+processAll(int nEvents, unsigned int seed)
+{
+  std::vector<int> order(nEvents);
+  for (int i = 0; i < nEvents; ++i) {
+    order[i] = i;
+  }
+  std::shuffle(order.begin(), order.end(), std::mt19937{seed});
+
+  std::vector<EventSummary> result(nEvents);
+  for (int i : order) {
+    auto event = makeEvent(i, 200);
+    auto status = fixture().calibrator().process(*event);
+    if (status != dpp::base_module::PROCESS_OK) {
+      return {};
+    }
+    result[i] = summarize(*event);
+  }
+  return result;
+}
+
+TEST_CASE("Calibration of an event is reproducible", "")
+{
+  auto a = makeEvent(42, 200);
+  auto b = makeEvent(42, 200);
+  REQUIRE(fixture().calibrator().process(*a) == dpp::base_module::PROCESS_OK);
+  REQUIRE(fixture().calibrator().process(*b) == dpp::base_module::PROCESS_OK);
+
+  auto summary = summarize(*a);
+  REQUIRE(!summary.empty());
+  REQUIRE(summary == summarize(*b));
+}
+
+TEST_CASE("Concurrent processing matches a serial run", "")
+{
+  int const nEvents{200};
+  unsigned int const nThreads{8};
+  auto serial = processAll(nEvents, 0);
+  REQUIRE(serial.size() == nEvents);
+
+  std::vector<std::vector<EventSummary>> parallel(nThreads);
+  std::vector<std::thread> threads;
+  for (unsigned int t = 0; t < nThreads; ++t) {
+    threads.emplace_back(
+      [&parallel, t, nEvents] { parallel[t] = processAll(nEvents, t + 1); });
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+
+  for (auto const& p : parallel) {
+    REQUIRE(p.size() == serial.size());
+    for (int i = 0; i < nEvents; ++i) {
+      REQUIRE(p[i] == serial[i]);
+    }
+  }
+}
+
+TEST_CASE("Batches are calibrated as single events", "")
+{
+  auto& batcher = dynamic_cast<falaise::batch_module&>(fixture().calibrator());
+
+  // Varied sizes, including events without Geiger hits
+  std::vector<std::unique_ptr<datatools::things>> single;
+  std::vector<std::unique_ptr<datatools::things>> batched;
+  std::vector<datatools::things*> batch;
+  for (int i = 0; i < 50; ++i) {
+    single.push_back(makeEvent(i, (i * 37) % 100));
+    batched.push_back(makeEvent(i, (i * 37) % 100));
+    batch.push_back(batched.back().get());
+  }
+  batched.push_back(makeEvent(50, 0));
+  batched.back()->grab<mctools::simulated_data>("SD").remove_step_hits("gg");
+  batch.push_back(batched.back().get());
+
+  for (auto& e : single) {
+    REQUIRE(fixture().calibrator().process(*e) ==
+            dpp::base_module::PROCESS_OK);
+  }
+  REQUIRE(batcher.process_batch(batch) == dpp::base_module::PROCESS_OK);
+
+  for (std::size_t i = 0; i < single.size(); ++i) {
+    REQUIRE(summarize(*batched[i]) == summarize(*single[i]));
+  }
+  REQUIRE(summarize(*batched.back()).empty());
+}
+
+TEST_CASE("Events without a header are not processed", "")
+{
+  auto& batcher = dynamic_cast<falaise::batch_module&>(fixture().calibrator());
+  auto good = makeEvent(1, 20);
+  auto headless = makeEvent(2, 20);
+  headless->remove("EH");
+  REQUIRE(fixture().calibrator().process(*headless) ==
+          dpp::base_module::PROCESS_ERROR);
+  REQUIRE(!headless->has("CD"));
+
+  std::vector<datatools::things*> batch{good.get(), headless.get()};
+  REQUIRE(batcher.process_batch(batch) == dpp::base_module::PROCESS_ERROR);
+  REQUIRE(!good->has("CD"));
+  REQUIRE(!headless->has("CD"));
+}
+
+TEST_CASE("Calibrated hits are sorted and indexed by cell", "")
+{
+  auto event = makeEvent(7, 200);
+  REQUIRE(fixture().calibrator().process(*event) ==
+          dpp::base_module::PROCESS_OK);
+  auto const& cd = event->get<snemo::datamodel::calibrated_data>("CD");
+  auto const& hits = cd.calibrated_tracker_hits();
+  auto summary = summarize(*event);
+  REQUIRE(!summary.empty());
+  for (std::size_t i = 1; i < summary.size(); ++i) {
+    REQUIRE(summary[i - 1].gid < summary[i].gid);
+  }
+
+  auto index = falaise::load_tracker_layer_index(cd.get_properties());
+  REQUIRE(index.sides() == 2);
+  REQUIRE(index.layers() == 9);
+  REQUIRE(index.size() == hits.size());
+  auto rowOf = [&hits](std::size_t i) {
+    return hits[i].get().get_geom_id().get(3);
+  };
+  for (std::size_t i = 0; i < hits.size(); ++i) {
+    auto const& gid = hits[i].get().get_geom_id();
+    auto layer = index.layer(gid.get(1), gid.get(2));
+    REQUIRE(layer.first <= i);
+    REQUIRE(i < layer.second);
+    REQUIRE(index.find(gid.get(1), gid.get(2), gid.get(3), rowOf) == i);
+  }
+}
+
+TEST_CASE("Modules share the cells of a geometry", "")
+{
+  auto const& geometry = *fixture().geometry;
+  auto a = falaise::shared_tracker_cells(geometry.manager(), "drift_cell_core");
+  auto b = falaise::shared_tracker_cells(geometry.manager(), "drift_cell_core");
+  REQUIRE(a == b);
+  REQUIRE(a->table.size() == geometry.cells.size());
+  REQUIRE(a->adjacency.size() == a->table.size());
+  REQUIRE(a->adjacency.degree(0) >= 3);
+}
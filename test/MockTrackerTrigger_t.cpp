@@ -0,0 +1,189 @@
+#include "catch.hpp"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "bayeux/datatools/library_loader.h"
+#include "bayeux/datatools/things.h"
+#include "bayeux/dpp/module_manager.h"
+#include "falaise/falaise.h"
+#include "falaise/snemo/datamodels/calibrated_data.h"
+
+#include "synthetic_events.h"
+
+// - Fixtures and helpers
+//! Geometry service for the trigger, created once for all tests
+struct TriggerFixture {
+  TriggerFixture()
+  {
+    FALAISE_INIT();
+    REQUIRE(loader.load("MockTrackerTrigger", MOCKTRACKERCALIBRATOR_DIR) ==
+            0);
+    geometry.reset(new falaise::demonstrator_geometry);
+  }
+
+  datatools::library_loader loader;
+  std::unique_ptr<falaise::demonstrator_geometry> geometry;
+};
+
+TriggerFixture&
+fixture()
+{
+  static TriggerFixture f;
+  return f;
+}
+
+//! Return the packed geom_id of the cell at side, layer and row
+std::uint64_t
+cell(std::uint32_t side, std::uint32_t layer, std::uint32_t row)
+{
+  return fixture().geometry->cell(side, layer, row);
+}
+
+//! Trigger module "trigger" configured by config, in its own manager
+struct Trigger {
+  explicit Trigger(datatools::properties const& config)
+  {
+    modules.set_service_manager(fixture().geometry->services);
+    modules.load_module("trigger", "MockTrackerTrigger", config);
+    modules.initialize_simple();
+  }
+
+  //! Process a calibrated event of cells, returning its properties
+  datatools::properties
+  process(std::vector<std::uint64_t> const& cells,
+          dpp::base_module::process_status expected =
+            dpp::base_module::PROCESS_OK)
+  {
+    auto event = falaise::make_calibrated_event(cells);
+    REQUIRE(modules.grab("trigger").process(*event) == expected);
+    return event->get<snemo::datamodel::calibrated_data>("CD")
+      .get_properties();
+  }
+
+  dpp::module_manager modules;
+};
+
+//! Return the documented example configuration
+datatools::properties
+exampleConfig()
+{
+  datatools::properties config;
+  config.store("conditions", std::vector<std::string>{"majority", "through"});
+  config.store("majority.min_layers", 3);
+  config.store("through.layers", std::vector<int>{0, 8});
+  config.store("through.sides", 2);
+  return config;
+}
+
+TEST_CASE("The trigger decision and conditions met are stored", "")
+{
+  std::string key{"tracker_trigger"};
+  auto config = exampleConfig();
+  SECTION("under the default key") {}
+  SECTION("or the configured one")
+  {
+    key = "gg_trigger";
+    config.store("trigger_key", key);
+  }
+  Trigger trigger{config};
+
+  // Three layers in one zone
+  auto p = trigger.process({cell(0, 0, 10), cell(0, 1, 11), cell(0, 2, 12)});
+  REQUIRE(p.fetch_boolean(key));
+  REQUIRE(p.fetch_integer(key + ".conditions") == 1);
+
+  // ... but not when spread over rows further apart than a zone
+  p = trigger.process({cell(0, 0, 10), cell(0, 1, 40), cell(0, 2, 80)});
+  REQUIRE_FALSE(p.fetch_boolean(key));
+  REQUIRE(p.fetch_integer(key + ".conditions") == 0);
+
+  // First and last layers on both sides
+  p = trigger.process(
+    {cell(0, 0, 50), cell(0, 8, 52), cell(1, 0, 90), cell(1, 8, 91)});
+  REQUIRE(p.fetch_boolean(key));
+  REQUIRE(p.fetch_integer(key + ".conditions") == 2);
+
+  // ... but not on one side only
+  p = trigger.process({cell(0, 0, 50), cell(0, 8, 52)});
+  REQUIRE_FALSE(p.fetch_boolean(key));
+
+  // Both
+  p = trigger.process({cell(0, 0, 50),
+                       cell(0, 4, 51),
+                       cell(0, 8, 52),
+                       cell(1, 0, 90),
+                       cell(1, 8, 91)});
+  REQUIRE(p.fetch_integer(key + ".conditions") == 3);
+
+  p = trigger.process({});
+  REQUIRE_FALSE(p.fetch_boolean(key));
+  REQUIRE(p.fetch_integer(key + ".conditions") == 0);
+}
+
+TEST_CASE("Untriggered events are stopped if rejected", "")
+{
+  auto config = exampleConfig();
+  config.store("reject", true);
+  Trigger trigger{config};
+  auto const untriggered = {cell(0, 0, 50), cell(0, 8, 52)};
+  auto p = trigger.process(untriggered, dpp::base_module::PROCESS_STOP);
+  REQUIRE_FALSE(p.fetch_boolean("tracker_trigger"));
+
+  p = trigger.process({cell(0, 0, 10), cell(0, 1, 11), cell(0, 2, 12)});
+  REQUIRE(p.fetch_boolean("tracker_trigger"));
+}
+
+TEST_CASE("Zones are configured by rows and stride", "")
+{
+  datatools::properties config;
+  config.store("conditions", std::vector<std::string>{"majority"});
+  config.store("majority.min_layers", 3);
+  config.store("zone.rows", 32);
+  config.store("zone.stride", 16);
+  Trigger trigger{config};
+  auto p = trigger.process({cell(0, 0, 0), cell(0, 1, 15), cell(0, 2, 31)});
+  REQUIRE(p.fetch_boolean("tracker_trigger"));
+  p = trigger.process({cell(0, 0, 0), cell(0, 1, 15), cell(0, 2, 32)});
+  REQUIRE_FALSE(p.fetch_boolean("tracker_trigger"));
+}
+
+TEST_CASE("Invalid conditions are rejected at initialization", "")
+{
+  datatools::properties config;
+  SECTION("without conditions") {}
+  SECTION("with a layer out of range")
+  {
+    config = exampleConfig();
+    config.update("through.layers", std::vector<int>{0, 32});
+  }
+  SECTION("with negative layer counts")
+  {
+    config = exampleConfig();
+    config.update("majority.min_layers", -1);
+  }
+  SECTION("with a condition on no layers")
+  {
+    config = exampleConfig();
+    config.update("conditions",
+                  std::vector<std::string>{"majority", "mistyped"});
+    config.store("mistyped.min_layer", 3);
+  }
+  SECTION("with a condition on no sides")
+  {
+    config = exampleConfig();
+    config.update("through.sides", 0);
+  }
+  SECTION("with more layers than the tracker has")
+  {
+    config = exampleConfig();
+    config.update("majority.min_layers", 10);
+  }
+  SECTION("with more sides than the tracker has")
+  {
+    config = exampleConfig();
+    config.update("through.sides", 3);
+  }
+  REQUIRE_THROWS(Trigger{config});
+}
@@ -0,0 +1,70 @@
+#include <chrono>
+#include <thread>
+
+#include "bayeux/datatools/things.h"
+#include "bayeux/dpp/base_module.h"
+#include "falaise/snemo/datamodels/event_header.h"
+
+//! Module rejecting, failing or aborting on configured event numbers
+/*
+ * Plugin for the pipeline driver tests. Events whose number is a multiple
+ * of "stop_every" return PROCESS_STOP, else those whose number is a
+ * multiple of "error_every" PROCESS_ERROR, and the event "fatal_event"
+ * PROCESS_FATAL.
+ *
+ * Sleeps for a time depending on the event number, so that events complete
+ * out of order on several workers.
+ */
+class PipelineProbe : public dpp::base_module {
+public:
+  void
+  initialize(const datatools::properties& config,
+             datatools::service_manager&,
+             dpp::module_handle_dict_type&) override
+  {
+    stopEvery_ = config.has_key("stop_every") ?
+                   config.fetch_integer("stop_every") :
+                   0;
+    errorEvery_ = config.has_key("error_every") ?
+                    config.fetch_integer("error_every") :
+                    0;
+    fatalEvent_ = config.has_key("fatal_event") ?
+                    config.fetch_integer("fatal_event") :
+                    -1;
+    this->_set_initialized(true);
+  }
+
+  dpp::base_module::process_status
+  process(datatools::things& event) override
+  {
+    int n = event.get<snemo::datamodel::event_header>("EH")
+              .get_id()
+              .get_event_number();
+    std::this_thread::sleep_for(std::chrono::microseconds((n * 7919) % 200));
+    if (n == fatalEvent_) {
+      return PROCESS_FATAL;
+    }
+    if (stopEvery_ > 0 && n % stopEvery_ == 0) {
+      return PROCESS_STOP;
+    }
+    if (errorEvery_ > 0 && n % errorEvery_ == 0) {
+      return PROCESS_ERROR;
+    }
+    return PROCESS_OK;
+  }
+
+  void
+  reset() override
+  {
+    this->_set_initialized(false);
+  }
+
+private:
+  int stopEvery_{0};
+  int errorEvery_{0};
+  int fatalEvent_{-1};
+
+  DPP_MODULE_REGISTRATION_INTERFACE(PipelineProbe);
+};
+
+DPP_MODULE_REGISTRATION_IMPLEMENT(PipelineProbe, "PipelineProbe");
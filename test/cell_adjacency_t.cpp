@@ -0,0 +1,78 @@
+#include "catch.hpp"
+
+#include "cell_adjacency.h"
+
+#include <algorithm>
+#include <vector>
+
+// - Fixtures and helpers
+// Cells [1204:0.side.layer.row] of a reduced tracker, rows along y, with
+// the sides closer together than cells of a side
+falaise::tracker_cell_table
+makeCells(std::uint32_t nLayers, std::uint32_t nRows)
+{
+  std::vector<falaise::tracker_cell_table::entry> cells;
+  for (std::uint32_t side = 0; side < 2; ++side) {
+    for (std::uint32_t layer = 0; layer < nLayers; ++layer) {
+      for (std::uint32_t row = 0; row < nRows; ++row) {
+        double x = (side == 0 ? -1.0 : 1.0) * (20.0 + 44.0 * layer);
+        double y = 44.0 * row;
+        auto key = falaise::pack_geom_id({1204, 0, side, layer, row});
+        cells.push_back({key, {x, y, -1450.0, 1450.0, 2900.0}});
+      }
+    }
+  }
+  return falaise::tracker_cell_table{cells};
+}
+
+std::uint32_t
+cellIndex(falaise::tracker_cell_table const& cells,
+          std::uint32_t side,
+          std::uint32_t layer,
+          std::uint32_t row)
+{
+  return cells.index(falaise::pack_geom_id({1204, 0, side, layer, row}));
+}
+
+TEST_CASE("Cells neighbour the cells around them in their plane", "")
+{
+  auto cells = makeCells(9, 113);
+  REQUIRE(falaise::anode_pitch(cells) == Approx(40.0));
+  REQUIRE(falaise::anode_pitch(falaise::tracker_cell_table{}) == 0.0);
+
+  // Sides 40 apart are not neighbours, rows 44 apart are
+  falaise::cell_adjacency adjacency{cells, 1.5 * 44.0};
+  REQUIRE(adjacency.size() == cells.size());
+  REQUIRE(adjacency.degree(cellIndex(cells, 0, 0, 0)) == 3);
+  REQUIRE(adjacency.degree(cellIndex(cells, 1, 0, 50)) == 5);
+  REQUIRE(adjacency.degree(cellIndex(cells, 0, 4, 50)) == 8);
+  REQUIRE(adjacency.degree(cellIndex(cells, 1, 8, 112)) == 3);
+
+  auto centre = cellIndex(cells, 0, 4, 50);
+  std::vector<std::uint32_t> expected;
+  for (std::uint32_t layer : {3, 4, 5}) {
+    for (std::uint32_t row : {49, 50, 51}) {
+      if (layer != 4 || row != 50) {
+        expected.push_back(cellIndex(cells, 0, layer, row));
+      }
+    }
+  }
+  auto n = adjacency.neighbours(centre);
+  REQUIRE(std::vector<std::uint32_t>(n.begin(), n.end()) == expected);
+  REQUIRE(adjacency.are_neighbours(centre, cellIndex(cells, 0, 5, 51)));
+  REQUIRE(!adjacency.are_neighbours(centre, cellIndex(cells, 0, 6, 50)));
+  REQUIRE(!adjacency.are_neighbours(cellIndex(cells, 0, 0, 0),
+                                    cellIndex(cells, 1, 0, 0)));
+
+  // Neighbourhood is symmetric
+  for (std::uint32_t i = 0; i < adjacency.size(); ++i) {
+    for (auto j : adjacency.neighbours(i)) {
+      REQUIRE(adjacency.are_neighbours(j, i));
+    }
+  }
+
+  // Without diagonals
+  falaise::cell_adjacency direct{cells, 44.0};
+  REQUIRE(direct.degree(centre) == 4);
+  REQUIRE(falaise::cell_adjacency{}.size() == 0);
+}
@@ -0,0 +1,174 @@
+#include "catch.hpp"
+
+#include "cell_clusterer.h"
+
+#include <algorithm>
+#include <map>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include "cell_adjacency.h"
+#include "packed_geom_id.h"
+
+// - Fixtures and helpers
+std::uint64_t
+cellKey(std::uint32_t side, std::uint32_t layer, std::uint32_t row)
+{
+  return falaise::pack_geom_id({1204, 0, side, layer, row});
+}
+
+//! Clusters of cells by comparing all pairs
+std::vector<std::uint32_t>
+naiveClusters(std::vector<std::uint64_t> const& gids)
+{
+  std::vector<std::uint32_t> parent(gids.size());
+  std::iota(parent.begin(), parent.end(), 0);
+  auto find = [&parent](std::uint32_t i) {
+    while (parent[i] != i) {
+      i = parent[i];
+    }
+    return i;
+  };
+  auto near = [](std::uint64_t a, std::uint64_t b, std::uint32_t i) {
+    auto x = falaise::packed_address(a, i);
+    auto y = falaise::packed_address(b, i);
+    return x <= y + 1 && y <= x + 1;
+  };
+  for (std::uint32_t i = 0; i < gids.size(); ++i) {
+    for (std::uint32_t j = 0; j < i; ++j) {
+      if (falaise::packed_address(gids[i], 1) ==
+            falaise::packed_address(gids[j], 1) &&
+          near(gids[i], gids[j], 2) && near(gids[i], gids[j], 3)) {
+        parent[find(i)] = find(j);
+      }
+    }
+  }
+  std::vector<std::uint32_t> roots(gids.size());
+  for (std::uint32_t i = 0; i < gids.size(); ++i) {
+    roots[i] = find(i);
+  }
+  return roots;
+}
+
+//! Return true if a and b assign cells to the same clusters
+bool
+samePartition(std::vector<std::uint32_t> const& a,
+              std::vector<std::uint32_t> const& b)
+{
+  std::map<std::uint32_t, std::uint32_t> aToB;
+  std::map<std::uint32_t, std::uint32_t> bToA;
+  for (std::size_t i = 0; i < a.size(); ++i) {
+    if (aToB.emplace(a[i], b[i]).first->second != b[i] ||
+        bToA.emplace(b[i], a[i]).first->second != a[i]) {
+      return false;
+    }
+  }
+  return true;
+}
+
+TEST_CASE("Adjacent cells are clustered", "")
+{
+  falaise::cell_clusterer clusterer{2, 9, 113};
+  REQUIRE(clusterer.rows() == 113);
+
+  // Diagonal track across a word boundary of rows, a separate cell two
+  // rows away, a repeated cell, and the same cells on the other side
+  std::vector<std::uint64_t> gids = {cellKey(0, 0, 62),
+                                     cellKey(0, 1, 63),
+                                     cellKey(0, 2, 64),
+                                     cellKey(0, 2, 66),
+                                     cellKey(0, 1, 63),
+                                     cellKey(1, 0, 62),
+                                     cellKey(1, 8, 112)};
+  std::vector<std::uint32_t> clusters(gids.size());
+  REQUIRE(clusterer.cluster(gids.data(), gids.size(), clusters.data()) == 4);
+  REQUIRE(clusters == std::vector<std::uint32_t>{0, 0, 0, 1, 0, 2, 3});
+
+  // Numbers follow the first cell, not input order
+  std::reverse(gids.begin(), gids.end());
+  REQUIRE(clusterer.cluster(gids.data(), gids.size(), clusters.data()) == 4);
+  REQUIRE(clusters == std::vector<std::uint32_t>{3, 2, 0, 1, 0, 0, 0});
+
+  // Runs along a layer join the layers they touch at either end
+  gids = {cellKey(0, 4, 10),
+          cellKey(0, 4, 11),
+          cellKey(0, 4, 12),
+          cellKey(0, 3, 9),
+          cellKey(0, 5, 13),
+          cellKey(0, 3, 14)};
+  clusters.resize(gids.size());
+  REQUIRE(clusterer.cluster(gids.data(), gids.size(), clusters.data()) == 2);
+  REQUIRE(clusters == std::vector<std::uint32_t>{0, 0, 0, 0, 0, 1});
+
+  REQUIRE(clusterer.cluster(nullptr, 0, nullptr) == 0);
+}
+
+TEST_CASE("Clusters match pairwise clustering", "")
+{
+  falaise::cell_clusterer clusterer{2, 9, 113};
+  std::mt19937 rng{12345};
+  std::uniform_int_distribution<std::uint32_t> side{0, 1};
+  std::uniform_int_distribution<std::uint32_t> layer{0, 8};
+  std::uniform_int_distribution<std::uint32_t> row{0, 112};
+
+  for (std::size_t n : {1, 10, 100, 500, 1500}) {
+    for (int event = 0; event < 20; ++event) {
+      std::vector<std::uint64_t> gids(n);
+      for (auto& g : gids) {
+        g = cellKey(side(rng), layer(rng), row(rng));
+      }
+      std::vector<std::uint32_t> clusters(n);
+      auto nClusters = clusterer.cluster(gids.data(), n, clusters.data());
+      REQUIRE(samePartition(clusters, naiveClusters(gids)));
+      REQUIRE(nClusters ==
+              1 + *std::max_element(clusters.begin(), clusters.end()));
+    }
+  }
+}
+
+TEST_CASE("Adjacent cells are neighbours in a square grid", "")
+{
+  // Cells of a square grid of pitch 44, as in the tracker, with the
+  // neighbours shared_tracker_cells gives them
+  std::vector<falaise::tracker_cell_table::entry> entries;
+  for (std::uint32_t side = 0; side < 2; ++side) {
+    for (std::uint32_t layer = 0; layer < 4; ++layer) {
+      for (std::uint32_t row = 0; row < 70; ++row) {
+        double x = (side == 0 ? -1.0 : 1.0) * (22.0 + 44.0 * layer);
+        entries.push_back(
+          {cellKey(side, layer, row), {x, 44.0 * row, -1.0, 1.0, 2.0}});
+      }
+    }
+  }
+  falaise::tracker_cell_table cells{entries};
+  falaise::cell_adjacency adjacency{cells, 1.5 * falaise::anode_pitch(cells)};
+
+  falaise::cell_clusterer clusterer{2, 4, 70};
+  std::uint32_t clusters[2];
+  for (std::uint32_t i = 0; i < cells.size(); ++i) {
+    for (std::uint32_t j = 0; j < cells.size(); ++j) {
+      std::uint64_t const gids[] = {cells.gid(i), cells.gid(j)};
+      bool const joined = clusterer.cluster(gids, 2, clusters) == 1;
+      if (i != j && joined != adjacency.are_neighbours(i, j)) {
+        FAIL("cells " << i << " and " << j << " disagree");
+      }
+    }
+  }
+}
+
+TEST_CASE("Cells outside the clusterer are rejected", "")
+{
+  falaise::cell_clusterer clusterer{2, 9, 113};
+  std::vector<std::uint64_t> gids = {cellKey(0, 0, 0), cellKey(0, 0, 113)};
+  std::uint32_t clusters[2];
+  REQUIRE_THROWS_AS(clusterer.cluster(gids.data(), 2, clusters),
+                    std::out_of_range);
+  gids[1] = cellKey(0, 9, 0);
+  REQUIRE_THROWS_AS(clusterer.cluster(gids.data(), 2, clusters),
+                    std::out_of_range);
+
+  // Nothing left behind by the failures
+  REQUIRE(clusterer.cluster(gids.data(), 1, clusters) == 1);
+}
@@ -0,0 +1,228 @@
+#include "catch.hpp"
+
+#include "cell_constants_cache.h"
+
+#include <atomic>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+// - Fixtures and helpers
+const std::string constantsDir{"cell_constants_cache_t.d"};
+
+// Directory of constants files of one cell, with anode_t0 giving the file
+struct ConstantsDir {
+  explicit ConstantsDir(std::vector<std::string> const& names)
+  {
+    ::mkdir(constantsDir.c_str(), 0755);
+    for (std::size_t i = 0; i < names.size(); ++i) {
+      files.push_back(constantsDir + "/" + names[i]);
+      falaise::write_cell_constants(
+        files.back(),
+        {{falaise::pack_geom_id({1204, 0, 0, 0, 0}), {1.0 * i, 0, 1, 0.05}}});
+    }
+  }
+
+  ~ConstantsDir()
+  {
+    for (auto const& f : files) {
+      std::remove(f.c_str());
+    }
+    ::rmdir(constantsDir.c_str());
+  }
+
+  std::vector<std::string> files;
+};
+
+// Loader counting its calls
+struct CountingLoader {
+  falaise::cell_constants_table
+  operator()(std::string const& path)
+  {
+    ++*calls;
+    return falaise::cell_constants_table::map_file(path);
+  }
+
+  std::shared_ptr<std::atomic<int>> calls{new std::atomic<int>{0}};
+};
+
+TEST_CASE("Intervals are found from file names", "")
+{
+  ConstantsDir dir{{"200-299.bin", "100-199.bin", "300-300.bin", "notes.txt",
+                    "1-2.txt", "5-3.bin", "x-9.bin"}};
+  falaise::cell_constants_cache cache{
+    constantsDir, falaise::cell_constants_table::map_file, 4, false};
+
+  auto const& intervals = cache.intervals();
+  REQUIRE(intervals.size() == 3);
+  REQUIRE(intervals[0].first == 100);
+  REQUIRE(intervals[0].last == 199);
+  REQUIRE(intervals[0].path == constantsDir + "/100-199.bin");
+  REQUIRE(intervals[1].first == 200);
+  REQUIRE(intervals[2].first == 300);
+  REQUIRE(intervals[2].last == 300);
+}
+
+TEST_CASE("Constants are switched when the interval changes", "")
+{
+  ConstantsDir dir{{"100-199.bin", "200-299.bin", "400-499.bin"}};
+  CountingLoader loader;
+  falaise::cell_constants_cache cache{constantsDir, loader, 2, false};
+
+  auto a = cache.get(100);
+  REQUIRE((*a)[0].anode_t0 == 0.0);
+  REQUIRE(cache.get(150) == a);
+  REQUIRE(cache.get(199) == a);
+  REQUIRE(*loader.calls == 1);
+
+  auto b = cache.get(200);
+  REQUIRE((*b)[0].anode_t0 == 1.0);
+  REQUIRE(cache.get(299) == b);
+  REQUIRE(cache.get(120) == a);
+  REQUIRE(*loader.calls == 2);
+
+  SECTION("the least recently used set is evicted")
+  {
+    auto c = cache.get(400);
+    REQUIRE((*c)[0].anode_t0 == 2.0);
+    REQUIRE(*loader.calls == 3);
+    REQUIRE(cache.get(100) == a);
+    REQUIRE(*loader.calls == 3);
+    REQUIRE(cache.get(200) != b);
+    REQUIRE(*loader.calls == 4);
+
+    auto stats = cache.get_statistics();
+    REQUIRE(stats.switches == 6);
+    REQUIRE(stats.loads == 4);
+    REQUIRE(stats.prefetches == 0);
+  }
+
+  SECTION("runs outside all intervals have no constants")
+  {
+    for (std::int32_t run : {0, 99, 300, 399, 500}) {
+      REQUIRE_THROWS_AS(cache.get(run), falaise::bad_cell_constants_error);
+    }
+  }
+}
+
+TEST_CASE("The next interval is prefetched", "")
+{
+  ConstantsDir dir{{"100-199.bin", "200-299.bin", "300-399.bin"}};
+  CountingLoader loader;
+  falaise::cell_constants_cache cache{constantsDir, loader};
+
+  cache.get(100);
+  cache.wait_prefetch();
+  REQUIRE(*loader.calls == 2);
+  REQUIRE(cache.get_statistics().prefetches == 1);
+
+  auto b = cache.get(200);
+  REQUIRE((*b)[0].anode_t0 == 1.0);
+  cache.wait_prefetch();
+  auto stats = cache.get_statistics();
+  REQUIRE(stats.switches == 2);
+  REQUIRE(stats.loads == 1);
+  REQUIRE(stats.prefetches == 2);
+
+  // The last interval has no next
+  cache.get(300);
+  cache.wait_prefetch();
+  REQUIRE(*loader.calls == 3);
+  REQUIRE(cache.get_statistics().loads == 1);
+}
+
+TEST_CASE("Prefetch failures are reported when the run is reached", "")
+{
+  ConstantsDir dir{{"100-199.bin", "200-299.bin"}};
+  {
+    std::FILE* f = std::fopen(dir.files[1].c_str(), "w");
+    std::fputs("not constants", f);
+    std::fclose(f);
+  }
+  falaise::cell_constants_cache cache{
+    constantsDir, falaise::cell_constants_table::map_file};
+  cache.get(100);
+  cache.wait_prefetch();
+  REQUIRE(cache.get_statistics().prefetches == 0);
+  REQUIRE_THROWS_AS(cache.get(200), falaise::bad_cell_constants_error);
+}
+
+TEST_CASE("Constants are shared by concurrent runs", "")
+{
+  ConstantsDir dir{{"0-9.bin", "10-19.bin", "20-29.bin", "30-39.bin"}};
+  falaise::cell_constants_cache cache{
+    constantsDir, falaise::cell_constants_table::map_file, 2};
+
+  std::atomic<int> wrong{0};
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; ++t) {
+    threads.emplace_back([&cache, &wrong, t] {
+      for (int i = 0; i < 1000; ++i) {
+        std::int32_t run = (7 * i + t) % 40;
+        if ((*cache.get(run))[0].anode_t0 != run / 10) {
+          ++wrong;
+        }
+      }
+    });
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+  REQUIRE(wrong == 0);
+}
+
+TEST_CASE("Sets are loaded once, without holding up other intervals", "")
+{
+  ConstantsDir dir{{"100-199.bin", "200-299.bin"}};
+  std::atomic<int> calls{0};
+  std::atomic<bool> release{false};
+  auto loader = [&calls, &release](std::string const& path) {
+    ++calls;
+    // Hold the load of the first interval until released
+    while (path.find("/100-") != std::string::npos && !release) {
+      std::this_thread::yield();
+    }
+    return falaise::cell_constants_table::map_file(path);
+  };
+  falaise::cell_constants_cache cache{constantsDir, loader, 4, false};
+  cache.get(200);
+
+  falaise::cell_constants_cache::table_ptr a;
+  falaise::cell_constants_cache::table_ptr b;
+  std::thread first{[&] { a = cache.get(100); }};
+  while (calls < 2) {
+    std::this_thread::yield();
+  }
+  std::thread second{[&] { b = cache.get(150); }};
+
+  // A cached interval is served while the other is loading
+  REQUIRE((*cache.get(250))[0].anode_t0 == 1.0);
+  release = true;
+  first.join();
+  second.join();
+  REQUIRE(a == b);
+  REQUIRE((*a)[0].anode_t0 == 0.0);
+  REQUIRE(calls == 2);
+  REQUIRE(cache.get_statistics().loads == 2);
+}
+
+TEST_CASE("Bad cache configurations are rejected", "")
+{
+  ConstantsDir dir{{"100-199.bin", "150-249.bin"}};
+  REQUIRE_THROWS_AS(
+    falaise::cell_constants_cache(
+      constantsDir, falaise::cell_constants_table::map_file, 4, false),
+    falaise::bad_cell_constants_error);
+  REQUIRE_THROWS_AS(
+    falaise::cell_constants_cache(
+      "no/such/directory", falaise::cell_constants_table::map_file, 4, false),
+    falaise::bad_cell_constants_error);
+  REQUIRE_THROWS_AS(
+    falaise::cell_constants_cache(
+      "no/such/directory", falaise::cell_constants_table::map_file, 0, false),
+    falaise::bad_cell_constants_error);
+}
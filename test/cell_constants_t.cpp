@@ -0,0 +1,157 @@
+#include "catch.hpp"
+
+#include "cell_constants.h"
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <vector>
+
+// - Fixtures and helpers
+// Cells [1204:0.side.layer.row] of a reduced tracker, rows along y
+std::vector<falaise::tracker_cell_table::entry>
+makeCells(std::uint32_t nLayers, std::uint32_t nRows)
+{
+  std::vector<falaise::tracker_cell_table::entry> cells;
+  for (std::uint32_t side = 0; side < 2; ++side) {
+    for (std::uint32_t layer = 0; layer < nLayers; ++layer) {
+      for (std::uint32_t row = 0; row < nRows; ++row) {
+        double x = (side == 0 ? -1.0 : 1.0) * (30.0 + 44.0 * layer);
+        double y = 44.0 * row;
+        auto key = falaise::pack_geom_id({1204, 0, side, layer, row});
+        cells.push_back({key, {x, y, -1450.0, 1450.0, 2900.0}});
+      }
+    }
+  }
+  return cells;
+}
+
+// Distinct constants for each cell of cells, in reverse order
+std::vector<falaise::cell_constants_table::entry>
+makeConstants(std::vector<falaise::tracker_cell_table::entry> const& cells)
+{
+  std::vector<falaise::cell_constants_table::entry> entries;
+  for (std::size_t i = cells.size(); i-- > 0;) {
+    entries.push_back({cells[i].gid, {1.0 * i, 2.0 * i, 1.0 + 1e-3 * i, 0.05}});
+  }
+  return entries;
+}
+
+const std::string binaryFile{"cell_constants_t.bin"};
+
+TEST_CASE("cell_constants_table orders constants as cell indices", "")
+{
+  auto cells = makeCells(9, 113);
+  falaise::tracker_cell_table table{cells};
+  falaise::cell_constants_table constants{makeConstants(cells)};
+
+  REQUIRE(constants.size() == table.size());
+  REQUIRE(constants.matches(table));
+  for (std::uint32_t i = 0; i < table.size(); ++i) {
+    REQUIRE(constants.gid(i) == table.gid(i));
+  }
+
+  SECTION("tables of other cells do not match")
+  {
+    falaise::tracker_cell_table smaller{makeCells(9, 112)};
+    REQUIRE(!constants.matches(smaller));
+  }
+
+  SECTION("cells may only appear once")
+  {
+    auto entries = makeConstants(cells);
+    entries.push_back(entries.front());
+    REQUIRE_THROWS_AS(falaise::cell_constants_table{entries},
+                      falaise::bad_cell_constants_error);
+  }
+}
+
+TEST_CASE("cell_constants_table holds uniform constants", "")
+{
+  falaise::tracker_cell_table table{makeCells(2, 4)};
+  falaise::cell_constants_table constants{table, {1.0, 2.0, 3.0, 4.0}};
+  REQUIRE(constants.matches(table));
+  REQUIRE(constants[5].anode_t0 == 1.0);
+  REQUIRE(constants[5].plasma_speed == 4.0);
+}
+
+TEST_CASE("Constants are read from text", "")
+{
+  std::istringstream text{"# geom_id anode_t0 cathode_t0 factor speed\n"
+                          "\n"
+                          "[1204:0.1.2.3]  12.5 3 1.01 0.05 # comment\n"
+                          "[1204:0.0.0.0]  -1   0 1    0.04\n"};
+  auto entries = falaise::read_cell_constants_text(text);
+  REQUIRE(entries.size() == 2);
+  REQUIRE(entries[0].gid == falaise::pack_geom_id({1204, 0, 1, 2, 3}));
+  REQUIRE(entries[0].constants.anode_t0 == 12.5);
+  REQUIRE(entries[0].constants.cathode_t0 == 3.0);
+  REQUIRE(entries[0].constants.radius_factor == 1.01);
+  REQUIRE(entries[0].constants.plasma_speed == 0.05);
+  REQUIRE(entries[1].gid == falaise::pack_geom_id({1204, 0, 0, 0, 0}));
+
+  for (std::string bad : {"1204:0.1.2.3 1 2 3 4",
+                          "[1204:0.1.2.] 1 2 3 4",
+                          "[1204:0.1.2.3.4] 1 2 3 4",
+                          "[1204:0.1.2.3] 1 2 3",
+                          "[1204:0.1.2.3] 1 2 3 4 5"}) {
+    std::istringstream in{bad};
+    REQUIRE_THROWS_AS(falaise::read_cell_constants_text(in),
+                      falaise::bad_cell_constants_error);
+  }
+}
+
+TEST_CASE("Binary constants files are mapped as written", "")
+{
+  auto cells = makeCells(9, 113);
+  falaise::tracker_cell_table table{cells};
+  falaise::cell_constants_table expected{makeConstants(cells)};
+  falaise::write_cell_constants(binaryFile, makeConstants(cells));
+
+  auto mapped = falaise::cell_constants_table::map_file(binaryFile);
+  REQUIRE(mapped.matches(table));
+  for (std::uint32_t i = 0; i < table.size(); ++i) {
+    REQUIRE(mapped[i].anode_t0 == expected[i].anode_t0);
+    REQUIRE(mapped[i].cathode_t0 == expected[i].cathode_t0);
+    REQUIRE(mapped[i].radius_factor == expected[i].radius_factor);
+    REQUIRE(mapped[i].plasma_speed == expected[i].plasma_speed);
+  }
+
+  SECTION("copies share the mapping")
+  {
+    auto copy = mapped;
+    mapped = falaise::cell_constants_table{};
+    REQUIRE(copy.matches(table));
+    REQUIRE(copy[7].cathode_t0 == expected[7].cathode_t0);
+  }
+
+  SECTION("files that are not constants are rejected")
+  {
+    {
+      std::ofstream out{binaryFile};
+      out << "[1204:0.1.2.3] 1 2 3 4 is text, not binary\n";
+    }
+    REQUIRE_THROWS_AS(falaise::cell_constants_table::map_file(binaryFile),
+                      falaise::bad_cell_constants_error);
+  }
+
+  SECTION("truncated files are rejected")
+  {
+    std::vector<char> bytes;
+    {
+      std::ifstream in{binaryFile, std::ios::binary};
+      bytes.assign(std::istreambuf_iterator<char>{in}, {});
+    }
+    {
+      std::ofstream out{binaryFile, std::ios::binary | std::ios::trunc};
+      out.write(bytes.data(), bytes.size() - 8);
+    }
+    REQUIRE_THROWS_AS(falaise::cell_constants_table::map_file(binaryFile),
+                      falaise::bad_cell_constants_error);
+  }
+
+  REQUIRE_THROWS_AS(
+    falaise::cell_constants_table::map_file("no/such/constants.bin"),
+    falaise::bad_cell_constants_error);
+  std::remove(binaryFile.c_str());
+}
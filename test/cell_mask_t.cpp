@@ -0,0 +1,73 @@
+#include "catch.hpp"
+
+#include "cell_mask.h"
+
+#include <algorithm>
+#include <sstream>
+#include <vector>
+
+// - Fixtures and helpers
+// Cells [1204:0.side.layer.row] of a reduced tracker, rows along y
+falaise::tracker_cell_table
+makeCells(std::uint32_t nLayers, std::uint32_t nRows)
+{
+  std::vector<falaise::tracker_cell_table::entry> cells;
+  for (std::uint32_t side = 0; side < 2; ++side) {
+    for (std::uint32_t layer = 0; layer < nLayers; ++layer) {
+      for (std::uint32_t row = 0; row < nRows; ++row) {
+        double x = (side == 0 ? -1.0 : 1.0) * (30.0 + 44.0 * layer);
+        double y = 44.0 * row;
+        auto key = falaise::pack_geom_id({1204, 0, side, layer, row});
+        cells.push_back({key, {x, y, -1450.0, 1450.0, 2900.0}});
+      }
+    }
+  }
+  return falaise::tracker_cell_table{cells};
+}
+
+TEST_CASE("cell_mask holds one bit per cell", "")
+{
+  falaise::cell_mask mask{2034};
+  REQUIRE(mask.size() == 2034);
+  REQUIRE(mask.count() == 0);
+
+  std::vector<std::uint32_t> masked{0, 1, 63, 64, 127, 1000, 2033};
+  for (auto i : masked) {
+    mask.set(i);
+  }
+  mask.set(64);
+  REQUIRE(mask.count() == masked.size());
+  for (std::uint32_t i = 0; i < mask.size(); ++i) {
+    bool expected =
+      std::find(masked.begin(), masked.end(), i) != masked.end();
+    REQUIRE(mask.test(i) == expected);
+  }
+}
+
+TEST_CASE("Cell masks are read from text", "")
+{
+  auto cells = makeCells(9, 113);
+  std::istringstream text{"# dead cells\n"
+                          "\n"
+                          "[1204:0.1.2.3]  # no HV\n"
+                          "[1204:0.0.0.0]\n"
+                          "[1204:0.1.2.3]\n"};
+  auto mask = falaise::read_cell_mask(text, cells);
+  REQUIRE(mask.size() == cells.size());
+  REQUIRE(mask.count() == 2);
+  REQUIRE(mask.test(cells.index(falaise::pack_geom_id({1204, 0, 1, 2, 3}))));
+  REQUIRE(mask.test(cells.index(falaise::pack_geom_id({1204, 0, 0, 0, 0}))));
+  REQUIRE(!mask.test(cells.index(falaise::pack_geom_id({1204, 0, 0, 0, 1}))));
+
+  for (std::string bad : {"1204:0.1.2.3",
+                          "[1204:0.1.2.]",
+                          "[1204:0.1.2.3] dead",
+                          "[1204:0.1.9.3]",
+                          "[1302:0.1.2.3]"}) {
+    std::istringstream in{bad};
+    REQUIRE_THROWS_AS(falaise::read_cell_mask(in, cells),
+                      falaise::bad_cell_mask_error);
+  }
+  REQUIRE_THROWS_AS(falaise::load_cell_mask("no/such/mask.txt", cells),
+                    falaise::bad_cell_mask_error);
+}
@@ -0,0 +1,90 @@
+#include "catch.hpp"
+
+#include "concurrent_queue.h"
+
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include <thread>
+#include <vector>
+
+TEST_CASE("bounded_queue is first in first out", "")
+{
+  falaise::bounded_queue<int> q{4};
+  for (int i = 0; i < 4; ++i) {
+    REQUIRE(q.push(i));
+  }
+  for (int i = 0; i < 4; ++i) {
+    int x{-1};
+    REQUIRE(q.pop(x));
+    REQUIRE(x == i);
+  }
+
+  SECTION("closed queues drain then fail")
+  {
+    int x{42};
+    REQUIRE(q.push(x));
+    q.close();
+    int y{0};
+    REQUIRE(!q.push(y));
+    REQUIRE(q.pop(y));
+    REQUIRE(y == 42);
+    REQUIRE(!q.pop(y));
+  }
+}
+
+TEST_CASE("bounded_queue transfers all items between threads", "")
+{
+  falaise::bounded_queue<int> q{8};
+  int const nItems{10000};
+  std::vector<std::vector<int>> received(4);
+
+  std::vector<std::thread> consumers;
+  for (auto& r : received) {
+    consumers.emplace_back([&q, &r] {
+      int x{0};
+      while (q.pop(x)) {
+        r.push_back(x);
+      }
+    });
+  }
+  for (int i = 0; i < nItems; ++i) {
+    q.push(i);
+  }
+  q.close();
+  for (auto& c : consumers) {
+    c.join();
+  }
+
+  std::vector<int> all;
+  for (auto const& r : received) {
+    // Each consumer sees items in queue order
+    REQUIRE(std::is_sorted(r.begin(), r.end()));
+    all.insert(all.end(), r.begin(), r.end());
+  }
+  std::sort(all.begin(), all.end());
+  std::vector<int> expected(nItems);
+  std::iota(expected.begin(), expected.end(), 0);
+  REQUIRE(all == expected);
+}
+
+TEST_CASE("reorder_buffer releases items in sequence", "")
+{
+  std::vector<std::size_t> order(100);
+  std::iota(order.begin(), order.end(), 0);
+  std::shuffle(order.begin(), order.end(), std::mt19937{42});
+
+  falaise::reorder_buffer<std::size_t> buffer;
+  std::vector<std::size_t> released;
+  for (auto seq : order) {
+    buffer.insert(seq, seq * 10);
+    std::size_t item{0};
+    while (buffer.release(item)) {
+      released.push_back(item / 10);
+    }
+  }
+  REQUIRE(buffer.pending() == 0);
+  REQUIRE(buffer.next() == 100);
+  REQUIRE(released.size() == 100);
+  REQUIRE(std::is_sorted(released.begin(), released.end()));
+}
@@ -0,0 +1,96 @@
+#include "catch.hpp"
+
+#include "drift_model.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+// - Fixtures and helpers
+// Mock relation with anode velocity 1 cm/us, halving at 1 cm (mm, ns)
+double
+driftRadius(double t)
+{
+  return falaise::mock_drift_radius(t, 0.01, 10.0);
+}
+
+double
+driftTime(double r)
+{
+  return falaise::mock_drift_time(r, 0.01, 10.0);
+}
+
+// Largest error in radius over a fine grid of times in [0, max_time]
+double
+maxRadiusError(falaise::drift_model const& m)
+{
+  double error{0.0};
+  for (int i = 0; i <= 10000; ++i) {
+    double t = m.max_time() * i / 10000;
+    error = std::max(error, std::abs(m.radius(t) - driftRadius(t)));
+  }
+  return error;
+}
+
+TEST_CASE("drift_model rejects relations it cannot tabulate", "")
+{
+  REQUIRE_THROWS_AS(falaise::drift_model(driftRadius, 1000.0, 1),
+                    falaise::bad_drift_model_error);
+  REQUIRE_THROWS_AS(falaise::drift_model(driftRadius, 0.0, 100),
+                    falaise::bad_drift_model_error);
+  REQUIRE_THROWS_AS(
+    falaise::drift_model([](double) { return 1.0; }, 1000.0, 100),
+    falaise::bad_drift_model_error);
+}
+
+TEST_CASE("drift_model reproduces linear relations everywhere", "")
+{
+  falaise::drift_model m{[](double t) { return 0.02 * t; }, 1000.0, 3};
+  REQUIRE(m.size() == 3);
+  REQUIRE(m.max_time() == 1000.0);
+  REQUIRE(m.max_radius() == Approx(20.0));
+
+  // Including extrapolation outside the tables
+  for (double t : {-100.0, 0.0, 1.0, 333.3, 500.0, 999.0, 1000.0, 2500.0}) {
+    REQUIRE(m.radius(t) == Approx(0.02 * t).margin(1e-12));
+    REQUIRE(m.time(0.02 * t) == Approx(t).margin(1e-9));
+  }
+}
+
+TEST_CASE("drift_model interpolates the mock relation", "")
+{
+  double const maxTime = driftTime(35.0);
+  falaise::drift_model coarse{driftRadius, maxTime, 64};
+  falaise::drift_model fine{driftRadius, maxTime, 512};
+  REQUIRE(fine.max_radius() == Approx(35.0));
+  REQUIRE(fine.time(35.0) == Approx(maxTime));
+
+  // Error falls as the square of the spacing, 64 times for 8 times finer
+  REQUIRE(maxRadiusError(fine) < 1e-3);
+  REQUIRE(maxRadiusError(fine) < maxRadiusError(coarse) / 32);
+
+  for (double r : {0.5, 2.0, 11.0, 22.0, 30.0}) {
+    REQUIRE(fine.time(r) == Approx(driftTime(r)).epsilon(1e-3));
+    REQUIRE(fine.radius(fine.time(r)) == Approx(r).epsilon(1e-3));
+  }
+}
+
+TEST_CASE("drift_model buffer evaluation matches single values", "")
+{
+  falaise::drift_model m{driftRadius, driftTime(35.0), 256};
+  std::vector<double> in;
+  for (int i = 0; i < 1001; ++i) {
+    in.push_back(0.05 * i * i);
+  }
+  std::vector<double> out(in.size());
+
+  m.radius(in.data(), out.data(), in.size());
+  for (std::size_t i = 0; i < in.size(); ++i) {
+    REQUIRE(out[i] == m.radius(in[i]));
+  }
+
+  m.time(in.data(), out.data(), in.size());
+  for (std::size_t i = 0; i < in.size(); ++i) {
+    REQUIRE(out[i] == m.time(in[i]));
+  }
+}
@@ -0,0 +1,96 @@
+#include "catch.hpp"
+
+#include "event_bank.h"
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "bayeux/datatools/things.h"
+
+// - Fixtures and helpers
+//! Bank counting its constructions and assignments
+struct CountedBank : public datatools::i_serializable {
+  CountedBank() { ++constructed; }
+  CountedBank(CountedBank const& other) : values(other.values)
+  {
+    ++constructed;
+    ++copied;
+  }
+  CountedBank(CountedBank&& other) : values(std::move(other.values))
+  {
+    ++constructed;
+    ++moved;
+  }
+  CountedBank&
+  operator=(CountedBank const& other)
+  {
+    values = other.values;
+    ++copied;
+    return *this;
+  }
+  CountedBank&
+  operator=(CountedBank&& other)
+  {
+    values = std::move(other.values);
+    ++moved;
+    return *this;
+  }
+
+  std::string const&
+  get_serial_tag() const override
+  {
+    static std::string const tag{"CountedBank"};
+    return tag;
+  }
+
+  std::vector<int> values;
+
+  static int constructed;
+  static int copied;
+  static int moved;
+
+  static void
+  resetCounts()
+  {
+    constructed = 0;
+    copied = 0;
+    moved = 0;
+  }
+};
+
+int CountedBank::constructed = 0;
+int CountedBank::copied = 0;
+int CountedBank::moved = 0;
+
+TEST_CASE("add_bank fills the bank held by the event in place", "")
+{
+  datatools::things event;
+  CountedBank::resetCounts();
+  auto& bank = falaise::add_bank<CountedBank>(
+    event, "CD", [](CountedBank& b) { b.values = {1, 2, 3}; });
+
+  REQUIRE(CountedBank::constructed == 1);
+  REQUIRE(CountedBank::copied == 0);
+  REQUIRE(CountedBank::moved == 0);
+  REQUIRE(&bank == &event.get<CountedBank>("CD"));
+  REQUIRE(bank.values == std::vector<int>{1, 2, 3});
+}
+
+TEST_CASE("add_bank removes the bank if filling it fails", "")
+{
+  datatools::things event;
+  REQUIRE_THROWS_AS(falaise::add_bank<CountedBank>(
+                      event,
+                      "CD",
+                      [](CountedBank&) { throw std::runtime_error("fill"); }),
+                    std::runtime_error);
+  REQUIRE(!event.has("CD"));
+
+  // An existing bank is left alone
+  falaise::add_bank<CountedBank>(
+    event, "CD", [](CountedBank& b) { b.values = {1}; });
+  REQUIRE_THROWS(falaise::add_bank<CountedBank>(
+    event, "CD", [](CountedBank& b) { b.values = {2}; }));
+  REQUIRE(event.get<CountedBank>("CD").values == std::vector<int>{1});
+}
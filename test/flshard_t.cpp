@@ -0,0 +1,190 @@
+#include "catch.hpp"
+
+#include <sys/wait.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "bayeux/datatools/multi_properties.h"
+#include "bayeux/datatools/things.h"
+#include "bayeux/dpp/input_module.h"
+#include "bayeux/dpp/output_module.h"
+#include "falaise/falaise.h"
+#include "falaise/snemo/datamodels/event_header.h"
+
+#include "synthetic_events.h"
+
+// - Fixtures and helpers
+//! Input of nEvents numbered events, and the files of a flshard run on it
+struct ShardFixture {
+  static constexpr int nEvents = 50;
+
+  ShardFixture()
+  {
+    FALAISE_INIT();
+    dpp::output_module output;
+    output.set_single_output_file(input);
+    output.initialize_simple();
+    for (int i = 0; i < nEvents; ++i) {
+      output.process(*falaise::make_calibrated_event({}, i));
+    }
+    output.reset();
+  }
+
+  ~ShardFixture()
+  {
+    std::remove(input.c_str());
+    std::remove(pipeline.c_str());
+    std::remove(output.c_str());
+  }
+
+  std::string input{"flshard_t-input.brio"};
+  std::string pipeline{"flshard_t-pipeline.conf"};
+  std::string output{"flshard_t-output.brio"};
+};
+
+constexpr int ShardFixture::nEvents;
+
+ShardFixture&
+fixture()
+{
+  static ShardFixture f;
+  return f;
+}
+
+//! Run flshard on the input with a PipelineProbe configured by probe
+/*
+ * Returns true if flshard succeeds. See PipelineProbe.cpp for its
+ * configuration
+ */
+bool
+runShards(datatools::properties const& probe,
+          std::size_t workers,
+          std::size_t block)
+{
+  datatools::properties plugins;
+  plugins.store("plugins", std::vector<std::string>{"PipelineProbe"});
+  plugins.store("PipelineProbe.directory", std::string{PIPELINEPROBE_DIR});
+  datatools::multi_properties config{"name", "type"};
+  config.add("flreconstruct.plugins", "flreconstruct::section", plugins);
+  config.add("pipeline", "PipelineProbe", probe);
+  config.write(fixture().pipeline);
+
+  std::remove(fixture().output.c_str());
+  const std::string command = std::string{FLSHARD} + " -p " +
+                              fixture().pipeline + " -i " + fixture().input +
+                              " -o " + fixture().output + " -j " +
+                              std::to_string(workers) + " -b " +
+                              std::to_string(block);
+  const int status = std::system(command.c_str());
+  return WIFEXITED(status) && WEXITSTATUS(status) == EXIT_SUCCESS;
+}
+
+//! Return the numbers of the output's events, in file order
+std::vector<int>
+outputEvents()
+{
+  std::vector<int> result;
+  dpp::input_module input;
+  input.set_single_input_file(fixture().output);
+  input.initialize_simple();
+  datatools::things event;
+  while (!input.is_terminated()) {
+    event.clear();
+    if (input.process(event) != dpp::base_module::PROCESS_OK) {
+      break;
+    }
+    result.push_back(event.get<snemo::datamodel::event_header>("EH")
+                       .get_id()
+                       .get_event_number());
+  }
+  input.reset();
+  return result;
+}
+
+//! Return true if file exists
+bool
+exists(std::string const& file)
+{
+  return std::ifstream{file}.good();
+}
+
+TEST_CASE("Sharded output is in input order", "")
+{
+  // Blocks not dividing the events, some workers with one block more
+  std::size_t workers{3};
+  std::size_t block{4};
+  SECTION("on several workers") {}
+  SECTION("on more workers than blocks")
+  {
+    workers = 16;
+  }
+  SECTION("on one worker")
+  {
+    workers = 1;
+    block = 1000;
+  }
+
+  REQUIRE(runShards({}, workers, block));
+  std::vector<int> expected;
+  for (int i = 0; i < ShardFixture::nEvents; ++i) {
+    expected.push_back(i);
+  }
+  REQUIRE(outputEvents() == expected);
+}
+
+TEST_CASE("Rejected and failed events are not written", "")
+{
+  datatools::properties probe;
+  probe.store("stop_every", 3);
+  probe.store("error_every", 5);
+
+  // Failed events make the run fail, but with complete output
+  REQUIRE_FALSE(runShards(probe, 3, 4));
+  std::vector<int> expected;
+  for (int i = 0; i < ShardFixture::nEvents; ++i) {
+    if (i % 3 != 0 && i % 5 != 0) {
+      expected.push_back(i);
+    }
+  }
+  REQUIRE(outputEvents() == expected);
+
+  probe.erase("error_every");
+  REQUIRE(runShards(probe, 3, 4));
+  expected.clear();
+  for (int i = 0; i < ShardFixture::nEvents; ++i) {
+    if (i % 3 != 0) {
+      expected.push_back(i);
+    }
+  }
+  REQUIRE(outputEvents() == expected);
+}
+
+TEST_CASE("Fatal errors leave no output", "")
+{
+  datatools::properties probe;
+  probe.store("fatal_event", 17);
+  REQUIRE_FALSE(runShards(probe, 3, 4));
+  REQUIRE_FALSE(exists(fixture().output));
+  for (std::size_t w = 0; w < 3; ++w) {
+    REQUIRE_FALSE(exists(".flshard-" + std::to_string(w) + "-" +
+                         fixture().output));
+  }
+}
+
+TEST_CASE("Input must be a brio file", "")
+{
+  // Events are read by entry, which only brio files allow
+  const std::string input{"flshard_t-input.xml"};
+  std::remove(fixture().output.c_str());
+  const std::string command = std::string{FLSHARD} + " -p " +
+                              fixture().pipeline + " -i " + input + " -o " +
+                              fixture().output;
+  const int status = std::system(command.c_str());
+  REQUIRE(WIFEXITED(status));
+  REQUIRE(WEXITSTATUS(status) == EXIT_FAILURE);
+  REQUIRE_FALSE(exists(fixture().output));
+}
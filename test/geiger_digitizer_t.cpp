@@ -0,0 +1,316 @@
+#include "catch.hpp"
+
+#include "geiger_digitizer.h"
+
+#include <cmath>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <random>
+#include <vector>
+
+#include "bayeux/mctools/simulated_data.h"
+
+// - Global allocation counter to check steady state digitization
+namespace {
+  std::size_t allocationCount{0};
+}
+
+void*
+operator new(std::size_t n)
+{
+  ++allocationCount;
+  if (void* p = std::malloc(n == 0 ? 1 : n)) {
+    return p;
+  }
+  throw std::bad_alloc{};
+}
+
+void
+operator delete(void* p) noexcept
+{
+  std::free(p);
+}
+
+void
+operator delete(void* p, std::size_t) noexcept
+{
+  std::free(p);
+}
+
+// - Fixtures and helpers
+// Cells [1204:0.side.layer.row] of a reduced tracker, rows along y
+falaise::tracker_cell_table
+makeCells(std::uint32_t nLayers, std::uint32_t nRows)
+{
+  std::vector<falaise::tracker_cell_table::entry> cells;
+  for (std::uint32_t side = 0; side < 2; ++side) {
+    for (std::uint32_t layer = 0; layer < nLayers; ++layer) {
+      for (std::uint32_t row = 0; row < nRows; ++row) {
+        double x = (side == 0 ? -1.0 : 1.0) * (30.0 + 44.0 * layer);
+        double y = 44.0 * row;
+        auto key = falaise::pack_geom_id({1204, 0, side, layer, row});
+        cells.push_back({key, {x, y, -1450.0, 1450.0, 2900.0}});
+      }
+    }
+  }
+  return falaise::tracker_cell_table{cells};
+}
+
+// Copy of cells to share with a digitizer
+std::shared_ptr<falaise::tracker_cell_table const>
+share(falaise::tracker_cell_table const& cells)
+{
+  return std::make_shared<falaise::tracker_cell_table const>(cells);
+}
+
+// Drift at constant velocity (mm/ns), so tables are exact
+falaise::drift_model
+makeDrift(double velocity = 0.01)
+{
+  return {[velocity](double t) { return velocity * t; }, 5000.0, 2};
+}
+
+// Step hits near the anodes of random cells
+mctools::simulated_data
+makeStepHits(falaise::tracker_cell_table const& cells,
+             std::size_t nHits,
+             std::mt19937& rng)
+{
+  std::uniform_int_distribution<std::uint32_t> cell(0, cells.size() - 1);
+  std::uniform_real_distribution<double> offset{-20.0, 20.0};
+  std::uniform_real_distribution<double> height{-1000.0, 1000.0};
+
+  mctools::simulated_data sd;
+  sd.add_step_hits("gg", nHits);
+  for (std::size_t i = 0; i < nHits; ++i) {
+    auto index = cell(rng);
+    auto const& c = cells[index];
+    auto& hit = sd.add_step_hit("gg");
+    hit.set_hit_id(i);
+    hit.set_geom_id(falaise::unpack_geom_id(cells.gid(index)));
+    hit.set_position_start(
+      {c.anode_x + offset(rng), c.anode_y + offset(rng), height(rng)});
+    hit.set_time_start(1.0 * i);
+  }
+  return sd;
+}
+
+std::vector<double>
+anodeTimes(falaise::raw_tracker_hit_buffer const& b)
+{
+  return {b.anode_times(), b.anode_times() + b.size()};
+}
+
+TEST_CASE("geiger_digitizer keeps earliest hit in each cell", "")
+{
+  auto cells = makeCells(2, 4);
+  falaise::geiger_digitizer::parameters p;
+  p.anode_efficiency = 1.0;
+  p.cathode_efficiency = 1.0;
+  falaise::geiger_digitizer digitizer{share(cells), makeDrift(), p};
+
+  // Two hits in one cell, the later one so much closer to the anode that it
+  // fires first
+  auto const& c = cells[3];
+  mctools::simulated_data sd;
+  sd.add_step_hits("gg", 2);
+  for (int i = 0; i < 2; ++i) {
+    auto& hit = sd.add_step_hit("gg");
+    hit.set_geom_id(falaise::unpack_geom_id(cells.gid(3)));
+    double r = (i == 0 ? 10.0 : 2.0);
+    hit.set_position_start({c.anode_x + r, c.anode_y, 0.0});
+    hit.set_time_start(i == 0 ? 0.0 : 100.0);
+  }
+
+  auto s = digitizer.make_scratch();
+  s->add_event(falaise::view_step_hits(sd, "gg"), 1, 0);
+  digitizer.digitize(*s);
+  auto const& raw = digitizer.raw_hits(*s, 0);
+
+  REQUIRE(raw.size() == 1);
+  REQUIRE(raw[0].gid == cells.gid(3));
+  REQUIRE(raw[0].anode_time == Approx(100.0 + 2.0 / 0.01));
+  REQUIRE(raw[0].has_bottom_cathode_time());
+  REQUIRE(raw[0].has_top_cathode_time());
+  REQUIRE(raw[0].bottom_cathode_time - raw[0].anode_time ==
+          Approx(1450.0 / p.plasma_speed));
+}
+
+TEST_CASE("geiger_digitizer rejects hits outside the cell table", "")
+{
+  auto cells = makeCells(2, 4);
+  falaise::geiger_digitizer digitizer{share(cells), makeDrift(), {}};
+
+  mctools::simulated_data sd;
+  sd.add_step_hits("gg", 1);
+  sd.add_step_hit("gg").set_geom_id({1204, 0, 0, 5, 0});
+
+  auto s = digitizer.make_scratch();
+  s->add_event(falaise::view_step_hits(sd, "gg"), 1, 0);
+  REQUIRE_THROWS_AS(digitizer.digitize(*s), std::logic_error);
+}
+
+TEST_CASE("geiger_digitizer drops hits in masked cells", "")
+{
+  auto cells = makeCells(2, 4);
+  falaise::geiger_digitizer::parameters p;
+  p.anode_efficiency = 1.0;
+  falaise::geiger_digitizer digitizer{share(cells), makeDrift(), p};
+  std::mt19937 rng{12345};
+  auto sd = makeStepHits(cells, 100, rng);
+
+  falaise::cell_mask mask{cells.size()};
+  for (std::uint32_t i = 0; i < cells.size(); i += 3) {
+    mask.set(i);
+  }
+  auto s = digitizer.make_scratch();
+  s->add_event(falaise::view_step_hits(sd, "gg"), 1, 0);
+  s->add_event(falaise::view_step_hits(sd, "gg"), 1, 1, &mask);
+  digitizer.digitize(*s);
+
+  auto const& unmasked = digitizer.raw_hits(*s, 0);
+  REQUIRE(unmasked.size() == cells.size());
+  auto const& masked = digitizer.raw_hits(*s, 1);
+  REQUIRE(masked.size() == cells.size() - mask.count());
+  for (std::size_t i = 0; i < masked.size(); ++i) {
+    REQUIRE(!mask.test(cells.index(masked[i].gid)));
+  }
+
+  SECTION("masks must be for the digitizer's cells")
+  {
+    falaise::cell_mask other{cells.size() + 1};
+    s->clear();
+    s->add_event(falaise::view_step_hits(sd, "gg"), 1, 0, &other);
+    REQUIRE_THROWS_AS(digitizer.digitize(*s), std::logic_error);
+  }
+}
+
+TEST_CASE("geiger_digitizer adds noise hits", "")
+{
+  auto cells = makeCells(9, 113);
+  falaise::geiger_digitizer::parameters p;
+  p.cathode_efficiency = 1.0;
+  // One in four cells noisy, two noise hits per event on average
+  double const window{5000.0};
+  std::size_t const nNoisy = (cells.size() + 3) / 4;
+  std::vector<double> rates(cells.size(), 0.0);
+  for (std::size_t i = 0; i < rates.size(); i += 4) {
+    rates[i] = 2.0 / (window * nNoisy);
+  }
+  falaise::geiger_digitizer digitizer{
+    share(cells), makeDrift(), p, falaise::noise_model{rates, window}};
+
+  mctools::simulated_data sd;
+  sd.add_step_hits("gg", 0);
+  auto s = digitizer.make_scratch();
+  for (std::int32_t e = 0; e < 1000; ++e) {
+    s->add_event(falaise::view_step_hits(sd, "gg"), 1, e);
+  }
+  digitizer.digitize(*s);
+
+  std::size_t nNoise{0};
+  for (std::size_t e = 0; e < s->events(); ++e) {
+    auto const& raw = digitizer.raw_hits(*s, e);
+    nNoise += raw.size();
+    for (std::size_t i = 0; i < raw.size(); ++i) {
+      REQUIRE(rates[cells.index(raw[i].gid)] > 0.0);
+      REQUIRE(raw[i].anode_time >= 0.0);
+      REQUIRE(raw[i].anode_time < window);
+      REQUIRE(raw[i].bottom_cathode_time + raw[i].top_cathode_time -
+                2 * raw[i].anode_time ==
+              Approx(2900.0 / p.plasma_speed));
+    }
+  }
+  REQUIRE(nNoise / 1000.0 == Approx(2.0).epsilon(0.1));
+
+  SECTION("noise is reproducible and masked")
+  {
+    falaise::cell_mask mask{cells.size()};
+    for (std::uint32_t i = 0; i < cells.size(); i += 8) {
+      mask.set(i);
+    }
+    auto t = digitizer.make_scratch();
+    t->add_event(falaise::view_step_hits(sd, "gg"), 1, 7);
+    t->add_event(falaise::view_step_hits(sd, "gg"), 1, 7, &mask);
+    digitizer.digitize(*t);
+    auto const unmasked = anodeTimes(digitizer.raw_hits(*t, 0));
+    REQUIRE(unmasked == anodeTimes(digitizer.raw_hits(*s, 7)));
+    auto const& masked = digitizer.raw_hits(*t, 1);
+    for (std::size_t i = 0; i < masked.size(); ++i) {
+      REQUIRE(!mask.test(cells.index(masked[i].gid)));
+    }
+  }
+}
+
+TEST_CASE("geiger_digitizer results do not depend on batching", "")
+{
+  auto cells = makeCells(9, 113);
+  falaise::geiger_digitizer digitizer{share(cells), makeDrift(), {}};
+  std::mt19937 rng{12345};
+  std::vector<mctools::simulated_data> events;
+  for (std::size_t e = 0; e < 16; ++e) {
+    events.push_back(makeStepHits(cells, 1 + e * 5, rng));
+  }
+
+  auto batched = digitizer.make_scratch();
+  for (std::size_t e = 0; e < events.size(); ++e) {
+    batched->add_event(falaise::view_step_hits(events[e], "gg"), 1, e);
+  }
+  digitizer.digitize(*batched);
+  std::vector<std::vector<double>> times;
+  for (std::size_t e = 0; e < events.size(); ++e) {
+    times.push_back(anodeTimes(digitizer.raw_hits(*batched, e)));
+  }
+
+  auto single = digitizer.make_scratch();
+  for (std::size_t e = events.size(); e-- > 0;) {
+    single->clear();
+    single->add_event(falaise::view_step_hits(events[e], "gg"), 1, e);
+    digitizer.digitize(*single);
+    REQUIRE(anodeTimes(digitizer.raw_hits(*single, 0)) == times[e]);
+  }
+}
+
+TEST_CASE("geiger_digitizer reuses scratch without allocating", "")
+{
+  auto cells = makeCells(9, 113);
+  std::mt19937 rng{12345};
+  std::vector<mctools::simulated_data> events;
+  for (std::size_t e = 0; e < 64; ++e) {
+    events.push_back(makeStepHits(cells, 200, rng));
+  }
+
+  for (auto const& id : falaise::random_stream_registry::instance().ids()) {
+    SECTION(id)
+    {
+      falaise::geiger_digitizer::parameters p;
+      p.random_id = id;
+      falaise::geiger_digitizer digitizer{share(cells), makeDrift(), p};
+      auto s = digitizer.make_scratch();
+      std::size_t nRawHits{0};
+      auto digitizeAll = [&](std::size_t batchSize) {
+        for (std::size_t first = 0; first < events.size();
+             first += batchSize) {
+          s->clear();
+          for (std::size_t e = first; e < first + batchSize; ++e) {
+            s->add_event(falaise::view_step_hits(events[e], "gg"), 1, e);
+          }
+          digitizer.digitize(*s);
+          for (std::size_t e = 0; e < s->events(); ++e) {
+            nRawHits += digitizer.raw_hits(*s, e).size();
+          }
+        }
+      };
+
+      // Grow scratch to the largest batch, then any smaller batches reuse it
+      digitizeAll(16);
+      std::size_t const warm = allocationCount;
+      for (std::size_t batchSize : {1, 4, 16, 8}) {
+        digitizeAll(batchSize);
+      }
+      REQUIRE(allocationCount == warm);
+      REQUIRE(nRawHits > 0);
+    }
+  }
+}
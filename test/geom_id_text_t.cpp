@@ -0,0 +1,91 @@
+#include "catch.hpp"
+
+#include "geom_id_text.h"
+
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "packed_geom_id.h"
+#include "tracker_cell_table.h"
+
+// - Fixtures and helpers
+//! Return the message of the bad_geom_id_text_error reading text throws
+std::string
+errorOf(std::string const& text)
+{
+  std::istringstream in{text};
+  try {
+    falaise::read_geom_id_text(in, [](std::uint64_t, std::istream& fields) {
+      int value{0};
+      if (!(fields >> value)) {
+        throw falaise::bad_geom_id_text_error("expected a value");
+      }
+    });
+  }
+  catch (falaise::bad_geom_id_text_error const& e) {
+    return e.what();
+  }
+  return "";
+}
+
+TEST_CASE("Rows are read with their packed geom_id", "")
+{
+  std::istringstream text{"# geom_id  value\n"
+                          "\n"
+                          "[1204:0.1.2.3] 7  # noisy\n"
+                          "  [1302:0.0.5] 8\n"};
+  std::vector<std::pair<std::uint64_t, int>> rows;
+  falaise::read_geom_id_text(
+    text, [&rows](std::uint64_t gid, std::istream& fields) {
+      int value{0};
+      fields >> value;
+      rows.emplace_back(gid, value);
+    });
+  REQUIRE(rows.size() == 2);
+  REQUIRE(rows[0].first == falaise::pack_geom_id({1204, 0, 1, 2, 3}));
+  REQUIRE(rows[0].second == 7);
+  REQUIRE(rows[1].first == falaise::pack_geom_id({1302, 0, 0, 5}));
+  REQUIRE(rows[1].second == 8);
+}
+
+TEST_CASE("Errors give the line and what is wrong", "")
+{
+  REQUIRE(errorOf("# ok\n[1204:0.1.2.3] 1\n1204:0.1.2.3 1\n") ==
+          "line 3: malformed geom_id '1204:0.1.2.3'");
+  REQUIRE(errorOf("[1204:0.1.2.3.4.5] 1\n") ==
+          "line 1: malformed geom_id '[1204:0.1.2.3.4.5]'");
+  REQUIRE(errorOf("[1204:0.1.2.3] x\n") == "line 1: expected a value");
+  REQUIRE(errorOf("\n[1204:0.1.2.3] 1 2\n") == "line 2: unexpected '2'");
+  REQUIRE(errorOf("[1204:0.1.2.3] 1\n").empty());
+}
+
+TEST_CASE("Tracker cell rows are read with their cell index", "")
+{
+  std::vector<falaise::tracker_cell_table::entry> entries;
+  for (std::uint32_t row = 0; row < 4; ++row) {
+    entries.push_back({falaise::pack_geom_id({1204, 0, 0, 0, row}),
+                       {0.0, 44.0 * row, -1450.0, 1450.0, 2900.0}});
+  }
+  falaise::tracker_cell_table const cells{entries};
+
+  std::istringstream text{"[1204:0.0.0.3]\n[1204:0.0.0.1]\n"};
+  std::vector<std::uint32_t> indices;
+  falaise::read_tracker_cell_text(
+    text, cells, [&indices](std::uint32_t index, std::istream&) {
+      indices.push_back(index);
+    });
+  REQUIRE(indices == std::vector<std::uint32_t>{3, 1});
+
+  std::istringstream other{"[1204:0.0.0.1]\n[1204:0.0.0.4]\n"};
+  try {
+    falaise::read_tracker_cell_text(
+      other, cells, [](std::uint32_t, std::istream&) {});
+    FAIL("expected bad_geom_id_text_error");
+  }
+  catch (falaise::bad_geom_id_text_error const& e) {
+    REQUIRE(std::string{e.what()} ==
+            "line 2: geom_id '[1204:0.0.0.4]' is not a tracker cell");
+  }
+}
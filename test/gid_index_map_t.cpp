@@ -0,0 +1,79 @@
+#include "catch.hpp"
+
+#include "gid_index_map.h"
+#include "packed_geom_id.h"
+
+#include <map>
+#include <random>
+
+TEST_CASE("geom_id packing round trips", "")
+{
+  geomtools::geom_id cell{1204, 0, 1, 8, 112};
+  auto key = falaise::pack_geom_id(cell);
+  REQUIRE(falaise::unpack_geom_id(key) == cell);
+
+  geomtools::geom_id other{1204, 0, 1, 8, 111};
+  REQUIRE(falaise::pack_geom_id(other) != key);
+
+  geomtools::geom_id shallow{1204, 0, 1};
+  REQUIRE(falaise::unpack_geom_id(falaise::pack_geom_id(shallow)) == shallow);
+
+  SECTION("out of range addresses throw")
+  {
+    geomtools::geom_id wide{1204, 0, 256, 0, 0};
+    REQUIRE_THROWS_AS(falaise::pack_geom_id(wide),
+                      falaise::unpackable_geom_id_error);
+  }
+}
+
+TEST_CASE("gid_index_map insertion and lookup work", "")
+{
+  falaise::gid_index_map m;
+  REQUIRE(m.empty());
+  REQUIRE(m.find(42) == nullptr);
+
+  auto r = m.try_emplace(42, 1);
+  REQUIRE(r.second);
+  REQUIRE(*r.first == 1);
+
+  SECTION("re-inserting a key returns the existing value")
+  {
+    auto s = m.try_emplace(42, 2);
+    REQUIRE(!s.second);
+    REQUIRE(*s.first == 1);
+    REQUIRE(m.size() == 1);
+  }
+
+  SECTION("clear removes all keys")
+  {
+    m.clear();
+    REQUIRE(m.empty());
+    REQUIRE(m.find(42) == nullptr);
+    REQUIRE(m.try_emplace(42, 3).second);
+  }
+}
+
+TEST_CASE("gid_index_map matches std::map under growth and reuse", "")
+{
+  falaise::gid_index_map m{4};
+  std::map<std::uint64_t, std::uint32_t> reference;
+  std::mt19937 rng{1234};
+  std::uniform_int_distribution<std::uint64_t> keys{0, 3000};
+
+  for (int event = 0; event < 20; ++event) {
+    m.clear();
+    reference.clear();
+    for (std::uint32_t i = 0; i < 1000; ++i) {
+      auto k = keys(rng);
+      auto r = m.try_emplace(k, i);
+      auto s = reference.emplace(k, i);
+      REQUIRE(r.second == s.second);
+      REQUIRE(*r.first == s.first->second);
+    }
+    REQUIRE(m.size() == reference.size());
+    for (auto const& kv : reference) {
+      REQUIRE(m.find(kv.first) != nullptr);
+      REQUIRE(*m.find(kv.first) == kv.second);
+    }
+  }
+}
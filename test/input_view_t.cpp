@@ -0,0 +1,117 @@
+#include "catch.hpp"
+
+#include "input_view.h"
+#include "step_hit_view.h"
+
+#include <cstdlib>
+#include <new>
+#include <vector>
+
+// - Global allocation counter to check views do not allocate
+namespace {
+  std::size_t allocationCount{0};
+}
+
+void*
+operator new(std::size_t n)
+{
+  ++allocationCount;
+  if (void* p = std::malloc(n == 0 ? 1 : n)) {
+    return p;
+  }
+  throw std::bad_alloc{};
+}
+
+void
+operator delete(void* p) noexcept
+{
+  std::free(p);
+}
+
+void
+operator delete(void* p, std::size_t) noexcept
+{
+  std::free(p);
+}
+
+// - Fixtures and helpers
+mctools::simulated_data
+makeSimulatedData(std::size_t nGeigerHits)
+{
+  mctools::simulated_data sd;
+  sd.add_step_hits("gg", nGeigerHits);
+  for (std::size_t i = 0; i < nGeigerHits; ++i) {
+    sd.add_step_hit("gg").set_hit_id(i);
+  }
+  return sd;
+}
+
+TEST_CASE("input_view default construction works", "")
+{
+  falaise::input_view<int> v;
+  REQUIRE(v.empty());
+  REQUIRE(v.size() == 0);
+  REQUIRE(v.begin() == v.end());
+}
+
+TEST_CASE("input_view borrows container elements", "")
+{
+  std::vector<int> data{1, 2, 3, 4};
+  falaise::input_view<int> v{data};
+  REQUIRE(v.size() == data.size());
+  REQUIRE(v.begin() == data.data());
+  REQUIRE(v[2] == 3);
+
+  int sum{0};
+  for (int x : v) {
+    sum += x;
+  }
+  REQUIRE(sum == 10);
+}
+
+TEST_CASE("Step hit views do not copy or allocate", "")
+{
+  auto sd = makeSimulatedData(500);
+
+  SECTION("missing categories give an empty view")
+  {
+    REQUIRE(falaise::view_step_hits(sd, "calo").empty());
+  }
+
+  SECTION("view refers to the event's handles")
+  {
+    auto v = falaise::view_step_hits(sd, "gg");
+    REQUIRE(v.size() == 500);
+    REQUIRE(&v[0] == &(sd.get_step_hits("gg")[0]));
+    REQUIRE(v[499].get().get_hit_id() == 499);
+  }
+
+  SECTION("allocations per event, copy vs view")
+  {
+    // Check sizes outside the counted regions as Catch may allocate
+    std::size_t copySize{0};
+    std::size_t start = allocationCount;
+    {
+      mctools::simulated_data::hit_handle_collection_type copy =
+        sd.get_step_hits_dict().at("gg");
+      copySize = copy.size();
+    }
+    std::size_t copyAllocations = allocationCount - start;
+
+    std::size_t viewSize{0};
+    start = allocationCount;
+    {
+      falaise::step_hit_view view = falaise::view_step_hits(sd, "gg");
+      viewSize = view.size();
+    }
+    std::size_t viewAllocations = allocationCount - start;
+
+    REQUIRE(copySize == 500);
+    REQUIRE(viewSize == 500);
+
+    WARN("allocations per event: copy = " << copyAllocations
+                                          << ", view = " << viewAllocations);
+    REQUIRE(copyAllocations > 0);
+    REQUIRE(viewAllocations == 0);
+  }
+}
@@ -0,0 +1,104 @@
+#include "catch.hpp"
+
+#include "kway_merge.h"
+
+#include <algorithm>
+#include <memory>
+#include <random>
+#include <vector>
+
+// - Fixtures and helpers
+using Merge = falaise::kway_merge<std::uint64_t>;
+
+//! Return a source of the values of v, in order
+Merge::source_type
+sourceOf(std::vector<std::uint64_t> v, std::size_t* pulled = nullptr)
+{
+  std::size_t i{0};
+  return [v, i, pulled]() mutable -> Merge::item_ptr {
+    if (i == v.size()) {
+      return nullptr;
+    }
+    if (pulled) {
+      ++*pulled;
+    }
+    return Merge::item_ptr{new std::uint64_t{v[i++]}};
+  };
+}
+
+std::uint64_t
+identity(std::uint64_t const& x)
+{
+  return x;
+}
+
+//! Return all items of merge, in the order returned
+std::vector<std::uint64_t>
+drain(Merge& merge)
+{
+  std::vector<std::uint64_t> result;
+  while (auto item = merge.next()) {
+    result.push_back(*item);
+  }
+  return result;
+}
+
+TEST_CASE("Sources are merged in key order", "")
+{
+  Merge merge{{sourceOf({0, 3, 6, 9}),
+               sourceOf({}),
+               sourceOf({1, 2, 10}),
+               sourceOf({4, 5, 7, 8, 11})},
+              identity};
+  REQUIRE(merge.active() == 3);
+  REQUIRE(drain(merge) ==
+          std::vector<std::uint64_t>{0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11});
+  REQUIRE(merge.active() == 0);
+  REQUIRE(merge.next() == nullptr);
+
+  Merge none{{}, identity};
+  REQUIRE(none.next() == nullptr);
+}
+
+TEST_CASE("Merging events dealt out in blocks restores their order", "")
+{
+  // As events dealt to workers in blocks, some dropped by a filter
+  std::mt19937 rng{12345};
+  std::bernoulli_distribution kept{0.8};
+  for (std::size_t workers : {1, 2, 3, 8}) {
+    for (std::size_t block : {1, 7, 100}) {
+      std::vector<std::vector<std::uint64_t>> shards(workers);
+      std::vector<std::uint64_t> expected;
+      for (std::uint64_t e = 0; e < 1000; ++e) {
+        if (kept(rng)) {
+          shards[e / block % workers].push_back(e);
+          expected.push_back(e);
+        }
+      }
+      std::vector<std::size_t> pulled(workers, 0);
+      std::vector<Merge::source_type> sources;
+      for (std::size_t w = 0; w < workers; ++w) {
+        sources.push_back(sourceOf(shards[w], &pulled[w]));
+      }
+      Merge merge{std::move(sources), identity};
+
+      // Only one item ahead of the merge is read from each source
+      std::vector<std::uint64_t> merged;
+      while (auto item = merge.next()) {
+        merged.push_back(*item);
+        for (std::size_t w = 0; w < workers; ++w) {
+          auto const upTo = std::upper_bound(
+            shards[w].begin(), shards[w].end(), merged.back());
+          REQUIRE(pulled[w] <= (upTo - shards[w].begin()) + 1u);
+        }
+      }
+      REQUIRE(merged == expected);
+    }
+  }
+}
+
+TEST_CASE("Sources out of key order are rejected", "")
+{
+  Merge merge{{sourceOf({1, 0}), sourceOf({2})}, identity};
+  REQUIRE_THROWS_AS(drain(merge), falaise::bad_merge_order_error);
+}
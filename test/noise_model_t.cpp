@@ -0,0 +1,100 @@
+#include "catch.hpp"
+
+#include "noise_model.h"
+
+#include <cmath>
+#include <sstream>
+#include <vector>
+
+// - Fixtures and helpers
+// Cells [1204:0.side.layer.row] of a reduced tracker, rows along y
+falaise::tracker_cell_table
+makeCells(std::uint32_t nLayers, std::uint32_t nRows)
+{
+  std::vector<falaise::tracker_cell_table::entry> cells;
+  for (std::uint32_t side = 0; side < 2; ++side) {
+    for (std::uint32_t layer = 0; layer < nLayers; ++layer) {
+      for (std::uint32_t row = 0; row < nRows; ++row) {
+        double x = (side == 0 ? -1.0 : 1.0) * (30.0 + 44.0 * layer);
+        double y = 44.0 * row;
+        auto key = falaise::pack_geom_id({1204, 0, side, layer, row});
+        cells.push_back({key, {x, y, -1450.0, 1450.0, 2900.0}});
+      }
+    }
+  }
+  return falaise::tracker_cell_table{cells};
+}
+
+TEST_CASE("Noise cells are picked in proportion to their rates", "")
+{
+  std::vector<double> rates{1.0, 0.0, 3.0, 0.5, 0.5, 0.0, 2.0, 1.0};
+  falaise::noise_model noise{rates, 1.0};
+  REQUIRE(noise.size() == rates.size());
+  REQUIRE(noise.mean_hits() == Approx(8.0));
+
+  // Uniform deviates on a fine grid give the exact fractions
+  std::size_t const n{800000};
+  std::vector<std::size_t> picked(rates.size(), 0);
+  for (std::size_t i = 0; i < n; ++i) {
+    ++picked[noise.cell((i + 0.5) / n)];
+  }
+  for (std::size_t c = 0; c < rates.size(); ++c) {
+    REQUIRE(picked[c] / double(n) == Approx(rates[c] / 8.0).margin(1e-5));
+  }
+}
+
+TEST_CASE("Noise hit counts are Poisson", "")
+{
+  auto rng = falaise::make_random_stream("philox4x32");
+  for (double mean : {0.05, 2.0, 150.0}) {
+    falaise::noise_model noise{std::vector<double>(10, mean / 10), 1.0};
+    rng->reseed(1, 2, 3);
+    std::size_t const n{20000};
+    double sum{0.0};
+    double sum2{0.0};
+    for (std::size_t i = 0; i < n; ++i) {
+      double k = noise.count(*rng);
+      sum += k;
+      sum2 += k * k;
+    }
+    double const m = sum / n;
+    double const variance = sum2 / n - m * m;
+    // Mean within 5 standard errors, and variance equal to the mean
+    REQUIRE(std::abs(m - mean) < 5 * std::sqrt(mean / n));
+    REQUIRE(variance == Approx(mean).epsilon(0.05));
+  }
+
+  falaise::noise_model none{std::vector<double>(10, 0.0), 1.0};
+  REQUIRE(none.mean_hits() == 0.0);
+  REQUIRE(none.count(*rng) == 0);
+  REQUIRE_THROWS_AS(falaise::noise_model(std::vector<double>{1.0, -1.0}, 1.0),
+                    falaise::bad_noise_model_error);
+}
+
+TEST_CASE("Noise rates are read from text", "")
+{
+  auto cells = makeCells(9, 113);
+  std::istringstream text{"# geom_id rate\n"
+                          "\n"
+                          "[1204:0.1.2.3]  250 # noisy\n"
+                          "[1204:0.0.0.0]  0\n"};
+  auto rates = falaise::read_noise_rates(text, cells, 10.0);
+  REQUIRE(rates.size() == cells.size());
+  auto rate = [&](std::uint32_t side, std::uint32_t layer, std::uint32_t row) {
+    auto key = falaise::pack_geom_id({1204, 0, side, layer, row});
+    return rates[cells.index(key)];
+  };
+  REQUIRE(rate(1, 2, 3) == 250.0);
+  REQUIRE(rate(0, 0, 0) == 0.0);
+  REQUIRE(rate(0, 0, 1) == 10.0);
+
+  for (std::string bad : {"1204:0.1.2.3 1",
+                          "[1204:0.1.2.3]",
+                          "[1204:0.1.2.3] -1",
+                          "[1204:0.1.2.3] 1 2",
+                          "[1204:0.1.9.3] 1"}) {
+    std::istringstream in{bad};
+    REQUIRE_THROWS_AS(falaise::read_noise_rates(in, cells, 0.0),
+                      falaise::bad_noise_model_error);
+  }
+}
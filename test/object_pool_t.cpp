@@ -0,0 +1,99 @@
+#include "catch.hpp"
+
+#include "object_pool.h"
+
+#include <atomic>
+#include <set>
+#include <thread>
+#include <vector>
+
+TEST_CASE("object_pool creates and reuses objects", "")
+{
+  int created{0};
+  falaise::object_pool<std::vector<int>> pool{[&created] {
+    ++created;
+    return std::unique_ptr<std::vector<int>>{new std::vector<int>};
+  }};
+  REQUIRE(pool.idle() == 0);
+
+  std::vector<int>* first{nullptr};
+  {
+    auto h = pool.acquire();
+    first = h.get();
+    h->reserve(100);
+    REQUIRE(created == 1);
+  }
+  REQUIRE(pool.idle() == 1);
+
+  SECTION("released objects keep their state")
+  {
+    auto h = pool.acquire();
+    REQUIRE(h.get() == first);
+    REQUIRE(h->capacity() >= 100);
+    REQUIRE(created == 1);
+  }
+
+  SECTION("concurrent users get distinct objects")
+  {
+    auto a = pool.acquire();
+    auto b = pool.acquire();
+    REQUIRE(a.get() != b.get());
+    REQUIRE(created == 2);
+  }
+
+  SECTION("clear destroys idle objects")
+  {
+    pool.clear();
+    REQUIRE(pool.idle() == 0);
+  }
+}
+
+TEST_CASE("object_pool is safe to use from many threads", "")
+{
+  falaise::object_pool<std::vector<int>> pool;
+  std::atomic<int> failures{0};
+
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 8; ++t) {
+    threads.emplace_back([&pool, &failures, t] {
+      for (int i = 0; i < 1000; ++i) {
+        auto h = pool.acquire();
+        // Nobody else may touch the object while we hold it
+        h->assign(10, t);
+        for (int x : *h) {
+          if (x != t) {
+            ++failures;
+          }
+        }
+      }
+    });
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+  REQUIRE(failures == 0);
+  REQUIRE(pool.idle() <= 8);
+}
+
+TEST_CASE("object_pool hands threads back their own objects", "")
+{
+  falaise::object_pool<int> pool;
+  auto x = pool.acquire();
+  auto y = pool.acquire();
+  int* mine = x.get();
+  int* theirs = y.get();
+
+  // Release theirs last, from another thread, so it is the newest idle
+  x.reset();
+  std::thread other{[&y] { y.reset(); }};
+  other.join();
+  REQUIRE(pool.idle() == 2);
+
+  auto h = pool.acquire();
+  REQUIRE(h.get() == mine);
+
+  // Objects last used by other threads are taken when none of ours are idle
+  auto g = pool.acquire();
+  REQUIRE(g.get() == theirs);
+  REQUIRE(pool.idle() == 0);
+}
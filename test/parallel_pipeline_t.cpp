@@ -0,0 +1,211 @@
+#include "catch.hpp"
+
+#include "parallel_pipeline.h"
+
+#include <algorithm>
+#include <memory>
+#include <numeric>
+#include <stdexcept>
+#include <vector>
+
+#include "bayeux/datatools/library_loader.h"
+#include "bayeux/datatools/multi_properties.h"
+#include "bayeux/datatools/things.h"
+#include "falaise/falaise.h"
+#include "falaise/snemo/datamodels/calibrated_data.h"
+#include "falaise/snemo/datamodels/event_header.h"
+
+#include "synthetic_events.h"
+
+// - Fixtures and helpers
+//! Services for the pipelines, with geometry for the calibrator
+struct PipelineFixture {
+  PipelineFixture()
+  {
+    FALAISE_INIT();
+    REQUIRE(loader.load("MockTrackerCalibrator", MOCKTRACKERCALIBRATOR_DIR) ==
+            0);
+    REQUIRE(loader.load("PipelineProbe", PIPELINEPROBE_DIR) == 0);
+    geometry.reset(new falaise::demonstrator_geometry);
+  }
+
+  datatools::library_loader loader;
+  std::unique_ptr<falaise::demonstrator_geometry> geometry;
+};
+
+PipelineFixture&
+fixture()
+{
+  static PipelineFixture f;
+  return f;
+}
+
+//! Return configuration of a pipeline made of one PipelineProbe
+/*
+ * See PipelineProbe.cpp for its configuration
+ */
+datatools::multi_properties
+probeConfig(datatools::properties const& probe)
+{
+  datatools::multi_properties config{"name", "type"};
+  config.add("pipeline", "PipelineProbe", probe);
+  return config;
+}
+
+//! Create event with nHits Geiger step hits from a step_hit_generator
+falaise::parallel_pipeline::event_ptr
+makeEvent(int eventNumber, std::size_t nHits)
+{
+  falaise::step_hit_generator::parameters p;
+  p.hits = nHits;
+  falaise::step_hit_generator generator{fixture().geometry->cells, p};
+  return falaise::make_synthetic_event(generator, eventNumber);
+}
+
+//! Return a source of nEvents events with nHits hits each
+falaise::parallel_pipeline::source_type
+makeSource(int nEvents, std::size_t nHits = 0)
+{
+  auto next = std::make_shared<int>(0);
+  return [next, nEvents, nHits]() -> falaise::parallel_pipeline::event_ptr {
+    if (*next == nEvents) {
+      return nullptr;
+    }
+    return makeEvent((*next)++, nHits);
+  };
+}
+
+int
+eventNumber(datatools::things const& event)
+{
+  return event.get<snemo::datamodel::event_header>("EH")
+    .get_id()
+    .get_event_number();
+}
+
+std::vector<int>
+range(int n)
+{
+  std::vector<int> result(n);
+  std::iota(result.begin(), result.end(), 0);
+  return result;
+}
+
+TEST_CASE("Ordered pipelines write events in source order", "")
+{
+  falaise::parallel_pipeline::options opts;
+  opts.workers = 4;
+  falaise::parallel_pipeline pipeline{
+    probeConfig({}), fixture().geometry->services, opts};
+  REQUIRE(pipeline.workers() == 4);
+
+  std::vector<int> written;
+  auto stats = pipeline.run(makeSource(200), [&](datatools::things& e) {
+    written.push_back(eventNumber(e));
+  });
+  REQUIRE(stats.read == 200);
+  REQUIRE(stats.written == 200);
+  REQUIRE(written == range(200));
+}
+
+TEST_CASE("Unordered pipelines write every event", "")
+{
+  falaise::parallel_pipeline::options opts;
+  opts.workers = 4;
+  opts.ordered = false;
+  falaise::parallel_pipeline pipeline{
+    probeConfig({}), fixture().geometry->services, opts};
+
+  std::vector<int> written;
+  auto stats = pipeline.run(makeSource(200), [&](datatools::things& e) {
+    written.push_back(eventNumber(e));
+  });
+  REQUIRE(stats.written == 200);
+  std::sort(written.begin(), written.end());
+  REQUIRE(written == range(200));
+}
+
+TEST_CASE("Rejected and failed events are counted, not written", "")
+{
+  datatools::properties probe;
+  probe.store("stop_every", 3);
+  probe.store("error_every", 5);
+  falaise::parallel_pipeline::options opts;
+  opts.workers = 3;
+  falaise::parallel_pipeline pipeline{
+    probeConfig(probe), fixture().geometry->services, opts};
+
+  std::vector<int> written;
+  auto stats = pipeline.run(makeSource(150), [&](datatools::things& e) {
+    written.push_back(eventNumber(e));
+  });
+  REQUIRE(stats.read == 150);
+  REQUIRE(stats.stopped == 50);
+  REQUIRE(stats.errors == 20);
+  REQUIRE(stats.written == 80);
+  for (int n : written) {
+    REQUIRE(n % 3 != 0);
+    REQUIRE(n % 5 != 0);
+  }
+}
+
+TEST_CASE("Failures stop the run and are rethrown", "")
+{
+  falaise::parallel_pipeline::options opts;
+  opts.workers = 4;
+
+  SECTION("fatal module status")
+  {
+    datatools::properties probe;
+    probe.store("fatal_event", 37);
+    falaise::parallel_pipeline pipeline{
+      probeConfig(probe), fixture().geometry->services, opts};
+    REQUIRE_THROWS_AS(
+      pipeline.run(makeSource(1000), [](datatools::things&) {}),
+      falaise::pipeline_fatal_error);
+  }
+
+  SECTION("sink exception")
+  {
+    falaise::parallel_pipeline pipeline{
+      probeConfig({}), fixture().geometry->services, opts};
+    REQUIRE_THROWS_AS(pipeline.run(makeSource(1000),
+                                   [](datatools::things& e) {
+                                     if (eventNumber(e) == 37) {
+                                       throw std::runtime_error("sink");
+                                     }
+                                   }),
+                      std::runtime_error);
+  }
+}
+
+TEST_CASE("Calibration does not depend on the number of workers", "")
+{
+  datatools::multi_properties config{"name", "type"};
+  datatools::properties chain;
+  chain.store("modules", std::vector<std::string>{"calibrator"});
+  config.add("pipeline", "dpp::chain_module", chain);
+  config.add("calibrator", "MockTrackerCalibrator", datatools::properties{});
+
+  auto calibrate = [&config](std::size_t nWorkers) {
+    falaise::parallel_pipeline::options opts;
+    opts.workers = nWorkers;
+    falaise::parallel_pipeline pipeline{
+      config, fixture().geometry->services, opts};
+
+    std::vector<std::vector<double>> anodeTimes;
+    pipeline.run(makeSource(100, 200), [&](datatools::things& e) {
+      std::vector<double> times;
+      auto const& cd = e.get<snemo::datamodel::calibrated_data>("CD");
+      for (auto const& hdl : cd.calibrated_tracker_hits()) {
+        times.push_back(hdl.get().get_anode_time());
+      }
+      anodeTimes.push_back(times);
+    });
+    return anodeTimes;
+  };
+
+  auto serial = calibrate(1);
+  REQUIRE(serial.size() == 100);
+  REQUIRE(calibrate(8) == serial);
+}
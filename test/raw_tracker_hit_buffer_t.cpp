@@ -0,0 +1,70 @@
+#include "catch.hpp"
+
+#include "raw_tracker_hit_buffer.h"
+
+#include "falaise/snemo/datamodels/mock_raw_tracker_hit.h"
+
+#include <list>
+
+using buffer_t = falaise::raw_tracker_hit_buffer;
+
+TEST_CASE("raw_tracker_hit_buffer default construction works", "")
+{
+  buffer_t b;
+  REQUIRE(b.empty());
+  REQUIRE(b.size() == 0);
+  REQUIRE(b.begin() == b.end());
+}
+
+TEST_CASE("raw_tracker_hit_buffer push/update/iterate work", "")
+{
+  buffer_t b;
+  REQUIRE(b.push_back(10, 1.0, 2.0, 3.0, buffer_t::bottom_cathode) == 0);
+  REQUIRE(b.push_back(20, 4.0, 5.0, 6.0, buffer_t::top_cathode) == 1);
+  REQUIRE(b.size() == 2);
+
+  auto h = b[0];
+  REQUIRE(h.gid == 10);
+  REQUIRE(h.anode_time == 1.0);
+  REQUIRE(h.has_bottom_cathode_time());
+  REQUIRE(!h.has_top_cathode_time());
+
+  SECTION("update replaces times and flags in place")
+  {
+    std::uint8_t both = buffer_t::bottom_cathode | buffer_t::top_cathode;
+    b.update(1, 0.5, 0.6, 0.7, both);
+    REQUIRE(b.size() == 2);
+    REQUIRE(b[1].gid == 20);
+    REQUIRE(b[1].anode_time == 0.5);
+    REQUIRE(b.top_cathode_times()[1] == 0.7);
+    REQUIRE(b[1].has_bottom_cathode_time());
+    REQUIRE(b[1].has_top_cathode_time());
+  }
+
+  SECTION("iteration visits rows in insertion order")
+  {
+    std::vector<std::uint64_t> gids;
+    for (auto hit : b) {
+      gids.push_back(hit.gid);
+    }
+    REQUIRE(gids == std::vector<std::uint64_t>{10, 20});
+  }
+
+  SECTION("clear keeps storage for reuse")
+  {
+    auto capacity = b.capacity();
+    b.clear();
+    REQUIRE(b.empty());
+    REQUIRE(b.capacity() == capacity);
+  }
+}
+
+TEST_CASE("raw_tracker_hit_buffer is smaller than a list of hits", "")
+{
+  // Each std::list node holds the hit plus two links
+  std::size_t listBytesPerHit =
+    sizeof(snemo::datamodel::mock_raw_tracker_hit) + 2 * sizeof(void*);
+  WARN("bytes per hit: list = " << listBytesPerHit
+                                << ", buffer = " << buffer_t::bytes_per_hit());
+  REQUIRE(buffer_t::bytes_per_hit() < listBytesPerHit);
+}
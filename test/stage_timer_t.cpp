@@ -0,0 +1,89 @@
+#include "catch.hpp"
+
+#include "stage_timer.h"
+
+#include <algorithm>
+#include <random>
+#include <sstream>
+#include <thread>
+
+TEST_CASE("duration_histogram counts short durations exactly", "")
+{
+  falaise::duration_histogram h;
+  REQUIRE(h.count() == 0);
+  REQUIRE(h.mean() == 0.0);
+  REQUIRE(h.quantile(0.5) == 0);
+
+  for (std::uint64_t ns = 1; ns <= 10; ++ns) {
+    h.record(ns);
+  }
+  REQUIRE(h.count() == 10);
+  REQUIRE(h.mean() == Approx(5.5));
+  REQUIRE(h.max() == 10);
+  REQUIRE(h.quantile(0.0) == 1);
+  REQUIRE(h.quantile(0.5) == 5);
+  REQUIRE(h.quantile(0.99) == 10);
+  REQUIRE(h.quantile(1.0) == 10);
+
+  h.clear();
+  REQUIRE(h.count() == 0);
+  REQUIRE(h.max() == 0);
+}
+
+TEST_CASE("duration_histogram quantiles are within 1/16", "")
+{
+  std::mt19937_64 rng{12345};
+  std::lognormal_distribution<double> duration{10.0, 2.0};
+  std::vector<std::uint64_t> values(100000);
+  falaise::duration_histogram a;
+  falaise::duration_histogram b;
+  for (std::size_t i = 0; i < values.size(); ++i) {
+    values[i] = static_cast<std::uint64_t>(duration(rng));
+    (i % 2 ? a : b).record(values[i]);
+  }
+  a.merge(b);
+  REQUIRE(a.count() == values.size());
+  std::sort(values.begin(), values.end());
+  REQUIRE(a.max() == values.back());
+
+  for (double q : {0.01, 0.5, 0.9, 0.99, 0.999}) {
+    auto exact = values[static_cast<std::size_t>(q * values.size()) - 1];
+    auto estimate = a.quantile(q);
+    REQUIRE(estimate >= exact);
+    REQUIRE(estimate <= exact + exact / 16);
+  }
+}
+
+TEST_CASE("stage_timer records laps into its timings if any", "")
+{
+  falaise::stage_timings timings{{"sleep", "nothing"}};
+  REQUIRE(timings.size() == 2);
+  REQUIRE(timings.name(1) == "nothing");
+  {
+    falaise::stage_timer timer{&timings};
+    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    timer.lap(0);
+    timer.lap(1);
+  }
+  {
+    falaise::stage_timer timer{nullptr};
+    timer.lap(0);
+  }
+  REQUIRE(timings[0].count() == 1);
+  REQUIRE(timings[0].max() * falaise::tick_clock::ns_per_tick() >=
+          Approx(2e6).epsilon(0.01));
+  REQUIRE(timings[1].count() == 1);
+  REQUIRE(timings[1].max() < timings[0].max());
+
+  falaise::stage_timings total{{"sleep", "nothing"}};
+  total.merge(timings);
+  total.merge(timings);
+  REQUIRE(total[0].count() == 2);
+  REQUIRE_THROWS_AS(total.merge(falaise::stage_timings{{"other"}}),
+                    std::logic_error);
+
+  std::ostringstream report;
+  total.report(report);
+  REQUIRE(report.str().find("sleep") != std::string::npos);
+  REQUIRE(report.str().find("p99") != std::string::npos);
+}
@@ -0,0 +1,121 @@
+#include "catch.hpp"
+
+#include "step_hit_generator.h"
+
+#include <algorithm>
+#include <set>
+#include <vector>
+
+#include "bayeux/mctools/simulated_data.h"
+
+// - Fixtures and helpers
+// Cells [1204:0.side.layer.row] of a reduced tracker, rows along y
+falaise::tracker_cell_table
+makeCells(std::uint32_t nLayers, std::uint32_t nRows)
+{
+  std::vector<falaise::tracker_cell_table::entry> cells;
+  for (std::uint32_t side = 0; side < 2; ++side) {
+    for (std::uint32_t layer = 0; layer < nLayers; ++layer) {
+      for (std::uint32_t row = 0; row < nRows; ++row) {
+        double x = (side == 0 ? -1.0 : 1.0) * (30.0 + 44.0 * layer);
+        double y = 44.0 * row;
+        auto key = falaise::pack_geom_id({1204, 0, side, layer, row});
+        cells.push_back({key, {x, y, -1450.0, 1450.0, 2900.0}});
+      }
+    }
+  }
+  return falaise::tracker_cell_table{cells};
+}
+
+// Packed geom_ids of the hits of sd
+std::vector<std::uint64_t>
+hitCells(mctools::simulated_data const& sd)
+{
+  std::vector<std::uint64_t> gids;
+  for (auto const& hit : sd.get_step_hits("gg")) {
+    gids.push_back(falaise::pack_geom_id(hit.get().get_geom_id()));
+  }
+  return gids;
+}
+
+TEST_CASE("Generated events depend only on seed and event number", "")
+{
+  auto cells = makeCells(9, 113);
+  falaise::step_hit_generator::parameters p;
+  p.hits = 50;
+  falaise::step_hit_generator a{cells, p};
+  falaise::step_hit_generator b{cells, p};
+
+  mctools::simulated_data sa;
+  mctools::simulated_data sb;
+  a.generate(7, sa);
+  b.generate(3, sb);
+  b.generate(7, sb);
+  REQUIRE(sb.get_number_of_step_hits("gg") == 50);
+  REQUIRE(hitCells(sa) == hitCells(sb));
+  for (std::size_t i = 0; i < 50; ++i) {
+    auto const& ha = sa.get_step_hits("gg")[i].get();
+    auto const& hb = sb.get_step_hits("gg")[i].get();
+    REQUIRE(ha.get_position_start().x() == hb.get_position_start().x());
+    REQUIRE(ha.get_position_start().z() == hb.get_position_start().z());
+    REQUIRE(ha.get_time_start() == hb.get_time_start());
+  }
+
+  b.generate(8, sb);
+  REQUIRE(hitCells(sa) != hitCells(sb));
+  p.seed = 54321;
+  falaise::step_hit_generator c{cells, p};
+  c.generate(7, sb);
+  REQUIRE(hitCells(sa) != hitCells(sb));
+}
+
+TEST_CASE("Generated hits are in their cells", "")
+{
+  auto cells = makeCells(9, 113);
+  for (auto pattern : {falaise::step_hit_generator::occupancy::uniform,
+                       falaise::step_hit_generator::occupancy::tracks}) {
+    falaise::step_hit_generator::parameters p;
+    p.hits = 40;
+    p.pattern = pattern;
+    p.multi_hit_fraction = 0.25;
+    falaise::step_hit_generator generator{cells, p};
+    mctools::simulated_data sd;
+    for (std::int32_t e = 0; e < 100; ++e) {
+      generator.generate(e, sd);
+      auto gids = hitCells(sd);
+      REQUIRE(gids.size() == 40);
+      REQUIRE(std::set<std::uint64_t>(gids.begin(), gids.end()).size() == 30);
+
+      for (auto const& h : sd.get_step_hits("gg")) {
+        auto const& hit = h.get();
+        auto index = cells.index(falaise::pack_geom_id(hit.get_geom_id()));
+        REQUIRE(index != falaise::tracker_cell_table::invalid_index);
+        auto const& cell = cells[index];
+        auto const& position = hit.get_position_start();
+        REQUIRE(std::abs(position.x() - cell.anode_x) <= p.max_offset);
+        REQUIRE(std::abs(position.y() - cell.anode_y) <= p.max_offset);
+        REQUIRE(position.z() >= cell.z_min);
+        REQUIRE(position.z() <= cell.z_max);
+      }
+    }
+  }
+}
+
+TEST_CASE("Tracks cross consecutive layers of one side", "")
+{
+  auto cells = makeCells(9, 113);
+  falaise::step_hit_generator::parameters p;
+  p.hits = 1;
+  p.pattern = falaise::step_hit_generator::occupancy::tracks;
+  falaise::step_hit_generator generator{cells, p};
+
+  // A single hit is the start of a track, so in the first layer
+  mctools::simulated_data sd;
+  for (std::int32_t e = 0; e < 100; ++e) {
+    generator.generate(e, sd);
+    REQUIRE(falaise::packed_address(hitCells(sd)[0], 2) == 0);
+  }
+  REQUIRE_THROWS_AS(
+    falaise::step_hit_generator(falaise::tracker_cell_table{}, p),
+    std::logic_error);
+}
@@ -0,0 +1,101 @@
+#include "catch.hpp"
+
+#include "tracker_cell_table.h"
+
+// - Fixtures and helpers
+// Cells [1204:0.side.layer.row] of a reduced tracker, rows along y
+std::vector<falaise::tracker_cell_table::entry>
+makeCells(std::uint32_t nLayers, std::uint32_t nRows)
+{
+  std::vector<falaise::tracker_cell_table::entry> cells;
+  for (std::uint32_t side = 0; side < 2; ++side) {
+    for (std::uint32_t layer = 0; layer < nLayers; ++layer) {
+      for (std::uint32_t row = 0; row < nRows; ++row) {
+        double x = (side == 0 ? -1.0 : 1.0) * (30.0 + 44.0 * layer);
+        double y = 44.0 * row;
+        auto key = falaise::pack_geom_id({1204, 0, side, layer, row});
+        cells.push_back({key, {x, y, -1450.0, 1450.0, 2900.0}});
+      }
+    }
+  }
+  return cells;
+}
+
+TEST_CASE("tracker_cell_table default construction works", "")
+{
+  falaise::tracker_cell_table t;
+  REQUIRE(t.empty());
+  REQUIRE(t.index(falaise::pack_geom_id({1204, 0, 0, 0, 0})) ==
+          falaise::tracker_cell_table::invalid_index);
+  REQUIRE(t.index(std::uint64_t{0}) ==
+          falaise::tracker_cell_table::invalid_index);
+}
+
+TEST_CASE("tracker_cell_table maps all cells to dense indices", "")
+{
+  auto cells = makeCells(9, 113);
+  falaise::tracker_cell_table t{cells};
+  REQUIRE(t.size() == 2 * 9 * 113);
+  REQUIRE(t.type() == 1204);
+  REQUIRE(t.address_end(1) == 2);
+  REQUIRE(t.address_end(2) == 9);
+  REQUIRE(t.address_end(3) == 113);
+
+  std::vector<bool> seen(t.size(), false);
+  for (auto const& c : cells) {
+    auto i = t.index(c.gid);
+    REQUIRE(i < t.size());
+    REQUIRE(!seen[i]);
+    seen[i] = true;
+    REQUIRE(t.gid(i) == c.gid);
+    REQUIRE(t[i].anode_x == c.geometry.anode_x);
+    REQUIRE(t[i].anode_y == c.geometry.anode_y);
+    REQUIRE(t[i].length == c.geometry.length);
+  }
+
+  SECTION("indices follow side, layer, row ordering")
+  {
+    REQUIRE(t.index(falaise::pack_geom_id({1204, 0, 0, 0, 0})) == 0);
+    REQUIRE(t.index(falaise::pack_geom_id({1204, 0, 0, 0, 1})) == 1);
+    REQUIRE(t.index(falaise::pack_geom_id({1204, 0, 0, 1, 0})) == 113);
+    REQUIRE(t.index(falaise::pack_geom_id({1204, 0, 1, 0, 0})) == 9 * 113);
+    REQUIRE(t.index(geomtools::geom_id{1204, 0, 1, 8, 112}) == t.size() - 1);
+  }
+
+  SECTION("unknown cells give invalid_index")
+  {
+    using falaise::tracker_cell_table;
+    REQUIRE(t.index(falaise::pack_geom_id({1204, 0, 0, 9, 0})) ==
+            tracker_cell_table::invalid_index);
+    REQUIRE(t.index(falaise::pack_geom_id({1204, 0, 2, 0, 0})) ==
+            tracker_cell_table::invalid_index);
+    REQUIRE(t.index(falaise::pack_geom_id({1302, 0, 0, 0, 0})) ==
+            tracker_cell_table::invalid_index);
+    REQUIRE(t.index(geomtools::geom_id{1204, 0, 0}) ==
+            tracker_cell_table::invalid_index);
+  }
+}
+
+TEST_CASE("tracker_cell_table handles holes and rejects bad input", "")
+{
+  auto cells = makeCells(2, 4);
+  cells.erase(cells.begin() + 3);
+  falaise::tracker_cell_table t{cells};
+  REQUIRE(t.size() == cells.size());
+  REQUIRE(t.index(falaise::pack_geom_id({1204, 0, 0, 0, 3})) ==
+          falaise::tracker_cell_table::invalid_index);
+
+  SECTION("duplicate cells throw")
+  {
+    cells.push_back(cells.front());
+    REQUIRE_THROWS_AS(falaise::tracker_cell_table{cells},
+                      falaise::bad_cell_geometry_error);
+  }
+
+  SECTION("mixed cell types throw")
+  {
+    cells.push_back({falaise::pack_geom_id({1302, 0, 0, 0, 0}), {}});
+    REQUIRE_THROWS_AS(falaise::tracker_cell_table{cells},
+                      falaise::bad_cell_geometry_error);
+  }
+}
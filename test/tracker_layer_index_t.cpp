@@ -0,0 +1,103 @@
+#include "catch.hpp"
+
+#include "tracker_layer_index.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "bayeux/datatools/properties.h"
+
+#include "packed_geom_id.h"
+
+// - Fixtures and helpers
+std::uint64_t
+cellKey(std::uint32_t side, std::uint32_t layer, std::uint32_t row)
+{
+  return falaise::pack_geom_id({1204, 0, side, layer, row});
+}
+
+//! Sorted keys of hits in a tracker of 2 sides of 9 layers
+std::vector<std::uint64_t>
+makeHits()
+{
+  std::vector<std::uint64_t> gids = {cellKey(1, 8, 112),
+                                     cellKey(0, 0, 3),
+                                     cellKey(0, 0, 7),
+                                     cellKey(0, 2, 0),
+                                     cellKey(1, 0, 50),
+                                     cellKey(0, 0, 5),
+                                     cellKey(1, 8, 0)};
+  std::sort(gids.begin(), gids.end());
+  return gids;
+}
+
+TEST_CASE("Layer index finds layers and cells of sorted hits", "")
+{
+  auto gids = makeHits();
+  falaise::tracker_layer_index index{gids.data(), gids.size(), 2, 9};
+  REQUIRE(index.sides() == 2);
+  REQUIRE(index.layers() == 9);
+  REQUIRE(index.size() == gids.size());
+  REQUIRE(index.offsets().size() == 19);
+
+  using range = std::pair<std::size_t, std::size_t>;
+  REQUIRE(index.layer(0, 0) == range{0, 3});
+  REQUIRE(index.layer(0, 1) == range{3, 3});
+  REQUIRE(index.layer(0, 2) == range{3, 4});
+  REQUIRE(index.layer(1, 0) == range{4, 5});
+  REQUIRE(index.layer(1, 8) == range{5, 7});
+
+  auto rowOf = [&gids](std::size_t i) {
+    return falaise::packed_address(gids[i], 3);
+  };
+  for (std::size_t i = 0; i < gids.size(); ++i) {
+    auto side = falaise::packed_address(gids[i], 1);
+    auto layer = falaise::packed_address(gids[i], 2);
+    REQUIRE(index.find(side, layer, rowOf(i), rowOf) == i);
+  }
+  REQUIRE(index.find(0, 0, 4, rowOf) == index.size());
+  REQUIRE(index.find(0, 0, 8, rowOf) == index.size());
+  REQUIRE(index.find(0, 1, 3, rowOf) == index.size());
+  REQUIRE(index.find(1, 8, 111, rowOf) == index.size());
+
+  falaise::tracker_layer_index empty{nullptr, 0, 2, 9};
+  REQUIRE(empty.size() == 0);
+  REQUIRE(empty.find(0, 0, 0, rowOf) == 0);
+}
+
+TEST_CASE("Layer index rejects hits it cannot index", "")
+{
+  auto gids = makeHits();
+  REQUIRE_THROWS_AS(
+    falaise::tracker_layer_index(gids.data(), gids.size(), 1, 9),
+    falaise::bad_layer_index_error);
+  REQUIRE_THROWS_AS(
+    falaise::tracker_layer_index(gids.data(), gids.size(), 2, 8),
+    falaise::bad_layer_index_error);
+  std::swap(gids[0], gids[1]);
+  REQUIRE_THROWS_AS(
+    falaise::tracker_layer_index(gids.data(), gids.size(), 2, 9),
+    falaise::bad_layer_index_error);
+
+  REQUIRE_THROWS_AS(falaise::tracker_layer_index({0, 1, 2}, 3),
+                    falaise::bad_layer_index_error);
+  REQUIRE_THROWS_AS(falaise::tracker_layer_index({0, 2, 1}, 2),
+                    falaise::bad_layer_index_error);
+  REQUIRE_THROWS_AS(falaise::tracker_layer_index({1, 2, 3}, 2),
+                    falaise::bad_layer_index_error);
+  REQUIRE_NOTHROW(falaise::tracker_layer_index({0, 2, 2, 3, 5}, 2));
+}
+
+TEST_CASE("Layer index is stored in properties", "")
+{
+  auto gids = makeHits();
+  falaise::tracker_layer_index index{gids.data(), gids.size(), 2, 9};
+  datatools::properties properties;
+  REQUIRE_THROWS_AS(falaise::load_tracker_layer_index(properties),
+                    falaise::bad_layer_index_error);
+
+  falaise::store_tracker_layer_index(properties, index);
+  auto loaded = falaise::load_tracker_layer_index(properties);
+  REQUIRE(loaded.layers() == 9);
+  REQUIRE(loaded.offsets() == index.offsets());
+}
@@ -0,0 +1,144 @@
+#include "catch.hpp"
+
+#include "tracker_trigger.h"
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include "packed_geom_id.h"
+
+// - Fixtures and helpers
+std::uint64_t
+cellKey(std::uint32_t side, std::uint32_t layer, std::uint32_t row)
+{
+  return falaise::pack_geom_id({1204, 0, side, layer, row});
+}
+
+using condition = falaise::tracker_trigger::condition;
+
+//! Conditions met by gids, from the fired layers of each row of each zone
+std::uint32_t
+naiveTrigger(std::vector<std::uint64_t> const& gids,
+             std::uint32_t sides,
+             std::uint32_t rows,
+             std::uint32_t zoneRows,
+             std::uint32_t zoneStride,
+             std::vector<condition> const& conditions)
+{
+  std::uint32_t met{0};
+  for (std::size_t c = 0; c < conditions.size(); ++c) {
+    std::uint32_t sidesMet{0};
+    for (std::uint32_t side = 0; side < sides; ++side) {
+      bool any{false};
+      for (std::uint32_t start = 0;; start += zoneStride) {
+        std::uint32_t const first = std::min(start, rows - zoneRows);
+        std::vector<bool> layers(16, false);
+        for (auto g : gids) {
+          auto const row = falaise::packed_address(g, 3);
+          if (falaise::packed_address(g, 1) == side && row >= first &&
+              row < first + zoneRows) {
+            layers[falaise::packed_address(g, 2)] = true;
+          }
+        }
+        auto const count = std::count(layers.begin(), layers.end(), true);
+        bool required{true};
+        for (std::uint32_t l = 0; l < 16; ++l) {
+          if ((conditions[c].required_layers >> l & 1) && !layers[l]) {
+            required = false;
+          }
+        }
+        any = any || (count >= conditions[c].min_layers && required);
+        if (first + zoneRows >= rows) {
+          break;
+        }
+      }
+      sidesMet += any;
+    }
+    if (sidesMet >= conditions[c].sides) {
+      met |= 1u << c;
+    }
+  }
+  return met;
+}
+
+TEST_CASE("Conditions are met by fired layers in a zone", "")
+{
+  std::vector<condition> conditions = {{3, 0, 1}, {0, 0x101, 1}, {2, 0, 2}};
+  falaise::tracker_trigger trigger{2, 9, 113, 16, 8, conditions};
+  REQUIRE(trigger.zones() == 14);
+
+  // Three layers within a zone, on one side
+  std::vector<std::uint64_t> gids = {
+    cellKey(0, 0, 10), cellKey(0, 3, 20), cellKey(0, 5, 23)};
+  REQUIRE(trigger.evaluate(gids.data(), gids.size()) == 0x1);
+
+  // ... but not when further apart than any zone
+  gids[2] = cellKey(0, 5, 24);
+  REQUIRE(trigger.evaluate(gids.data(), gids.size()) == 0x0);
+
+  // The first and last layers in the last zone, which ends at the last row
+  gids = {cellKey(1, 0, 97), cellKey(1, 8, 112)};
+  REQUIRE(trigger.evaluate(gids.data(), gids.size()) == 0x2);
+
+  // Two layers on each side
+  gids = {cellKey(0, 1, 50),
+          cellKey(0, 2, 51),
+          cellKey(1, 6, 0),
+          cellKey(1, 7, 1),
+          cellKey(1, 7, 2)};
+  REQUIRE(trigger.evaluate(gids.data(), gids.size()) == 0x4);
+
+  // No state is kept between events, and other cells are ignored
+  REQUIRE(trigger.evaluate(nullptr, 0) == 0x0);
+  gids = {cellKey(2, 0, 0), cellKey(0, 9, 0), cellKey(0, 0, 113)};
+  REQUIRE(trigger.evaluate(gids.data(), gids.size()) == 0x0);
+}
+
+TEST_CASE("Conditions match a trigger over all zones", "")
+{
+  std::vector<condition> conditions = {
+    {4, 0, 1}, {6, 0, 1}, {3, 0, 2}, {0, 0x1f, 1}, {2, 0x100, 2}};
+  std::mt19937 rng{12345};
+  std::uniform_int_distribution<std::uint32_t> side{0, 1};
+  std::uniform_int_distribution<std::uint32_t> layer{0, 8};
+  std::uniform_int_distribution<std::uint32_t> row{0, 112};
+
+  for (std::uint32_t stride : {4, 8, 16, 20}) {
+    falaise::tracker_trigger trigger{2, 9, 113, 16, stride, conditions};
+    for (std::size_t n : {1, 5, 10, 20}) {
+      for (int event = 0; event < 20; ++event) {
+        std::vector<std::uint64_t> gids(n);
+        for (auto& g : gids) {
+          g = cellKey(side(rng), layer(rng), row(rng));
+        }
+        REQUIRE(trigger.evaluate(gids.data(), n) ==
+                naiveTrigger(gids, 2, 113, 16, stride, conditions));
+      }
+    }
+  }
+}
+
+TEST_CASE("Unusable triggers are rejected", "")
+{
+  using falaise::bad_trigger_error;
+  using falaise::tracker_trigger;
+  REQUIRE_THROWS_AS(tracker_trigger(2, 17, 113, 16, 8, {}), bad_trigger_error);
+  REQUIRE_THROWS_AS(tracker_trigger(2, 9, 113, 0, 8, {}), bad_trigger_error);
+  REQUIRE_THROWS_AS(tracker_trigger(2, 9, 113, 16, 0, {}), bad_trigger_error);
+  REQUIRE_THROWS_AS(tracker_trigger(2, 9, 113, 16, 8, {{10, 0, 1}}),
+                    bad_trigger_error);
+  REQUIRE_THROWS_AS(tracker_trigger(2, 9, 113, 16, 8, {{0, 0x200, 1}}),
+                    bad_trigger_error);
+  REQUIRE_THROWS_AS(tracker_trigger(2, 9, 113, 16, 8, {{0, 0, 3}}),
+                    bad_trigger_error);
+  REQUIRE_THROWS_AS(
+    tracker_trigger(2, 9, 113, 16, 8, std::vector<condition>(33)),
+    bad_trigger_error);
+
+  // Zones wider than the tracker cover it all
+  tracker_trigger narrow{1, 9, 10, 16, 8, {{2, 0, 1}}};
+  REQUIRE(narrow.zones() == 1);
+  std::vector<std::uint64_t> gids = {cellKey(0, 0, 0), cellKey(0, 1, 9)};
+  REQUIRE(narrow.evaluate(gids.data(), gids.size()) == 0x1);
+}
@@ -0,0 +1,131 @@
+#include "tracker_cell_table.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "bayeux/geomtools/box.h"
+#include "bayeux/geomtools/manager.h"
+
+namespace falaise {
+  constexpr std::uint32_t tracker_cell_table::invalid_index;
+
+  tracker_cell_table::tracker_cell_table(std::vector<entry> cells)
+  {
+    if (cells.empty()) {
+      return;
+    }
+
+    // Order by key, which orders by addresses, so indices follow geom_ids
+    std::sort(cells.begin(), cells.end(), [](entry const& a, entry const& b) {
+      return a.gid < b.gid;
+    });
+
+    type_ = packed_type(cells.front().gid);
+    depth_ = packed_depth(cells.front().gid);
+    std::uint32_t max[4] = {0, 0, 0, 0};
+    for (std::uint32_t i = 0; i < depth_; ++i) {
+      min_[i] = packed_address(cells.front().gid, i);
+      max[i] = min_[i];
+    }
+    for (auto const& c : cells) {
+      if (packed_type(c.gid) != type_ || packed_depth(c.gid) != depth_) {
+        throw bad_cell_geometry_error("cells must have the same type/depth");
+      }
+      for (std::uint32_t i = 0; i < depth_; ++i) {
+        min_[i] = std::min(min_[i], packed_address(c.gid, i));
+        max[i] = std::max(max[i], packed_address(c.gid, i));
+      }
+    }
+
+    std::size_t nSlots{1};
+    for (std::uint32_t i = 0; i < depth_; ++i) {
+      extent_[i] = max[i] - min_[i] + 1;
+      nSlots *= extent_[i];
+    }
+    // Cells should fill most of their address box, refuse pathological ones
+    if (nSlots > 64 * cells.size() + 1024) {
+      throw bad_cell_geometry_error("cell addresses are too sparse to index");
+    }
+
+    slot_index_.assign(nSlots, invalid_index);
+    cells_.reserve(cells.size());
+    gids_.reserve(cells.size());
+    for (auto const& c : cells) {
+      std::size_t slot{0};
+      for (std::uint32_t i = 0; i < depth_; ++i) {
+        slot = slot * extent_[i] + (packed_address(c.gid, i) - min_[i]);
+      }
+      if (slot_index_[slot] != invalid_index) {
+        throw bad_cell_geometry_error("duplicate cell in table");
+      }
+      slot_index_[slot] = cells_.size();
+      cells_.push_back(c.geometry);
+      gids_.push_back(c.gid);
+    }
+  }
+
+  std::uint32_t
+  tracker_cell_table::index(geomtools::geom_id const& gid) const
+  {
+    if (gid.get_type() != type_ || gid.get_depth() != depth_) {
+      return invalid_index;
+    }
+    try {
+      return index(pack_geom_id(gid));
+    }
+    catch (unpackable_geom_id_error const&) {
+      return invalid_index;
+    }
+  }
+
+  tracker_cell_table
+  make_tracker_cell_table(geomtools::manager const& geo,
+                          std::string const& category)
+  {
+    std::uint32_t const type =
+      geo.get_id_mgr().get_category_info(category).get_type();
+
+    std::vector<tracker_cell_table::entry> cells;
+    for (auto const& gi : geo.get_mapping().get_geom_infos()) {
+      if (gi.first.get_type() != type) {
+        continue;
+      }
+
+      auto const& logical = gi.second.get_logical();
+      auto const* shape =
+        dynamic_cast<geomtools::box const*>(&logical.get_shape());
+      if (shape == nullptr) {
+        throw bad_cell_geometry_error("shape of '" + category +
+                                      "' cells is not a box");
+      }
+
+      // Cell frame must be a translation of the world frame
+      geomtools::placement const& p = gi.second.get_world_placement();
+      geomtools::vector_3d const& origin = p.get_translation();
+      geomtools::vector_3d probe{origin.x() + 1.0, origin.y() + 2.0,
+                                 origin.z() + 3.0};
+      geomtools::vector_3d local;
+      p.mother_to_child(probe, local);
+      if (std::abs(local.x() - 1.0) > 1e-6 ||
+          std::abs(local.y() - 2.0) > 1e-6 ||
+          std::abs(local.z() - 3.0) > 1e-6) {
+        throw bad_cell_geometry_error("'" + category +
+                                      "' cells are not parallel to world z");
+      }
+
+      double const length = shape->get_z();
+      cells.push_back({pack_geom_id(gi.first),
+                       {origin.x(),
+                        origin.y(),
+                        origin.z() - 0.5 * length,
+                        origin.z() + 0.5 * length,
+                        length}});
+    }
+
+    if (cells.empty()) {
+      throw bad_cell_geometry_error("no cells found in category '" +
+                                    category + "'");
+    }
+    return tracker_cell_table{std::move(cells)};
+  }
+} /* falaise */
@@ -0,0 +1,155 @@
+#ifndef FALAISE_TRACKER_CELL_TABLE_H
+#define FALAISE_TRACKER_CELL_TABLE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "bayeux/geomtools/geom_id.h"
+
+#include "packed_geom_id.h"
+
+namespace geomtools {
+  class manager;
+}
+
+namespace falaise {
+  //! Exception thrown when geometry cannot be tabulated
+  class bad_cell_geometry_error : public std::logic_error {
+    using std::logic_error::logic_error;
+  };
+
+  //! Dense table of Geiger cell geometry
+  /*
+   * Maps each cell's packed geom_id (see @ref pack_geom_id) to a compact
+   * index in [0, size()), and holds the geometry needed per hit by the
+   * tracker modules in an array indexed by that index.
+   *
+   * The mapping from packed geom_id to index is arithmetic on the cell's
+   * addresses followed by one array lookup, so it costs neither hashing nor
+   * geometry service queries. Indices follow the geom_id ordering of cells,
+   * i.e. for [module.side.layer.row] cells they are sorted by side, then
+   * layer, then row.
+   *
+   * Cells are assumed to be parallel to the world z axis (the anode wire
+   * direction), which is checked when building from geometry.
+   */
+  class tracker_cell_table {
+  public:
+    //! Geometry of a cell, in the world frame
+    struct cell {
+      double anode_x; //< x position of anode wire
+      double anode_y; //< y position of anode wire
+      double z_min;   //< z of bottom end of cell
+      double z_max;   //< z of top end of cell
+      double length;  //< z_max - z_min
+    };
+
+    //! Cell and packed geom_id to build a table from
+    struct entry {
+      std::uint64_t gid;
+      cell geometry;
+    };
+
+    //! Index returned for geom_ids not in the table
+    static constexpr std::uint32_t invalid_index = 0xFFFFFFFF;
+
+    //! Construct an empty table
+    tracker_cell_table() = default;
+
+    //! Construct a table holding the supplied cells
+    /*
+     * \throw bad_cell_geometry_error if cells have different types or
+     * depths, are duplicated, or have addresses spanning too large a range to
+     * be densely indexed
+     */
+    explicit tracker_cell_table(std::vector<entry> cells);
+
+    //! Return the number of cells held
+    std::size_t
+    size() const
+    {
+      return cells_.size();
+    }
+
+    //! Return true if no cells are held
+    bool
+    empty() const
+    {
+      return cells_.empty();
+    }
+
+    //! Return the geom_id type of the cells held
+    std::uint32_t
+    type() const
+    {
+      return type_;
+    }
+
+    //! Return index of cell with packed geom_id key, or invalid_index
+    std::uint32_t
+    index(std::uint64_t key) const
+    {
+      std::size_t slot{0};
+      for (std::uint32_t i = 0; i < depth_; ++i) {
+        std::uint32_t const a = packed_address(key, i) - min_[i];
+        if (a >= extent_[i]) {
+          return invalid_index;
+        }
+        slot = slot * extent_[i] + a;
+      }
+      // An empty table has no slots, even for keys of its type and depth
+      return packed_type(key) == type_ && packed_depth(key) == depth_ &&
+                 !slot_index_.empty() ?
+               slot_index_[slot] :
+               invalid_index;
+    }
+
+    //! Return index of cell with geom_id, or invalid_index
+    std::uint32_t index(geomtools::geom_id const& gid) const;
+
+    //! Return one past the largest address at depth (< 4) of cells held
+    /*
+     * e.g. the number of layers of cells [module.side.layer.row] numbered
+     * from 0 is address_end(2)
+     */
+    std::uint32_t
+    address_end(std::uint32_t depth) const
+    {
+      return min_[depth] + extent_[depth];
+    }
+
+    //! Return geometry of the cell at index
+    cell const& operator[](std::uint32_t i) const { return cells_[i]; }
+
+    //! Return packed geom_id of the cell at index
+    std::uint64_t
+    gid(std::uint32_t i) const
+    {
+      return gids_[i];
+    }
+
+  private:
+    std::uint32_t type_{0};                 //< geom_id type of cells
+    std::uint32_t depth_{0};                //< geom_id depth of cells
+    std::uint32_t min_[4] = {0, 0, 0, 0};    //< lowest address at each depth
+    std::uint32_t extent_[4] = {0, 0, 0, 0}; //< address range at each depth
+    std::vector<std::uint32_t> slot_index_; //< address slot -> cell index
+    std::vector<cell> cells_;               //< geometry, by cell index
+    std::vector<std::uint64_t> gids_;       //< packed geom_id, by cell index
+  };
+
+  //! Build a table of all cells of a geometry category
+  /*
+   * \param geo initialized geometry manager
+   * \param category name of the cell category, e.g. "drift_cell_core"
+   * \throw bad_cell_geometry_error if no cells are found, or a cell's shape
+   * is not a box parallel to the world z axis
+   */
+  tracker_cell_table make_tracker_cell_table(geomtools::manager const& geo,
+                                             std::string const& category);
+} /* falaise */
+
+#endif /* FALAISE_TRACKER_CELL_TABLE_H */
@@ -0,0 +1,75 @@
+#include "tracker_layer_index.h"
+
+#include <algorithm>
+#include <numeric>
+#include <string>
+
+#include "bayeux/datatools/properties.h"
+
+#include "packed_geom_id.h"
+
+namespace falaise {
+  namespace {
+    std::string const offsets_key{"tracker_layer_offsets"};
+    std::string const layers_key{"tracker_layers"};
+  } // namespace
+
+  tracker_layer_index::tracker_layer_index(std::uint64_t const* gids,
+                                           std::size_t n,
+                                           std::uint32_t sides,
+                                           std::uint32_t layers)
+    : offsets_(sides * layers + 1, 0), layers_(layers)
+  {
+    // Count hits per layer, then offsets are their running sum
+    for (std::size_t i = 0; i < n; ++i) {
+      if (i > 0 && gids[i] < gids[i - 1]) {
+        throw bad_layer_index_error("tracker hits are not sorted by cell");
+      }
+      std::uint32_t const side = packed_address(gids[i], 1);
+      std::uint32_t const layer = packed_address(gids[i], 2);
+      if (side >= sides || layer >= layers) {
+        throw bad_layer_index_error("tracker hit outside indexed layers");
+      }
+      ++offsets_[side * layers + layer + 1];
+    }
+    std::partial_sum(offsets_.begin(), offsets_.end(), offsets_.begin());
+  }
+
+  tracker_layer_index::tracker_layer_index(std::vector<int> offsets,
+                                           std::uint32_t layers)
+    : offsets_(std::move(offsets)), layers_(layers)
+  {
+    if (layers_ == 0 || offsets_.empty() ||
+        (offsets_.size() - 1) % layers_ != 0) {
+      throw bad_layer_index_error("layer offsets do not cover whole sides");
+    }
+    if (offsets_.front() != 0 ||
+        !std::is_sorted(offsets_.begin(), offsets_.end())) {
+      throw bad_layer_index_error("layer offsets are not increasing from 0");
+    }
+  }
+
+  void
+  store_tracker_layer_index(datatools::properties& properties,
+                            tracker_layer_index const& index)
+  {
+    properties.store(offsets_key, index.offsets());
+    properties.store(layers_key, static_cast<int>(index.layers()));
+  }
+
+  tracker_layer_index
+  load_tracker_layer_index(datatools::properties const& properties)
+  {
+    if (!properties.has_key(offsets_key) || !properties.has_key(layers_key)) {
+      throw bad_layer_index_error("no tracker layer index");
+    }
+    std::vector<int> offsets;
+    properties.fetch(offsets_key, offsets);
+    int const layers = properties.fetch_integer(layers_key);
+    if (layers <= 0) {
+      throw bad_layer_index_error("layer offsets do not cover whole sides");
+    }
+    return tracker_layer_index{std::move(offsets),
+                               static_cast<std::uint32_t>(layers)};
+  }
+} /* falaise */
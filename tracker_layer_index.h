@@ -0,0 +1,136 @@
+#ifndef FALAISE_TRACKER_LAYER_INDEX_H
+#define FALAISE_TRACKER_LAYER_INDEX_H
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace datatools {
+  class properties;
+}
+
+namespace falaise {
+  //! Exception thrown when a layer index does not match its hits
+  class bad_layer_index_error : public std::logic_error {
+    using std::logic_error::logic_error;
+  };
+
+  //! Offsets of the layers in a collection of tracker hits sorted by cell
+  /*
+   * For hits sorted by packed geom_id of their cells [module.side.layer.row]
+   * of a single module, so by (side, layer, row), holds the offset of the
+   * first hit of each layer of each side. The hits of a layer are then a
+   * range found in O(1), and the hit in a cell is found by binary search
+   * of its layer's rows, rather than by scanning the collection.
+   *
+   * Offsets are held as int, so the index can travel with the hits it
+   * indexes in a datatools::properties, see store_tracker_layer_index().
+   */
+  class tracker_layer_index {
+  public:
+    //! Construct an index of no hits in no layers
+    tracker_layer_index() = default;
+
+    //! Index n hits in cells with packed geom_ids gids, sorted ascending
+    /*
+     * \throw bad_layer_index_error if gids are not sorted, or a cell is not
+     * in a side < sides or layer < layers
+     */
+    tracker_layer_index(std::uint64_t const* gids,
+                        std::size_t n,
+                        std::uint32_t sides,
+                        std::uint32_t layers);
+
+    //! Construct the index with offsets, as returned by offsets()
+    /*
+     * \throw bad_layer_index_error if offsets do not cover whole sides of
+     * layers or decrease
+     */
+    tracker_layer_index(std::vector<int> offsets, std::uint32_t layers);
+
+    //! Return the number of sides
+    std::uint32_t
+    sides() const
+    {
+      return layers_ > 0 ? (offsets_.size() - 1) / layers_ : 0;
+    }
+
+    //! Return the number of layers per side
+    std::uint32_t
+    layers() const
+    {
+      return layers_;
+    }
+
+    //! Return the number of hits indexed
+    std::size_t
+    size() const
+    {
+      return offsets_.empty() ? 0 : offsets_.back();
+    }
+
+    //! Return the offset of the first hit of each layer, then size()
+    std::vector<int> const&
+    offsets() const
+    {
+      return offsets_;
+    }
+
+    //! Return the range [first, last) of the hits in layer of side
+    std::pair<std::size_t, std::size_t>
+    layer(std::uint32_t side, std::uint32_t layer) const
+    {
+      std::size_t const l = side * layers_ + layer;
+      return {offsets_[l], offsets_[l + 1]};
+    }
+
+    //! Return the offset of the hit in cell (side, layer, row), or size()
+    /*
+     * row_of(i) must return the row of hit i
+     */
+    template <typename RowOf>
+    std::size_t
+    find(std::uint32_t side,
+         std::uint32_t layer,
+         std::uint32_t row,
+         RowOf&& row_of) const
+    {
+      auto range = this->layer(side, layer);
+      std::size_t first = range.first;
+      std::size_t count = range.second - range.first;
+      while (count > 0) {
+        std::size_t const half = count / 2;
+        if (row_of(first + half) < row) {
+          first += half + 1;
+          count -= half + 1;
+        }
+        else {
+          count = half;
+        }
+      }
+      return first < range.second && row_of(first) == row ? first : size();
+    }
+
+  private:
+    std::vector<int> offsets_; //< first hit of each side * layers_ + layer
+    std::uint32_t layers_{0};  //< layers per side
+  };
+
+  //! Store index in properties, which must not hold it already
+  /*
+   * Stored as "tracker_layer_offsets" and "tracker_layers"
+   */
+  void store_tracker_layer_index(datatools::properties& properties,
+                                 tracker_layer_index const& index);
+
+  //! Return the index stored in properties by store_tracker_layer_index
+  /*
+   * \throw bad_layer_index_error if properties hold no valid index
+   */
+  tracker_layer_index load_tracker_layer_index(
+    datatools::properties const& properties);
+} /* falaise */
+
+#endif /* FALAISE_TRACKER_LAYER_INDEX_H */
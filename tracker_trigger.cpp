@@ -0,0 +1,107 @@
+#include "tracker_trigger.h"
+
+#include <algorithm>
+
+#include "packed_geom_id.h"
+
+namespace falaise {
+  constexpr std::size_t tracker_trigger::max_conditions;
+  constexpr std::uint32_t tracker_trigger::max_layers;
+
+  tracker_trigger::tracker_trigger(std::uint32_t sides,
+                                   std::uint32_t layers,
+                                   std::uint32_t rows,
+                                   std::uint32_t zone_rows,
+                                   std::uint32_t zone_stride,
+                                   std::vector<condition> conditions)
+    : sides_(sides)
+    , layers_(layers)
+    , rows_(rows)
+    , zone_rows_(std::min(zone_rows, rows))
+    , zone_stride_(zone_stride)
+    , conditions_(std::move(conditions))
+  {
+    if (layers_ > max_layers) {
+      throw bad_trigger_error("trigger supports at most 16 layers");
+    }
+    if (conditions_.size() > max_conditions) {
+      throw bad_trigger_error("trigger supports at most 32 conditions");
+    }
+    if (zone_rows_ == 0 || zone_stride_ == 0) {
+      throw bad_trigger_error("trigger zones must have rows and a stride");
+    }
+    std::uint32_t const all = (1u << layers_) - 1;
+    for (auto const& c : conditions_) {
+      if (c.min_layers > layers_ || (c.required_layers & ~all) != 0 ||
+          c.sides > sides_) {
+        throw bad_trigger_error("trigger condition can never be met");
+      }
+    }
+
+    // Zones cover all rows, the last ending at the last row
+    zones_ = 1 + (rows_ - zone_rows_ + zone_stride_ - 1) / zone_stride_;
+    zone_.assign(sides_ * zones_, 0);
+    fired_.assign(sides_ * zones_, 0);
+
+    // Zones of each row, but for the last, which may not follow its stride
+    first_zone_.resize(rows_);
+    end_zone_.resize(rows_);
+    for (std::uint32_t row = 0; row < rows_; ++row) {
+      first_zone_[row] =
+        row < zone_rows_ ? 0 : (row - zone_rows_) / zone_stride_ + 1;
+      end_zone_[row] = std::min<std::size_t>(row / zone_stride_ + 1, zones_);
+    }
+  }
+
+  std::uint32_t
+  tracker_trigger::evaluate(std::uint64_t const* gids, std::size_t n)
+  {
+    // Events are a few tens of cells in a thousand, so set each cell's bit
+    // in the words of the zones holding its row rather than OR rows
+    std::fill(zone_.begin(), zone_.end(), 0);
+    std::size_t const last = zones_ - 1;
+    for (std::size_t i = 0; i < n; ++i) {
+      std::uint32_t const side = packed_address(gids[i], 1);
+      std::uint32_t const layer = packed_address(gids[i], 2);
+      std::uint32_t const row = packed_address(gids[i], 3);
+      if (side >= sides_ || layer >= layers_ || row >= rows_) {
+        continue;
+      }
+      std::uint16_t* zones = zone_.data() + side * zones_;
+      std::uint16_t const bit = 1u << layer;
+      for (std::size_t z = first_zone_[row]; z < end_zone_[row]; ++z) {
+        zones[z] |= bit;
+      }
+      if (row >= rows_ - zone_rows_) {
+        zones[last] |= bit;
+      }
+    }
+
+    // Count each zone's fired layers once for all conditions, whose tests
+    // on all zones of a side are then branchless, so vectorized in builds
+    // with the vectorizer on (see CMakeLists.txt)
+    for (std::size_t z = 0; z < zone_.size(); ++z) {
+      fired_[z] = __builtin_popcount(zone_[z]);
+    }
+    std::uint32_t met{0};
+    for (std::size_t c = 0; c < conditions_.size(); ++c) {
+      auto const& condition = conditions_[c];
+      std::uint32_t sidesMet{0};
+      for (std::uint32_t side = 0; side < sides_; ++side) {
+        std::uint16_t const* words = zone_.data() + side * zones_;
+        std::uint8_t const* fired = fired_.data() + side * zones_;
+        std::uint32_t any{0};
+        for (std::size_t z = 0; z < zones_; ++z) {
+          any |= (fired[z] >= condition.min_layers) &
+                 ((words[z] & condition.required_layers) ==
+                  condition.required_layers);
+        }
+        sidesMet += any;
+      }
+      if (sidesMet >= condition.sides) {
+        met |= 1u << c;
+      }
+    }
+    return met;
+  }
+} /* falaise */
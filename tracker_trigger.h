@@ -0,0 +1,92 @@
+#ifndef FALAISE_TRACKER_TRIGGER_H
+#define FALAISE_TRACKER_TRIGGER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+namespace falaise {
+  //! Exception thrown for an unusable trigger configuration
+  class bad_trigger_error : public std::logic_error {
+    using std::logic_error::logic_error;
+  };
+
+  //! Emulation of a tracker trigger on the fired cells of an event
+  /*
+   * Cells are addressed [module.side.layer.row], as packed geom_ids (see
+   * pack_geom_id). The rows of each side are grouped into zones of
+   * zone_rows rows starting every zone_stride rows, so overlapping if the
+   * stride is less than the width, the last zone ending at the last row.
+   * Each zone is an occupancy word, with bit l set if any of its cells in
+   * layer l fired.
+   *
+   * A condition is met by a zone whose word has at least min_layers bits
+   * set (a majority of layers) and all the bits of required_layers (a
+   * coincidence of layers), and by the event if at least sides of its
+   * sides have such a zone. Conditions are evaluated together on the zone
+   * words, each test being a popcount and a mask.
+   *
+   * Holds its working storage, so is not thread safe: use one per thread,
+   * e.g. from an object_pool.
+   */
+  class tracker_trigger {
+  public:
+    //! Requirement on the zones of an event
+    struct condition {
+      std::uint32_t min_layers;      //< fired layers, in one zone
+      std::uint32_t required_layers; //< mask of layers fired, in it too
+      std::uint32_t sides;           //< sides needing such a zone
+    };
+
+    //! Largest number of conditions, one bit each of evaluate()'s result
+    static constexpr std::size_t max_conditions = 32;
+
+    //! Largest number of layers, one bit each of an occupancy word
+    static constexpr std::uint32_t max_layers = 16;
+
+    //! Construct a trigger that is never met
+    tracker_trigger() = default;
+
+    //! Construct a trigger of conditions on sides x layers x rows cells
+    /*
+     * \throw bad_trigger_error if layers exceeds max_layers, conditions
+     * exceeds max_conditions, the zone width or stride is zero, or a
+     * condition can never be met
+     */
+    tracker_trigger(std::uint32_t sides,
+                    std::uint32_t layers,
+                    std::uint32_t rows,
+                    std::uint32_t zone_rows,
+                    std::uint32_t zone_stride,
+                    std::vector<condition> conditions);
+
+    //! Return the number of zones of each side
+    std::size_t
+    zones() const
+    {
+      return zones_;
+    }
+
+    //! Return the conditions met by cells gids[0, n), bit i for condition i
+    /*
+     * Cells outside the trigger's sides, layers and rows are ignored
+     */
+    std::uint32_t evaluate(std::uint64_t const* gids, std::size_t n);
+
+  private:
+    std::uint32_t sides_{0};
+    std::uint32_t layers_{0};
+    std::uint32_t rows_{0};
+    std::uint32_t zone_rows_{0};
+    std::uint32_t zone_stride_{0};
+    std::size_t zones_{0};
+    std::vector<condition> conditions_;
+    std::vector<std::uint32_t> first_zone_; //< first zone holding each row
+    std::vector<std::uint32_t> end_zone_;   //< ... and one past its last
+    std::vector<std::uint16_t> zone_;       //< zone words, by side then zone
+    std::vector<std::uint8_t> fired_;       //< ... and their bits set
+  };
+} /* falaise */
+
+#endif /* FALAISE_TRACKER_TRIGGER_H */